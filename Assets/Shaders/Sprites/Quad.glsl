@@ -0,0 +1,49 @@
+﻿// Instanced Quad Shader
+#type vertex
+#version 450 core
+#include <Buffers.glslh>
+
+// Per Instance: 2x3 affine transform, color, texture rectangle, texture slot and tiling
+layout(location = 0) in vec3 aTransformX;
+layout(location = 1) in vec3 aTransformY;
+layout(location = 2) in float aDepth;
+layout(location = 3) in vec4 aColor;
+layout(location = 4) in vec4 aTexRect;
+layout(location = 5) in float aTexIndex;
+layout(location = 6) in float aTilingFactor;
+
+layout(location = 0) out vec4 vColor;
+layout(location = 1) out vec2 vTexCoord;
+layout(location = 2) out float vTexIndex;
+layout(location = 3) out float vTilingFactor;
+
+const vec2 cCorners[4] = vec2[](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+
+void main() {
+	// The index buffer holds the corners (0-3) of a single quad
+	int corner = gl_VertexIndex & 3;
+	vec3 local = vec3(cCorners[corner], 1.0);
+	vec2 texCoord = cCorners[corner] + 0.5;
+
+	vColor = aColor;
+	vTexCoord = mix(aTexRect.xy, aTexRect.zw, texCoord);
+	vTexIndex = aTexIndex;
+	vTilingFactor = aTilingFactor;
+
+	gl_Position = uCamera.ViewProjection * vec4(dot(aTransformX, local), dot(aTransformY, local), aDepth, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) in vec4 vColor;
+layout(location = 1) in vec2 vTexCoord;
+layout(location = 2) in float vTexIndex;
+layout(location = 3) in float vTilingFactor;
+layout(location = 0) out vec4 oColor;
+
+layout(binding=0) uniform sampler2D uTextures[32];
+
+void main() {
+    oColor = texture(uTextures[int(vTexIndex)], vTexCoord * vTilingFactor) * vColor;
+}
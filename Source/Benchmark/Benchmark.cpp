@@ -0,0 +1,253 @@
+﻿import Ultra.Core;
+import Ultra.Core.Delegate;
+import Ultra.Core.Dispatcher;
+import Ultra.Core.Emitter;
+import Ultra.Core.Random;
+import Ultra.Core.Signal;
+import Ultra.Core.String;
+import Ultra.Core.ThreadPool;
+import Ultra.Debug.Benchmark;
+import Ultra.Logger;
+import Ultra.Logger.Binary;
+import Ultra.Math;
+import Ultra.Platform.Renderer.SWRasterizer;
+import Ultra.Renderer.PipelineState;
+import Ultra.Renderer.RenderDevice;
+import Ultra.System.FileSystem;
+
+///
+/// @brief Micro benchmarks for the core utilities, the results are written as JSON and can be compared against a previous run.
+/// Usage: Benchmark [--filter <text>] [--baseline <file>] [--output <file>] [--threshold <ratio>] [--warmup <count>] [--repetitions <count>]
+/// @note The exit code is 2, if at least one benchmark regressed against the baseline.
+///
+
+namespace Ultra::Benchmark {
+
+struct KeyboardEvent {
+    int KeyCode = 0;
+};
+
+struct Listener {
+    void OnKeyboardEvent(const KeyboardEvent &data) { Sum += data.KeyCode; }
+    int Sum = 0;
+};
+
+struct EventEmitter: Emitter<EventEmitter> {};
+
+int Twice(int value) {
+    return value * 2;
+}
+
+void Register(Debug::BenchmarkSuite &suite) {
+    // Logger
+    suite.Add("Logger::Memory", 1'000, [] {
+        logger(LoggerType::Memory, "Message {} of {}\n", 42, "Benchmark");
+    });
+    suite.Add("Logger::Filtered", 10'000, [] {
+        LogTrace("Message {} of {}\n", 42, "Benchmark");
+    });
+    suite.Add("BinaryLogger::Write", 10'000, [] {
+        blog(LogLevel::Info, "Message {} of {} took {:.3f} ms\n", 42, "Benchmark", 0.125f);
+    });
+
+    // Delegate, Dispatcher, Emitter and Signal
+    suite.Add("Delegate::Invoke", 100'000, [] {
+        static auto delegate = [] {
+            Delegate<int(int)> result {};
+            result.connect<&Twice>();
+            return result;
+        }();
+        Debug::DoNotOptimize(delegate(21));
+    });
+    suite.Add("Dispatcher::Trigger", 100'000, [] {
+        static Listener listener;
+        static auto dispatcher = [] {
+            auto result = CreateScope<Dispatcher>();
+            result->sink<KeyboardEvent>().connect<&Listener::OnKeyboardEvent>(listener);
+            return result;
+        }();
+        dispatcher->trigger(KeyboardEvent { 1 });
+    });
+    suite.Add("Dispatcher::EnqueueUpdate", 10'000, [] {
+        static Listener listener;
+        static auto dispatcher = [] {
+            auto result = CreateScope<Dispatcher>();
+            result->sink<KeyboardEvent>().connect<&Listener::OnKeyboardEvent>(listener);
+            return result;
+        }();
+        dispatcher->enqueue<KeyboardEvent>(1);
+        dispatcher->update<KeyboardEvent>();
+    });
+    suite.Add("Emitter::Publish", 100'000, [] {
+        static int sum = 0;
+        static auto emitter = [] {
+            auto result = CreateScope<EventEmitter>();
+            result->on<KeyboardEvent>([](const KeyboardEvent &data, EventEmitter &) { sum += data.KeyCode; });
+            return result;
+        }();
+        emitter->publish(KeyboardEvent { 1 });
+    });
+    suite.Add("Signal::Publish", 100'000, [] {
+        static Listener listener;
+        static auto signal = [] {
+            auto result = CreateScope<Signal<void(const KeyboardEvent &)>>();
+            Sink sink { *result };
+            sink.connect<&Listener::OnKeyboardEvent>(listener);
+            return result;
+        }();
+        signal->publish(KeyboardEvent { 1 });
+    });
+
+    // ThreadPool
+    suite.Add("ThreadPool::Enqueue", 1'000, [] {
+        static ThreadPool pool;
+        pool.Enqueue([] {}).wait();
+    });
+
+    // String
+    suite.Add("String::Split", 10'000, [] {
+        Debug::DoNotOptimize(String::Split("alpha,beta,gamma,delta,epsilon", ','));
+    });
+    suite.Add("String::Replace", 10'000, [] {
+        string value = "The quick brown fox jumps over the lazy dog";
+        Debug::DoNotOptimize(String::Replace(value, "fox", "cat"));
+    });
+    suite.Add("String::ToLower", 10'000, [] {
+        string value = "The Quick Brown Fox Jumps Over The Lazy Dog";
+        Debug::DoNotOptimize(String::ToLower(value));
+    });
+
+    // Random and UUID
+    suite.Add("Random::Float", 100'000, [] {
+        Debug::DoNotOptimize(Random::Float());
+    });
+    suite.Add("UUID<uint64_t>", 100'000, [] {
+        Debug::DoNotOptimize(static_cast<uint64_t>(UUID<uint64_t>()));
+    });
+    suite.Add("UUID<string>", 10'000, [] {
+        Debug::DoNotOptimize(static_cast<string>(UUID()));
+    });
+
+    // Math
+    suite.Add("Vector3::CrossNormalize", 100'000, [] {
+        static Vector3 a { 1.0f, 2.0f, 3.0f };
+        static Vector3 b { 4.0f, 5.0f, 6.0f };
+        auto result = a.Cross(b).Normalize();
+        Debug::DoNotOptimize(result.Dot(a));
+    });
+    suite.Add("Matrix4::Multiply", 100'000, [] {
+        static Matrix4 a = Matrix4::Identity();
+        static Matrix4 b = Matrix4::Identity() * 2.0f;
+        auto result = a * b;
+        Debug::DoNotOptimize(result.Data[3][3]);
+    });
+
+    // File and Directory
+    static const auto root = (std::filesystem::temp_directory_path() / "UltraBenchmark").string();
+    std::filesystem::create_directories(root);
+    for (size_t i = 0; i < 16; i++) {
+        File::Write(std::format("{}/File{}.txt", root, i), string(4096, 'x'));
+    }
+    suite.Add("File::LoadAsString", 1'000, [] {
+        Debug::DoNotOptimize(File::LoadAsString(root + "/File0.txt"));
+    });
+    suite.Add("Directory::GetFiles", 100, [] {
+        Debug::DoNotOptimize(Directory::GetFiles(root, ".txt"));
+    });
+
+    // Software Rasterizer
+    struct Vertex { glm::vec3 Position; glm::vec4 Color; };
+    static vector<Vertex> quads;
+    static vector<uint32_t> indices;
+    for (uint32_t i = 0; i < 1'000; i++) {
+        // Overlapping grid of blended quads, the layout is fixed so that runs are comparable
+        auto x = -1.0f + (i % 40) * 0.045f;
+        auto y = -1.0f + (i / 40) * 0.07f;
+        auto color = glm::vec4((i % 7) / 7.0f, (i % 5) / 5.0f, (i % 3) / 3.0f, 0.5f);
+        auto first = static_cast<uint32_t>(quads.size());
+        quads.push_back({ { x, y + 0.1f, 0.0f }, color });
+        quads.push_back({ { x + 0.1f, y + 0.1f, 0.0f }, color });
+        quads.push_back({ { x + 0.1f, y, 0.0f }, color });
+        quads.push_back({ { x, y, 0.0f }, color });
+        indices.insert(indices.end(), { first, first + 1, first + 2, first + 2, first + 3, first });
+    }
+    static PipelineProperties pipeline = [] {
+        PipelineProperties result {};
+        result.BlendMode = BlendMode::Alpha;
+        result.Layout = {
+            { ShaderDataType::Float3, "aPosition" },
+            { ShaderDataType::Float4, "aColor" },
+        };
+        return result;
+    }();
+    static auto format = SWVertexFormat::Create(pipeline.Layout);
+    suite.Add("SWRasterizer::Quads", 10, [] {
+        auto &rasterizer = SWRasterizer::Instance();
+        rasterizer.Resize(1280, 720);
+        rasterizer.BindPipeline(&pipeline, &format);
+        rasterizer.BindProgram({});
+        rasterizer.BindVertexBuffer(reinterpret_cast<const byte *>(quads.data()), quads.size() * sizeof(Vertex));
+        rasterizer.BindIndexBuffer(indices.data(), indices.size() * sizeof(uint32_t));
+        rasterizer.Clear({ 0.0f, 0.0f, 0.0f, 1.0f });
+        rasterizer.DrawIndexed(PrimitiveType::Triangle, indices.size());
+        rasterizer.Flush();
+        Debug::DoNotOptimize(rasterizer.GetDefaultTarget().Color->Texels[0]);
+    });
+}
+
+}
+
+int main(int argc, char **argv) {
+    using namespace Ultra;
+
+    string baseline {};
+    string filter {};
+    string output = "Benchmark.json";
+    double threshold = 0.1;
+    size_t warmup = 3;
+    size_t repetitions = 15;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string_view option = argv[i];
+        string_view value = argv[i + 1];
+        if (option == "--baseline") {
+            baseline = value;
+        } else if (option == "--filter") {
+            filter = value;
+        } else if (option == "--output") {
+            output = value;
+        } else if (option == "--threshold") {
+            threshold = std::stod(string(value));
+        } else if (option == "--warmup") {
+            warmup = std::stoull(string(value));
+        } else if (option == "--repetitions") {
+            repetitions = std::stoull(string(value));
+        } else {
+            std::println(std::cerr, "Benchmark: Unknown option '{}'!", option);
+            return 1;
+        }
+    }
+
+    // Trace messages are filtered, so that 'Logger::Filtered' measures the early out
+    logger.SetLevel(LogLevel::Info);
+    logger.Attach(CreateScope<ConsoleLogger>());
+    logger.Attach(CreateScope<MemoryLogger>());
+    blog.Open((std::filesystem::temp_directory_path() / "Benchmark.ulog").string());
+    Random::Load();
+
+    Debug::BenchmarkSuite suite("Core", warmup, repetitions);
+    suite.SetThreshold(threshold);
+    Benchmark::Register(suite);
+    if (!baseline.empty()) suite.LoadBaseline(baseline);
+
+    LogCaption("Benchmark");
+    suite.Run(filter);
+    blog.Close();
+
+    if (!suite.Save(output)) return 1;
+    if (auto regressions = suite.GetRegressions()) {
+        LogError("Benchmark: {} regression(s) against '{}'!", regressions, baseline);
+        return 2;
+    }
+    return 0;
+}
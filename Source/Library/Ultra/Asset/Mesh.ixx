@@ -3,6 +3,7 @@
 import Ultra.Core;
 import Ultra.Logger;
 import Ultra.Math;
+export import Ultra.Math.Bounds;
 export import Ultra.Asset.Material;
 export import Ultra.Renderer.CommandBuffer;
 export import Ultra.Renderer.PipelineState;
@@ -41,16 +42,36 @@ public:
         mTextures(textures),
         mTextureData(info),
         mMaterialData(material) {
+        for (const auto &vertex : mVertices) mBoundingBox.Extend(vertex.Position);
+        mBoundingSphere = BoundingSphere::Create(mBoundingBox, mVertices, [](const Vertex &vertex) { return vertex.Position; });
         SetupMesh();
     }
     ~Mesh() = default;
 
+    ///
+    /// @brief Binds and draws the mesh, the state stays bound, so that following meshes with the same pipeline only swap their buffers and textures.
+    ///
     void Draw(CommandBuffer *commandBuffer);
+    void Unbind();
     uint32_t GetIndices() const { return static_cast<uint32_t>(mIndices.size()); }
 
     MaterialData GetMaterial() const { return mMaterialData; }
+    const BoundingBox &GetBoundingBox() const { return mBoundingBox; }
+    const BoundingSphere &GetBoundingSphere() const { return mBoundingSphere; }
+
+    // Diffuse, normal and specular map
+    static constexpr uint32_t TextureSlots = 3;
 
 private:
+    ///
+    /// @brief Opaque black, which is what an empty slot samples, so the slots behave as if they were unbound.
+    ///
+    static const Reference<Texture> &GetFallbackTexture() {
+        static const uint32_t black = 0xff000000;
+        static Reference<Texture> texture = Texture::Create(TextureProperties(), &black, sizeof(uint32_t));
+        return texture;
+    }
+
     void SetupMesh() {
         PipelineProperties properties;
         properties.BlendMode = BlendMode::Alpha;
@@ -66,7 +87,8 @@ private:
             //{ ShaderDataType::Int4,   "aBoneIDs"   },
             //{ ShaderDataType::Float4, "aWeights"   },
         };
-        mPipeline = PipelineState::Create(properties);
+        // All meshes share the same properties, so they share one pipeline as well
+        mPipeline = PipelineState::Acquire(properties);
 
         mVertexBuffer = Buffer::Create(BufferType::Vertex, mVertices.data(), sizeof_vector(mVertices));
         mIndexBuffer = Buffer::Create(BufferType::Index, mIndices.data(), sizeof_vector(mIndices));
@@ -82,6 +104,9 @@ private:
     TextureInfo mTextureData;
     MaterialData mMaterialData;
 
+    BoundingBox mBoundingBox;
+    BoundingSphere mBoundingSphere;
+
     Reference<Buffer> mVertexBuffer;
     Reference<Buffer> mIndexBuffer;
     Reference<Buffer> mMaterialBuffer;
@@ -98,20 +123,21 @@ void Mesh::Draw(CommandBuffer *commandBuffer) {
     mPipeline->Bind();
     mIndexBuffer->Bind();
 
-    for (size_t i = 0; i < mTextures.size(); i++) {
-        if (i >= 3) break;
-        mTextures[i]->Bind(static_cast<uint32_t>(i));
-    }
-    if (!mTextures.size()) {
-        mMaterialBuffer->Bind(9);
-        mMaterialBuffer->UpdateData(&mMaterialData, sizeof(MaterialData));
+    // Slots without a texture get the fallback, otherwise they would sample the maps of the previously drawn mesh
+    for (uint32_t i = 0; i < TextureSlots; i++) {
+        const auto &texture = i < mTextures.size() ? mTextures[i] : GetFallbackTexture();
+        texture->Bind(i);
     }
+    // The material doesn't change after loading, so the buffer is only bound (a per-draw upload would force the driver to synchronize)
+    if (!mTextures.size()) mMaterialBuffer->Bind(9);
     commandBuffer->DrawIndexed(mIndices.size(), PrimitiveType::Triangle, true);
+}
+
+void Mesh::Unbind() {
     mPipeline->Unbind();
 
-    for (size_t i = 0; i < mTextures.size(); i++) {
-        if (i >= 3) break;
-        mTextures[i]->Unbind(static_cast<uint32_t>(i));
+    for (uint32_t i = 0; i < TextureSlots; i++) {
+        GetFallbackTexture()->Unbind(i);
     }
 }
 }
@@ -4,6 +4,7 @@ import Ultra.Core;
 import Ultra.Logger;
 import Ultra.Math;
 import Ultra.Asset.Mesh;
+import Ultra.Renderer.RenderDevice;
 import Ultra.Renderer.Texture;
 import Ultra.System.FileSystem;
 
@@ -27,8 +28,39 @@ public:
         for (auto &mesh: mMeshes) {
             mesh.Draw(commandBuffer);
         }
+        if (!mMeshes.empty()) mMeshes.back().Unbind();
     }
 
+    ///
+    /// @brief Draws only the meshes, which intersect the view frustum, the planes are moved into model space, so the bounds stay untouched.
+    ///
+    void Draw(CommandBuffer *commandBuffer, const glm::mat4 &viewProjection, const glm::mat4 &transform = glm::mat4(1.0f)) {
+        auto &statistics = RenderDevice::GetStatistics();
+        Frustum frustum(viewProjection * transform);
+        if (!frustum.Intersects(mBoundingSphere) || !frustum.Intersects(mBoundingBox)) {
+            statistics.CulledMeshes += static_cast<uint32_t>(mMeshes.size());
+            return;
+        }
+
+        // The spheres reject most meshes in one batch, the boxes refine the rest (long and flat meshes)
+        frustum.Cull(mMeshSpheres, mVisibility);
+        Mesh *last = nullptr;
+        for (size_t i = 0; i < mMeshes.size(); i++) {
+            if (!mVisibility[i] || !frustum.Intersects(mMeshes[i].GetBoundingBox())) {
+                statistics.CulledMeshes++;
+                continue;
+            }
+            statistics.VisibleMeshes++;
+            last = &mMeshes[i];
+            last->Draw(commandBuffer);
+        }
+        if (last) last->Unbind();
+    }
+
+    // Accessors
+    const BoundingBox &GetBoundingBox() const { return mBoundingBox; }
+    const BoundingSphere &GetBoundingSphere() const { return mBoundingSphere; }
+
 private:
     void Load(const string &path) {
         //Assimp::DefaultLogger::create("", Assimp::Logger::VERBOSE);
@@ -44,6 +76,17 @@ private:
         mDirectory = File::GetPath(path);
         ProcessNode(scene->mRootNode, scene);
 
+        // Bounds
+        for (const auto &mesh : mMeshes) {
+            mBoundingBox.Extend(mesh.GetBoundingBox());
+            mMeshSpheres.push_back(mesh.GetBoundingSphere());
+        }
+        mBoundingSphere = BoundingSphere::Create(mBoundingBox, mMeshSpheres, [&](const BoundingSphere &sphere) {
+            // The farthest point of a sphere lies on the line from the model center through its center
+            auto delta = sphere.Center - mBoundingBox.GetCenter();
+            auto length = glm::length(delta);
+            return length > 0.0f ? sphere.Center + delta / length * sphere.Radius : sphere.Center + glm::vec3(sphere.Radius, 0.0f, 0.0f);
+        });
 
         //Assimp::DefaultLogger::kill();
     }
@@ -203,6 +246,11 @@ private:
     Meshes mMeshes;
     bool mGammaCorrection;
 
+    BoundingBox mBoundingBox;
+    BoundingSphere mBoundingSphere;
+    vector<BoundingSphere> mMeshSpheres;
+    vector<uint8_t> mVisibility;
+
     TextureInfo mTexturesLoaded {};
     Textures mTextures {};
 };
@@ -1,8 +1,15 @@
 ﻿export module Ultra.Core.Application;
 
 import Ultra.Core;
+import Ultra.Core.Allocator;
 import Ultra.Core.DateTime;
+import Ultra.Core.Future;
+import Ultra.Core.JobSystem;
 import Ultra.Core.Layer;
+import Ultra.Core.TaskGraph;
+import Ultra.Debug.Benchmark;
+import Ultra.Debug.Memory;
+import Ultra.Debug.Profiler;
 //import Ultra.Config;
 import Ultra.Logger;
 import Ultra.Core.Timer;
@@ -16,6 +23,14 @@ int main(int, char **);
 
 export namespace Ultra {
 
+// A non-zero frame count runs the application headless (without window and context) for a measured number of frames.
+struct BenchmarkProperties {
+    string Output = "Benchmark.json";
+    uint32_t Frames = 0;
+    uint32_t Warmup = 60;
+    double DeltaTime = 1000.0 / 60.0;   // Fixed frame time in ms
+};
+
 // The title, resolution and graphics API can be passed as structure.
 struct ApplicationProperties {
     ApplicationProperties(): Title("Ultra"), Resolution("800x600") { CalculateResolution(); }
@@ -33,6 +48,14 @@ struct ApplicationProperties {
     uint32_t Height;
     bool External = false;
 
+    // Pacing
+    uint32_t FrameLimit = 0;            // Frames per second, 0 = unlimited
+    uint32_t SimulationRate = 0;        // Fixed updates per second, 0 = variable delta only
+    uint32_t MaxSimulationSteps = 5;    // Upper bound of catch-up steps per frame
+
+    // Measurement
+    BenchmarkProperties Benchmark;
+
 private:
     void CalculateResolution() {
         std::string delimiter = "x";
@@ -63,11 +86,12 @@ class Application {
 
     // Types
     struct Statistics {
-        std::queue<float> fpsData;
-        std::queue<float> msPFData;
-
         double fps = {};
         double msPF = {};
+        double criticalPath = {};
+
+        uint32_t simulationSteps = {};
+        uint64_t droppedSteps = {};
     };
 
 public:
@@ -83,12 +107,22 @@ public:
         logger.Attach(CreateScope<ConsoleLogger>());
         logger.Attach(CreateScope<FileLogger>("Test.log"));
         logger.Attach(CreateScope<MemoryLogger>());
+        JobSystem::Instance(); // The main thread has to be registered as first participant
 
         LogCaption("{}", AsciiLogo());
         Log("{} started ...\n  on: '{}'\n  at: '{}'", mProperties.Title, apptime.GetDate(), apptime.GetTime());
 
         // Initialization
-        if (mProperties.External) return;
+        if (mProperties.Benchmark.Frames) {
+            // Benchmarks always use the software backend, it renders headless, so they include the rendering without needing a window or GPU
+            if (mProperties.GfxApi != GraphicsAPI::Software) LogDebug("The benchmark uses the software renderer instead of the configured graphics API.");
+            mProperties.GfxApi = GraphicsAPI::Software;
+            Context::API = mProperties.GfxApi;
+            mContext = Context::Create(nullptr);
+            mContext->Load();
+            mContext->SetViewport(mProperties.Width, mProperties.Height);
+        }
+        if (mProperties.External || mProperties.Benchmark.Frames) return;
         LogCaption("Initialization");
 
         // Load Configuration
@@ -124,6 +158,10 @@ public:
 
     // With this method, everything begins.
     void Run() {
+        if (mProperties.Benchmark.Frames) {
+            RunBenchmark();
+            return;
+        }
         if (mProperties.External) {
             RunExternal();
             return;
@@ -134,16 +172,22 @@ public:
         double delay = {};
         double frames = {};
         string title(64, ' ');
+        mFrameLimiter.SetLimit(mProperties.FrameLimit);
 
         // Creation
         Create();
         for (Layer *layer : mLayers) layer->Create();
+        BuildFrameGraph();
 
         // Logic Loop
         LogCaption("Main Loop");
         while (mRunning) {
-            // Update events and check if application is paused
-            if (mPaused) continue;
+            // Update events and check if application is paused, the loop sleeps until the platform delivers new events
+            if (mPaused) {
+                mListener->Wait();
+                timer.GetDeltaTime();
+                continue;
+            }
             if (mReloaded) {
                 mReloaded = false;
                 continue;
@@ -167,9 +211,9 @@ public:
 
             // Update
             mContext->Attach();
-            for (Layer *layer : mLayers) layer->Update(deltaTime);
-            Update(deltaTime);
+            Step(deltaTime);
             if (mWindow->GetState(WindowState::Alive)) {
+                auto scope = Debug::ProfileScope("Application::GuiUpdate");
                 mListener->Update();
                 pCoreLayer->Prepare();
                 for (Layer *layer : mLayers) layer->GuiUpdate();
@@ -177,6 +221,7 @@ public:
             }
             mContext->SwapBuffers();
             mContext->Detach();
+            mFrameLimiter.Wait();
         }
 
         // Termination
@@ -189,13 +234,19 @@ public:
         Timer timer = {};
         double delay = {};
         double frames = {};
+        mFrameLimiter.SetLimit(mProperties.FrameLimit);
 
         // Creation
         Create();
 
         while (mRunning) {
-            // Update events and check if application is paused
-            if (mPaused) continue;
+            // Check if application is paused, without an event listener the loop sleeps until it gets resumed
+            if (mPaused) {
+                std::unique_lock<mutex> lock(mPauseMutex);
+                mPauseCondition.wait(lock, [this] { return !mPaused || !mRunning; });
+                timer.GetDeltaTime();
+                continue;
+            }
             if (mReloaded) {
                 mReloaded = false;
                 continue;
@@ -215,18 +266,51 @@ public:
             }
 
             // Update
-            Update(deltaTime);
+            Step(deltaTime);
+            mFrameLimiter.Wait();
+        }
+
+        // Termination
+        Destroy();
+    }
+    // Runs the configured number of frames with a fixed delta time and without window (on the software backend), the results are written as JSON.
+    void RunBenchmark() {
+        const auto &properties = mProperties.Benchmark;
+        const Timestamp deltaTime = properties.DeltaTime;
+        Debug::FrameBenchmark benchmark(mProperties.Title, properties.Frames, properties.Warmup);
+
+        // Creation
+        Create();
+        for (Layer *layer : mLayers) layer->Create();
+        BuildFrameGraph();
+
+        LogCaption("Benchmark");
+        while (mRunning && !benchmark.IsFinished()) {
+            benchmark.BeginFrame();
+            Step(deltaTime);
+            if (mContext) mContext->SwapBuffers();
+            benchmark.EndFrame();
         }
 
         // Termination
+        for (Layer *layer : mLayers) layer->Destroy();
         Destroy();
+
+        auto statistics = benchmark.GetStatistics();
+        Log("Benchmark [{} frames]: p50 {:.3f}ms | p95 {:.3f}ms | p99 {:.3f}ms | max {:.3f}ms",
+            statistics.Samples, statistics.Median, statistics.P95, statistics.P99, statistics.Max);
+        benchmark.Save(properties.Output, properties.DeltaTime);
     }
 
     // Accessors
+    static const Arguments &GetArguments() { return sArguments; }
     static ApplicationProperties &GetProperties() { return Instance().mProperties; }
     //static Config &GetConfig() { return *Instance().mConfig; }
     static Context &GetContext() { return *Instance().mContext; }
     static Dialog &GetDialog() { return *Instance().mDialog; };
+    static const TaskGraph &GetFrameGraph() { return Instance().mFrameGraph; }
+    // Retrieve how far the current frame lies between the last and the next fixed update [0, 1), used to interpolate the rendered state.
+    static float GetInterpolationAlpha() { return Instance().mInterpolationAlpha; }
     static Statistics GetStatistics() { return Instance().mStatistics; }
     static Window &GetWindow() { return *Instance().mWindow.get(); };
 
@@ -239,12 +323,30 @@ public:
     virtual void Destroy() {}
     // This method executes your main logic code.
     virtual void Update([[maybe_unused]] Timestamp deltaTime) {}
+    // This method executes your simulation code with a constant step, if a simulation rate is set.
+    virtual void FixedUpdate([[maybe_unused]] Timestamp step) {}
     // Add an Ascii-Art Logo to logging headers.
     virtual string AsciiLogo() { return mProperties.Title; };
 
     // With this method, everything ends.
     void Exit() {
         mRunning = false;
+        Resume();
+    }
+
+    // This method suspends the main loop until the application gets resumed.
+    void Pause() {
+        mPaused = true;
+    }
+
+    // This method continues a paused main loop, it can be called from any thread.
+    void Resume() {
+        {
+            std::lock_guard<mutex> lock(mPauseMutex);
+            mPaused = false;
+        }
+        mPauseCondition.notify_all();
+        if (mListener) mListener->Wake();
     }
 
     // This method pushes a layer to the application.
@@ -257,6 +359,16 @@ public:
         mLayers.PushOverlay(overlay);
     }
 
+    // This method removes a layer from the application, the caller takes over its ownership.
+    void PopLayer(Layer *layer) {
+        mLayers.PopLayer(layer);
+    }
+
+    // This method removes an overlay from the application, the caller takes over its ownership.
+    void PopOverlay(Layer *overlay) {
+        mLayers.PopOverlay(overlay);
+    }
+
 protected:
     // Attention: This method is used reload/switch the graphics context.
     static void Reload() {
@@ -320,6 +432,17 @@ protected:
                 break;
             }
 
+            case WindowAction::Minimize: {
+                Pause();
+                break;
+            }
+
+            case WindowAction::Maximize:
+            case WindowAction::Restore: {
+                Resume();
+                break;
+            }
+
             case WindowAction::Resize: {
                 mContext->SetViewport(mWindow->GetContextSize().Width, mWindow->GetContextSize().Height);
                 break;
@@ -345,15 +468,75 @@ protected:
         }
     }
 
-    // This method sets the arguments passed during startup.
-    void SetArguments(const Arguments &arguments) {
-        mArguments = arguments;
+    // This method collects the per-frame work of all layers into the frame graph.
+    void BuildFrameGraph() {
+        mFrameGraph.Clear();
+        for (Layer *layer : mLayers) layer->Schedule(mFrameGraph);
+        mFrameGraph.Compile();
+        mFrameGraphRevision = mLayers.GetRevision();
+        mFrameGraphDirty = false;
+    }
+
+    // This method advances the simulation in fixed steps by the elapsed frame time.
+    void Simulate(Timestamp deltaTime) {
+        if (!mProperties.SimulationRate) {
+            mInterpolationAlpha = 1.0f;
+            return;
+        }
+        auto scope = Debug::ProfileScope("Application::FixedUpdate");
+
+        const double step = 1000.0 / mProperties.SimulationRate;
+        uint32_t steps = 0;
+        mAccumulator += deltaTime.GetMilliseconds();
+        while (mAccumulator >= step && steps < mProperties.MaxSimulationSteps) {
+            FixedUpdate(step);
+            for (Layer *layer : mLayers) layer->FixedUpdate(step);
+            mAccumulator -= step;
+            steps++;
+        }
+
+        // After a hitch the remaining backlog is dropped, so the simulation slows down instead of spiraling into ever longer frames.
+        if (mAccumulator >= step) {
+            auto dropped = static_cast<uint64_t>(mAccumulator / step);
+            mStatistics.droppedSteps += dropped;
+            mAccumulator -= dropped * step;
+        }
+        mStatistics.simulationSteps = steps;
+        mInterpolationAlpha = static_cast<float>(mAccumulator / step);
+    }
+
+    // This method executes the per-frame work, which doesn't depend on a window or context.
+    void Step(Timestamp deltaTime) {
+        FrameAllocator::Instance().NextFrame();
+        Debug::NextMemoryFrame();
+        Debug::ProfileFrame();
+        {
+            auto scope = Debug::ProfileScope("Application::Completions");
+            CompletionQueue::Instance().Drain();
+        }
+        Simulate(deltaTime);
+        // The nodes capture their layers, so every change of the layer stack requires a rebuild
+        if (mFrameGraphDirty || mFrameGraphRevision != mLayers.GetRevision()) BuildFrameGraph();
+        {
+            auto scope = Debug::ProfileScope("Application::FrameGraph");
+            mFrameGraph.Execute(deltaTime);
+            mStatistics.criticalPath = mFrameGraph.GetStatistics().CriticalPath;
+        }
+        {
+            auto scope = Debug::ProfileScope("Application::Update");
+            Update(deltaTime);
+        }
+    }
+
+    // This method sets the arguments passed during startup, the entry point does it before the application is created.
+    static void SetArguments(const Arguments &arguments) {
+        sArguments = arguments;
     }
 
 private:
     // Properties
     ApplicationProperties mProperties;
-    Arguments mArguments;
+    inline static Arguments sArguments;
     Statistics mStatistics;
 
     // Objects
@@ -364,11 +547,19 @@ private:
     Reference<Dialog> mDialog;
     Scope<EventListener> mListener;
     Scope<Window> mWindow;
+    TaskGraph mFrameGraph;
+    FrameLimiter mFrameLimiter;
+    double mAccumulator = {};
+    float mInterpolationAlpha = 1.0f;
 
     // States
-    bool mPaused = false;
+    bool mFrameGraphDirty = true;
+    uint32_t mFrameGraphRevision = 0;
+    atomic<bool> mPaused = false;
+    mutex mPauseMutex;
+    condition_variable mPauseCondition;
     bool mReloaded = false;
-    bool mRunning = false;
+    atomic<bool> mRunning = false;
 };
 
 // Application Instance
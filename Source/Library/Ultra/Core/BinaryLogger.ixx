@@ -0,0 +1,481 @@
+﻿export module Ultra.Logger.Binary;
+
+// Library
+import Ultra.Core;
+import Ultra.Logger;
+
+///
+/// @brief Binary log channel with deferred formatting.
+/// Every call site is registered once (format, level, file, line) and gets an ID, a log call only serializes that ID,
+/// the raw clock ticks and the raw argument bytes. The text is created offline by the BinaryLogReader (see 'LogDecoder').
+///
+/// @example
+/// blog.Open("Test.ulog");
+/// blog(LogLevel::Info, "Frame {} took {:.3f} ms", frame, duration);
+/// blog.Close();
+///
+/// File Layout:
+/// Header: "ULOG" [u8 version]
+/// Site:   [u8 tag] [varint id] [u8 level] [varint line] [string format] [string file] [string class]
+/// Chunk:  [u8 tag] [varint thread] [varint size] { [varint site] [zigzag tick delta] [u8 count] { [u8 type] [payload] }* }*
+/// The ticks are stored relative to the previous message of the same chunk.
+///
+export namespace Ultra {
+
+///
+/// Common
+///
+
+enum class BinaryLogTag: uint8_t {
+    Site    = 0x1,
+    Chunk   = 0x2,
+};
+
+enum class BinaryLogType: uint8_t {
+    Bool    = 0x0,
+    Char    = 0x1,
+    Int     = 0x2,  // zigzag varint
+    UInt    = 0x3,  // varint
+    Float   = 0x4,
+    Double  = 0x5,
+    String  = 0x6,  // varint length + bytes
+    Pointer = 0x7,
+};
+
+///
+/// @brief Call site, which is created implicitly from the format string at the call site.
+///
+struct BinaryLogSite {
+    const char *Format;
+    mutable LogLevel Level;
+    SourceLocation Location;
+
+    BinaryLogSite(const char *format, const LogLevel &level = LogLevel::Default, const SourceLocation &location = SourceLocation::Current()):
+        Format(format),
+        Level(level),
+        Location(location) {
+    }
+};
+
+///
+/// @brief Binary Logger
+///
+class BinaryLogger: public SteadyObject {
+    // Types
+    struct SiteKey {
+        const void *Format;
+        const void *File;
+        uint32_t Line;
+        uint32_t Column;
+
+        bool operator==(const SiteKey &) const = default;
+    };
+    struct SiteKeyHasher {
+        size_t operator()(const SiteKey &key) const {
+            auto hash = std::hash<const void *>{}(key.Format) ^ (std::hash<const void *>{}(key.File) << 1);
+            return hash ^ (static_cast<size_t>(key.Line) << 16) ^ key.Column;
+        }
+    };
+    struct ThreadBuffer {
+        mutex Mutex;
+        uint32_t Thread {};
+        int64_t Ticks {};
+        vector<uint8_t> Data;
+    };
+
+    // Constructors and Deconstructor
+    BinaryLogger() = default;
+    virtual ~BinaryLogger() { Close(); }
+
+public:
+    // Limits
+    static constexpr uint8_t Version = 1;
+    static constexpr size_t ChunkSize = 64 * 1024;
+
+    // Get the global instance to the binary logger
+    static BinaryLogger &Instance() {
+        static BinaryLogger instance;
+        return instance;
+    }
+
+    // Methods
+    bool Open(const string &file) {
+        Close();
+        std::lock_guard<mutex> lock(mFileMutex);
+        mStream.open(file, std::ios::binary | std::ios::trunc);
+        if (!mStream.is_open()) {
+            LogError("BinaryLogger couldn't open target file '{}'!", file);
+            return false;
+        }
+        mStream.write("ULOG", 4);
+        mStream.put(static_cast<char>(Version));
+        mSessionId.fetch_add(1, std::memory_order_relaxed);
+        mSites.clear();
+        mOpen.store(true, std::memory_order_release);
+        return true;
+    }
+    void Close() {
+        if (!mOpen.exchange(false, std::memory_order_acq_rel)) return;
+        Flush();
+        std::lock_guard<mutex> lock(mFileMutex);
+        mStream.close();
+    }
+    void Flush() {
+        vector<shared_ptr<ThreadBuffer>> buffers;
+        {
+            std::lock_guard<mutex> lock(mFileMutex);
+            buffers = mBuffers;
+        }
+        for (auto &buffer : buffers) {
+            std::lock_guard<mutex> lock(buffer->Mutex);
+            WriteChunk(*buffer);
+        }
+        std::lock_guard<mutex> lock(mFileMutex);
+        mStream.flush();
+    }
+
+    // Accessors
+    bool IsOpen() const {
+        return mOpen.load(std::memory_order_acquire);
+    }
+
+    // Logging
+    template<typename... Args>
+    void operator()(const LogLevel &level, const BinaryLogSite &site, Args &&...args) {
+        site.Level = level;
+        this->operator()(site, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void operator()(const BinaryLogSite &site, Args &&...args) {
+        if (site.Level < logger.GetLevel() || !mOpen.load(std::memory_order_acquire)) return;
+        static_assert(sizeof...(Args) <= 255, "BinaryLogger: Too many arguments!");
+
+        auto id = GetSiteId(site);
+        auto ticks = static_cast<int64_t>(LogRecord::Clock::now().time_since_epoch().count());
+
+        auto &buffer = GetThreadBuffer();
+        std::lock_guard<mutex> lock(buffer.Mutex);
+        auto &data = buffer.Data;
+        WriteVarint(data, id);
+        WriteZigZag(data, ticks - buffer.Ticks);
+        buffer.Ticks = ticks;
+        data.push_back(static_cast<uint8_t>(sizeof...(Args)));
+        (Encode(data, args), ...);
+        if (data.size() >= ChunkSize) WriteChunk(buffer);
+    }
+
+private:
+    // Encoding
+    static void WriteVarint(vector<uint8_t> &data, uint64_t value) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<uint8_t>(value));
+    }
+    static void WriteZigZag(vector<uint8_t> &data, int64_t value) {
+        WriteVarint(data, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+    template<typename T>
+    static void WriteRaw(vector<uint8_t> &data, const T &value) {
+        auto offset = data.size();
+        data.resize(offset + sizeof(T));
+        std::memcpy(data.data() + offset, &value, sizeof(T));
+    }
+    static void WriteString(vector<uint8_t> &data, string_view value) {
+        WriteVarint(data, value.size());
+        data.insert(data.end(), value.begin(), value.end());
+    }
+
+    template<typename T>
+    static void Encode(vector<uint8_t> &data, const T &value) {
+        using Type = std::decay_t<T>;
+        if constexpr (std::is_same_v<Type, bool>) {
+            data.push_back(static_cast<uint8_t>(BinaryLogType::Bool));
+            data.push_back(value ? 1 : 0);
+        } else if constexpr (std::is_same_v<Type, char>) {
+            data.push_back(static_cast<uint8_t>(BinaryLogType::Char));
+            data.push_back(static_cast<uint8_t>(value));
+        } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+            data.push_back(static_cast<uint8_t>(BinaryLogType::Int));
+            WriteZigZag(data, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<Type>) {
+            data.push_back(static_cast<uint8_t>(BinaryLogType::UInt));
+            WriteVarint(data, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_same_v<Type, float>) {
+            data.push_back(static_cast<uint8_t>(BinaryLogType::Float));
+            WriteRaw(data, value);
+        } else if constexpr (std::is_floating_point_v<Type>) {
+            data.push_back(static_cast<uint8_t>(BinaryLogType::Double));
+            WriteRaw(data, static_cast<double>(value));
+        } else if constexpr (std::is_convertible_v<const Type &, string_view>) {
+            data.push_back(static_cast<uint8_t>(BinaryLogType::String));
+            WriteString(data, string_view(value));
+        } else if constexpr (std::is_pointer_v<Type>) {
+            data.push_back(static_cast<uint8_t>(BinaryLogType::Pointer));
+            WriteRaw(data, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+        } else {
+            // Everything else is formatted by the producer, like enumerations with custom formatters.
+            data.push_back(static_cast<uint8_t>(BinaryLogType::String));
+            WriteString(data, std::format("{}", value));
+        }
+    }
+
+    // Sites
+    uint32_t GetSiteId(const BinaryLogSite &site) {
+        // Each thread caches the IDs, so the registry is only locked once per site and thread.
+        thread_local unordered_map<SiteKey, uint32_t, SiteKeyHasher> cache;
+        thread_local uint64_t session {};
+        if (session != mSessionId.load(std::memory_order_relaxed)) {
+            cache.clear();
+            session = mSessionId.load(std::memory_order_relaxed);
+        }
+
+        SiteKey key { site.Format, site.Location.File.data(), site.Location.Line, site.Location.Column };
+        if (auto it = cache.find(key); it != cache.end()) return it->second;
+
+        std::lock_guard<mutex> lock(mFileMutex);
+        auto [it, inserted] = mSites.try_emplace(key, static_cast<uint32_t>(mSites.size()));
+        if (inserted) {
+            // The definition is written before any chunk, which could reference it.
+            vector<uint8_t> definition;
+            definition.push_back(static_cast<uint8_t>(BinaryLogTag::Site));
+            WriteVarint(definition, it->second);
+            definition.push_back(static_cast<uint8_t>(site.Level));
+            WriteVarint(definition, site.Location.Line);
+            WriteString(definition, site.Format);
+            WriteString(definition, site.Location.File);
+            WriteString(definition, site.Location.Class);
+            mStream.write(reinterpret_cast<const char *>(definition.data()), definition.size());
+        }
+        cache.emplace(key, it->second);
+        return it->second;
+    }
+
+    // Buffers
+    ThreadBuffer &GetThreadBuffer() {
+        thread_local shared_ptr<ThreadBuffer> buffer;
+        if (!buffer) {
+            buffer = std::make_shared<ThreadBuffer>();
+            buffer->Data.reserve(ChunkSize + 1024);
+            std::lock_guard<mutex> lock(mFileMutex);
+            buffer->Thread = static_cast<uint32_t>(mBuffers.size());
+            mBuffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    // Attention: The lock of the buffer has to be held by the caller.
+    void WriteChunk(ThreadBuffer &buffer) {
+        if (buffer.Data.empty()) return;
+
+        vector<uint8_t> header;
+        header.push_back(static_cast<uint8_t>(BinaryLogTag::Chunk));
+        WriteVarint(header, buffer.Thread);
+        WriteVarint(header, buffer.Data.size());
+
+        std::lock_guard<mutex> lock(mFileMutex);
+        if (mStream.is_open()) {
+            mStream.write(reinterpret_cast<const char *>(header.data()), header.size());
+            mStream.write(reinterpret_cast<const char *>(buffer.Data.data()), buffer.Data.size());
+        }
+        buffer.Data.clear();
+        buffer.Ticks = 0;
+    }
+
+private:
+    // Properties
+    atomic<bool> mOpen {};
+    atomic<uint64_t> mSessionId {};
+    mutex mFileMutex {};
+    ofstream mStream {};
+    unordered_map<SiteKey, uint32_t, SiteKeyHasher> mSites {};
+    vector<shared_ptr<ThreadBuffer>> mBuffers {};
+};
+
+inline BinaryLogger &blog = BinaryLogger::Instance();
+
+///
+/// @brief Binary Log Reader
+/// Expands binary logs into the same text layout as the FileLogger.
+///
+class BinaryLogReader {
+    // Types
+    using Value = std::variant<bool, char, int64_t, uint64_t, float, double, string, const void *>;
+
+    struct Site {
+        LogLevel Level {};
+        uint32_t Line {};
+        string Format;
+        string File;
+        string Class;
+    };
+
+public:
+    // Decodes the input file into the output stream, returns the amount of decoded messages or -1 on failure.
+    static int64_t Decode(const std::filesystem::path &input, ostream &output) {
+        std::ifstream stream(input, std::ios::binary);
+        if (!stream.is_open()) return -1;
+        vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        return Decode(data, output);
+    }
+
+    static int64_t Decode(const vector<uint8_t> &data, ostream &output) {
+        if (data.size() < 5 || std::memcmp(data.data(), "ULOG", 4) != 0 || data[4] != BinaryLogger::Version) return -1;
+
+        unordered_map<uint32_t, Site> sites;
+        int64_t messages {};
+        size_t position = 5;
+        try {
+            while (position < data.size()) {
+                switch (static_cast<BinaryLogTag>(data[position++])) {
+                    case BinaryLogTag::Site: {
+                        auto id = static_cast<uint32_t>(ReadVarint(data, position));
+                        auto &site = sites[id];
+                        site.Level = static_cast<LogLevel>(ReadByte(data, position));
+                        site.Line = static_cast<uint32_t>(ReadVarint(data, position));
+                        site.Format = ReadString(data, position);
+                        site.File = ReadString(data, position);
+                        site.Class = ReadString(data, position);
+                        break;
+                    }
+                    case BinaryLogTag::Chunk: {
+                        [[maybe_unused]] auto thread = ReadVarint(data, position);
+                        // The size has to be read before the position is taken, the read advances it
+                        auto size = static_cast<size_t>(ReadVarint(data, position));
+                        auto end = position + size;
+                        end = std::min(end, data.size());
+                        int64_t ticks {};
+                        while (position < end) {
+                            auto id = static_cast<uint32_t>(ReadVarint(data, position));
+                            ticks += ReadZigZag(data, position);
+                            auto count = ReadByte(data, position);
+                            vector<Value> values;
+                            values.reserve(count);
+                            for (uint8_t i = 0; i < count; i++) values.push_back(ReadValue(data, position));
+
+                            auto it = sites.find(id);
+                            if (it == sites.end()) throw std::runtime_error(std::format("Unknown call site '{}'!", id));
+                            Write(output, it->second, ticks, values);
+                            messages++;
+                        }
+                        break;
+                    }
+                    default: {
+                        throw std::runtime_error(std::format("Invalid tag at offset '{}'!", position - 1));
+                    }
+                }
+            }
+        } catch (const std::exception &ex) {
+            output << std::format("BinaryLogReader: {}\n", ex.what());
+            return -1;
+        }
+        return messages;
+    }
+
+    ///
+    /// @brief Formats the values with the replacement fields of the format string, each field is formatted on its own.
+    ///
+    static string Format(string_view format, const vector<Value> &values) {
+        string result;
+        size_t next {};
+        for (size_t i = 0; i < format.size(); i++) {
+            auto character = format[i];
+            if (character == '{' && i + 1 < format.size() && format[i + 1] == '{') { result += '{'; i++; continue; }
+            if (character == '}' && i + 1 < format.size() && format[i + 1] == '}') { result += '}'; i++; continue; }
+            if (character != '{') { result += character; continue; }
+
+            auto close = format.find('}', i);
+            if (close == string_view::npos) { result += format.substr(i); break; }
+            auto field = format.substr(i + 1, close - i - 1);
+            auto separator = field.find(':');
+            auto index = field.substr(0, separator);
+            auto specification = separator == string_view::npos ? string_view() : field.substr(separator);
+            size_t argument = next++;
+            if (!index.empty()) std::from_chars(index.data(), index.data() + index.size(), argument);
+
+            if (argument < values.size()) {
+                auto pattern = std::format("{{{}}}", specification);
+                result += std::visit([&](const auto &value) -> string {
+                    try {
+                        return std::vformat(pattern, std::make_format_args(value));
+                    } catch (const std::exception &) {
+                        return std::format("{}", value);
+                    }
+                }, values[argument]);
+            }
+            i = close;
+        }
+        return result;
+    }
+
+private:
+    static void Write(ostream &output, const Site &site, int64_t ticks, const vector<Value> &values) {
+        auto message = Format(site.Format, values);
+        switch (site.Level) {
+            case LogLevel::Default: { output << std::format("{}{}", site.Level, message); break; }
+            case LogLevel::Caption: { output << std::format("{}  {}{}", site.Level, message, site.Level); break; }
+            case LogLevel::Delimiter: { output << std::format("{}", site.Level); break; }
+            default: {
+                output << std::format("{}{}<{}> {}",
+                    LogRecord("", site.Level, static_cast<LogRecord::Clock::rep>(ticks)).GetTimeStamp(),
+                    site.Level,
+                    site.Class,
+                    message
+                );
+                break;
+            }
+        }
+        if (!message.ends_with('\n')) output << '\n';
+    }
+
+    // Decoding
+    static uint8_t ReadByte(const vector<uint8_t> &data, size_t &position) {
+        if (position >= data.size()) throw std::runtime_error("Unexpected end of file!");
+        return data[position++];
+    }
+    static uint64_t ReadVarint(const vector<uint8_t> &data, size_t &position) {
+        uint64_t value {};
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            auto byte = ReadByte(data, position);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("Invalid varint!");
+    }
+    static int64_t ReadZigZag(const vector<uint8_t> &data, size_t &position) {
+        auto value = ReadVarint(data, position);
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+    template<typename T>
+    static T Read(const vector<uint8_t> &data, size_t &position) {
+        if (position + sizeof(T) > data.size()) throw std::runtime_error("Unexpected end of file!");
+        T value;
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+    static string ReadString(const vector<uint8_t> &data, size_t &position) {
+        auto size = static_cast<size_t>(ReadVarint(data, position));
+        if (position + size > data.size()) throw std::runtime_error("Unexpected end of file!");
+        string value(reinterpret_cast<const char *>(data.data() + position), size);
+        position += size;
+        return value;
+    }
+    static Value ReadValue(const vector<uint8_t> &data, size_t &position) {
+        switch (static_cast<BinaryLogType>(ReadByte(data, position))) {
+            case BinaryLogType::Bool:       { return ReadByte(data, position) != 0; }
+            case BinaryLogType::Char:       { return static_cast<char>(ReadByte(data, position)); }
+            case BinaryLogType::Int:        { return ReadZigZag(data, position); }
+            case BinaryLogType::UInt:       { return ReadVarint(data, position); }
+            case BinaryLogType::Float:      { return Read<float>(data, position); }
+            case BinaryLogType::Double:     { return Read<double>(data, position); }
+            case BinaryLogType::String:     { return ReadString(data, position); }
+            case BinaryLogType::Pointer:    { return reinterpret_cast<const void *>(static_cast<uintptr_t>(Read<uint64_t>(data, position))); }
+            default: { throw std::runtime_error("Invalid argument type!"); }
+        }
+    }
+};
+
+}
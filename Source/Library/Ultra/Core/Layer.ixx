@@ -2,6 +2,7 @@
 
 import Ultra.Core;
 import Ultra.Core.Event.Data;
+import Ultra.Core.TaskGraph;
 import Ultra.System.Event;
 
 export namespace Ultra {
@@ -19,9 +20,18 @@ public:
 
     virtual void Create() {}
     virtual void Destroy() {}
+    // Runs zero or more times per frame with a constant step, if the application uses a fixed simulation rate.
+    virtual void FixedUpdate([[maybe_unused]] Timestamp step) {}
     virtual void GuiUpdate() {}
     virtual void Update([[maybe_unused]] Timestamp deltaTime) {}
 
+    // Declares the per-frame work of this layer, by default the update runs serialized with all other layers on the main thread.
+    virtual void Schedule(TaskGraph &graph) {
+        graph.Add(mName, [this](Timestamp deltaTime) { Update(deltaTime); })
+            .Affinity(TaskAffinity::MainThread)
+            .Write("Layers");
+    }
+
     inline const string &GetName() const { return mName; }
 
     // EventListener
@@ -54,10 +64,12 @@ public:
     void PushLayer(Layer *layer) {
         Layers.emplace(Layers.begin() + LayerInsertIndex, layer);
         LayerInsertIndex++;
+        Revision++;
         layer->Attach();
     }
     void PushOverlay(Layer *overlay) {
         Layers.emplace_back(overlay);
+        Revision++;
         overlay->Attach();
     }
     void PopLayer(Layer *layer) {
@@ -66,16 +78,21 @@ public:
             layer->Detach();
             Layers.erase(it);
             LayerInsertIndex--;
+            Revision++;
         }
     }
     void PopOverlay(Layer *overlay) {
-        auto it = std::find(Layers.begin() + LayerInsertIndex, Layers.begin(), overlay);
-        if (it != Layers.begin() + LayerInsertIndex) {
+        auto it = std::find(Layers.begin() + LayerInsertIndex, Layers.end(), overlay);
+        if (it != Layers.end()) {
             overlay->Detach();
             Layers.erase(it);
+            Revision++;
         }
     }
 
+    // Changes with every push and pop, so that state derived from the layers (like the frame graph) knows when it is outdated.
+    uint32_t GetRevision() const { return Revision; }
+
     auto begin() { return Layers.begin(); }
     auto end() { return Layers.end(); }
     auto rbegin() { return Layers.rbegin(); }
@@ -88,6 +105,7 @@ public:
 
 private:
     uint32_t LayerInsertIndex = 0;
+    uint32_t Revision = 0;
     vector<Layer *> Layers;
     vector<Layer *>::iterator LayerInsert;
 };
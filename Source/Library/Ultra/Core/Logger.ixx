@@ -94,32 +94,38 @@ inline auto &operator<<(wostream &os, const T &level) {
 /// @brief LogRecord
 /// Contains the format, the location, the loglevel and timestamp.
 /// 
-/// @remark I tried Timestamp as string_view, it worked ... but only as function parameter,
-/// when I tried to create LogRecord normally, the Timestamp was corrupted, so as GetTimeStamp()
-/// creates a string anyway, it should be fine to leave it as string. After some tests, it was
-/// faster then string_view, 'cause under the hood it created a temporary string_view.
+/// @remark The timestamp is captured as raw clock ticks, the ISO 8601 string is only created by the
+/// sinks which need it. Formatting it at every call site was the most expensive part of a filtered
+/// log message, and in asynchronous mode it now happens on the background thread.
 ///
 struct LogRecord {
+    using Clock = std::chrono::system_clock;
+
     const char *Format;
     mutable LogLevel Level;
     SourceLocation Location;
-    string Timestamp;
+    Clock::rep Ticks;
 
-    LogRecord(const char *format, const LogLevel &level = LogLevel::Default, const string &timestamp = apptime.GetTimeStamp(), const SourceLocation &location = SourceLocation::Current()):
+    LogRecord(const char *format = "", const LogLevel &level = LogLevel::Default, Clock::rep ticks = Clock::now().time_since_epoch().count(), const SourceLocation &location = SourceLocation::Current()):
         Format(format),
         Level(level),
         Location(location),
-        Timestamp(timestamp) {
+        Ticks(ticks) {
+    }
+
+    // Retrieve timestamp in ISO 8601 format 'YYYY-mm-ddTHH:mm:ss.cccccc'
+    string GetTimeStamp() const {
+        return std::format("{:%Y-%m-%dT%H:%M:%S}", Clock::time_point(Clock::duration(Ticks)));
     }
 
     bool operator==(const LogRecord &other) const {
-        return Level == other.Level && Timestamp == other.Timestamp;
+        return Level == other.Level && Ticks == other.Ticks;
     }
 };
 
 struct LogRecordHasher {
     size_t operator()(const LogRecord &record) const {
-        return std::hash<LogLevel>{}(record.Level) ^ std::hash<string>{}(record.Timestamp);
+        return std::hash<LogLevel>{}(record.Level) ^ std::hash<LogRecord::Clock::rep>{}(record.Ticks);
     }
 };
 
@@ -141,6 +147,9 @@ public:
     virtual ~ILogger() = default;
 
     virtual void operator()(const LogRecord &record, std::format_args arguments) = 0;
+    virtual void Flush() {}
+    // The asynchronous backend flushes the sinks after every batch, so they don't need to flush every message
+    virtual void SetBatched([[maybe_unused]] bool batched) {}
 
     virtual const string &GetName() const = 0;
     virtual LoggerType GetType() const = 0;
@@ -185,7 +194,7 @@ public:
             }
             default: {
                 mStream << std::format("{}{}{}{}{}<{}> {}{}{}{}",
-                    Cli::Color::Gray, record.Timestamp,
+                    Cli::Color::Gray, record.GetTimeStamp(),
                     levelColor, record.Level,
                     Cli::Color::LightGray, record.Location.Class,
                     Cli::Color::White, message,
@@ -196,6 +205,11 @@ public:
         }
     }
 
+    void Flush() override {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStream.flush();
+    }
+
     const string &GetName() const override { return mName; }
     LoggerType GetType() const override { return mType; }
 
@@ -262,7 +276,7 @@ public:
             }
             default: {
                 mStream << std::format("{}{}<{}> {}",
-                    record.Timestamp,
+                    record.GetTimeStamp(),
                     record.Level,
                     record.Location.Class,
                     message
@@ -271,8 +285,17 @@ public:
             }
         }
 
+        // In batched mode only important messages are written through immediately, the rest is flushed with the batch.
+        if (!mBatched || (record.Level >= LogLevel::Warn && record.Level <= LogLevel::Fatal)) mStream.flush();
+    }
+    void Flush() override {
+        std::lock_guard<std::mutex> lock(mMutex);
         mStream.flush();
     }
+    void SetBatched(bool batched) override {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBatched = batched;
+    }
 
     const string &GetName() const override { return mName; }
     LoggerType GetType() const override { return mType; }
@@ -283,6 +306,7 @@ private:
 
     mutex mMutex;
     ofstream mStream;
+    bool mBatched {};
 };
 
 ///
@@ -320,6 +344,100 @@ private:
 };
 
 
+///
+/// Asynchronous Backend
+///
+
+///
+/// @brief Decides what happens, when the producers are faster than the background thread and the ring is full.
+/// Block: wait until a slot is free, Drop: discard the message (counted and reported), Grow: spill into an unbounded overflow list.
+///
+enum class LogOverflowPolicy {
+    Block   = 0x0,
+    Drop    = 0x1,
+    Grow    = 0x2,
+};
+
+///
+/// @brief Queued message, the arguments are copied inline and formatted later by the background thread.
+///
+struct LogMessage {
+    // Types
+    using Formatter = string(*)(const LogMessage &);
+    using Destructor = void(*)(LogMessage &);
+
+    // Limits
+    static constexpr size_t StorageSize = 160;
+
+    // Properties
+    LogRecord Record {};
+    Formatter Format {};
+    Destructor Destroy {};
+    std::optional<LoggerType> Target {};
+    alignas(std::max_align_t) std::byte Storage[StorageSize] {};
+};
+
+///
+/// @brief Bounded lock-free multi-producer single-consumer ring (based on the sequence numbers of Dmitry Vyukov's queue).
+///
+class LogRingBuffer {
+    // Types
+    struct alignas(64) Slot {
+        atomic<size_t> Sequence {};
+        LogMessage Message {};
+    };
+
+public:
+    LogRingBuffer(size_t capacity): mCapacity(std::bit_ceil(std::max(capacity, size_t(2)))), mMask(mCapacity - 1), mSlots(std::make_unique<Slot[]>(mCapacity)) {
+        for (size_t i = 0; i < mCapacity; i++) mSlots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+    ~LogRingBuffer() = default;
+
+    // Producers
+    LogMessage *Claim(size_t &position) {
+        auto current = mEnqueuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            auto &slot = mSlots[current & mMask];
+            auto sequence = slot.Sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(current);
+            if (difference == 0) {
+                if (mEnqueuePosition.compare_exchange_weak(current, current + 1, std::memory_order_relaxed)) {
+                    position = current;
+                    return &slot.Message;
+                }
+            } else if (difference < 0) {
+                return nullptr;
+            } else {
+                current = mEnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    void Publish(size_t position) {
+        mSlots[position & mMask].Sequence.store(position + 1, std::memory_order_release);
+    }
+
+    // Consumer
+    LogMessage *Front() {
+        auto &slot = mSlots[mDequeuePosition & mMask];
+        if (slot.Sequence.load(std::memory_order_acquire) != mDequeuePosition + 1) return nullptr;
+        return &slot.Message;
+    }
+    void Pop() {
+        mSlots[mDequeuePosition & mMask].Sequence.store(mDequeuePosition + mCapacity, std::memory_order_release);
+        mDequeuePosition++;
+    }
+
+    // Accessors
+    size_t GetCapacity() const { return mCapacity; }
+
+private:
+    const size_t mCapacity;
+    const size_t mMask;
+    Scope<Slot[]> mSlots;
+    alignas(64) atomic<size_t> mEnqueuePosition {};
+    alignas(64) size_t mDequeuePosition {};
+};
+
 ///
 /// @brief Logger
 /// 
@@ -331,7 +449,7 @@ class Logger: public SteadyObject {
 private:
     // Constructors and Deconstructor
     Logger(): mLogLevel(LogLevel::Trace) {}
-    virtual ~Logger() = default;
+    virtual ~Logger() { DisableAsync(); }
 
 public:
     // Get the global instance to the logger
@@ -343,6 +461,7 @@ public:
     // Methods
     void Attach(Scope<ILogger> sink) {
         std::unique_lock<mutex> lock(mMutex);
+        sink->SetBatched(mAsync.load(std::memory_order_relaxed));
         mSinks.push_back(std::move(sink));
     }
     void Detach(const string &name) {
@@ -357,10 +476,39 @@ public:
         mStreamLogLevel = LogLevel::Default;
     }
 
+    ///
+    /// @brief Switches to the asynchronous mode, the producers only copy their arguments into a ring,
+    /// the formatting, the sinks and the batched flushing are handled by a background thread.
+    /// @note The format strings have to outlive the message, which is the case for string literals.
+    /// Switching the mode while other threads are logging isn't supported.
+    ///
+    void EnableAsync(size_t capacity = 8192, LogOverflowPolicy policy = LogOverflowPolicy::Block) {
+        DisableAsync();
+        mRing = CreateScope<LogRingBuffer>(capacity);
+        mOverflowPolicy = policy;
+        mAsyncRunning.store(true, std::memory_order_relaxed);
+        SetBatched(true);
+        mAsync.store(true, std::memory_order_release);
+        mAsyncThread = thread([this] { AsyncLoop(); });
+    }
+    void DisableAsync() {
+        if (!mAsync.exchange(false, std::memory_order_acq_rel)) return;
+        mAsyncRunning.store(false, std::memory_order_release);
+        WakeAsync(true);
+        if (mAsyncThread.joinable()) mAsyncThread.join();
+        SetBatched(false);
+    }
+
     // Accessors
     LogLevel GetLevel() const {
         return mLogLevel;
     }
+    uint64_t GetDroppedMessages() const {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+    bool IsAsync() const {
+        return mAsync.load(std::memory_order_relaxed);
+    }
 
     // Mutators
     void SetLevel(const LogLevel &level) {
@@ -371,7 +519,7 @@ public:
     // Format-Support
     template<typename... Args>
     void operator()(const LogLevel &level, const LogRecord &record, Args &&...args) {
-        if (record.Level < mLogLevel) return;
+        if (level < mLogLevel) return;
         record.Level = level;
         this->operator()(record, std::forward<Args>(args)...);
     }
@@ -379,6 +527,10 @@ public:
     template<typename... Args>
     void operator()(const LoggerType &type, const LogRecord &record, Args &&...args) {
         if (record.Level < mLogLevel) return;
+        if (mAsync.load(std::memory_order_acquire)) {
+            Enqueue(type, record, std::forward<Args>(args)...);
+            return;
+        }
         std::lock_guard<mutex> lock(mMutex);
         mCounter++;
         try {
@@ -394,6 +546,10 @@ public:
     template<typename... Args>
     void operator()(const LogRecord &record, Args &&...args) {
         if (record.Level < mLogLevel) return;
+        if (mAsync.load(std::memory_order_acquire)) {
+            Enqueue(std::nullopt, record, std::forward<Args>(args)...);
+            return;
+        }
         std::lock_guard<mutex> lock(mMutex);
         mCounter++;
         try {
@@ -516,12 +672,171 @@ public:
         //logger << "Mixed String Types " << L"and Wide " << "... not wide " << L"and so on.\n";
     }
 
+private:
+    // Asynchronous Backend
+    // Strings are copied into the message, everything else is stored as is.
+    template<typename T>
+    using LogArgument = std::conditional_t<std::is_convertible_v<std::decay_t<T>, string_view>, string, std::decay_t<T>>;
+
+    template<typename... Args>
+    static void Prepare(LogMessage &message, const std::optional<LoggerType> &target, const LogRecord &record, Args &&...args) {
+        using Arguments = std::tuple<LogArgument<Args>...>;
+
+        message.Record = record;
+        message.Target = target;
+        if constexpr (sizeof(Arguments) <= LogMessage::StorageSize && alignof(Arguments) <= alignof(std::max_align_t)) {
+            new (message.Storage) Arguments(std::forward<Args>(args)...);
+            message.Format = [](const LogMessage &message) -> string {
+                const auto &arguments = *std::launder(reinterpret_cast<const Arguments *>(message.Storage));
+                return std::apply([&](const auto &...values) { return std::vformat(message.Record.Format, std::make_format_args(values...)); }, arguments);
+            };
+            message.Destroy = [](LogMessage &message) {
+                std::destroy_at(std::launder(reinterpret_cast<Arguments *>(message.Storage)));
+            };
+        } else {
+            // Too large for the inline storage, so this message is formatted by the producer.
+            string text;
+            try {
+                text = std::vformat(record.Format, std::make_format_args(args...));
+            } catch (const std::exception &ex) {
+                text = ex.what();
+            }
+            Prepare(message, target, { "{}", record.Level, record.Ticks, record.Location }, std::move(text));
+        }
+    }
+
+    template<typename... Args>
+    void Enqueue(const std::optional<LoggerType> &target, const LogRecord &record, Args &&...args) {
+        try {
+            if (!mOverflowing.load(std::memory_order_acquire)) {
+                size_t position {};
+                if (auto *message = mRing->Claim(position)) {
+                    Prepare(*message, target, record, std::forward<Args>(args)...);
+                    mRing->Publish(position);
+                    WakeAsync();
+                    return;
+                }
+            }
+
+            switch (mOverflowPolicy) {
+                case LogOverflowPolicy::Block: {
+                    size_t position {};
+                    LogMessage *message {};
+                    while (!(message = mRing->Claim(position))) {
+                        WakeAsync(true);
+                        std::this_thread::yield();
+                    }
+                    Prepare(*message, target, record, std::forward<Args>(args)...);
+                    mRing->Publish(position);
+                    break;
+                }
+                case LogOverflowPolicy::Drop: {
+                    mDropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                case LogOverflowPolicy::Grow: {
+                    auto message = CreateScope<LogMessage>();
+                    Prepare(*message, target, record, std::forward<Args>(args)...);
+                    std::lock_guard<mutex> lock(mOverflowMutex);
+                    mOverflow.push_back(std::move(message));
+                    mOverflowing.store(true, std::memory_order_release);
+                    break;
+                }
+            }
+            WakeAsync();
+        } catch (std::exception ex) {
+            //this->operator()("Ultra::Logger: {}", ex.what());
+        }
+    }
+
+    void SetBatched(bool batched) {
+        std::lock_guard<mutex> lock(mMutex);
+        for (const auto &sink : mSinks) sink->SetBatched(batched);
+    }
+    void WakeAsync(bool force = false) {
+        mAsyncSignal.fetch_add(1, std::memory_order_seq_cst);
+        if (force || mAsyncSleeping.load(std::memory_order_seq_cst)) mAsyncSignal.notify_one();
+    }
+
+    void Dispatch(LogMessage &message) {
+        try {
+            auto text = message.Format(message);
+            LogRecord record = message.Record;
+            record.Format = "{}";
+            auto arguments = std::make_format_args(text);
+
+            std::lock_guard<mutex> lock(mMutex);
+            mCounter++;
+            for (const auto &sink : mSinks) {
+                if (!message.Target || sink->GetType() == *message.Target) sink->operator()(record, arguments);
+            }
+        } catch (std::exception ex) {
+            //this->operator()("Ultra::Logger: {}", ex.what());
+        }
+        message.Destroy(message);
+    }
+
+    void AsyncLoop() {
+        vector<Scope<LogMessage>> overflow;
+        for (;;) {
+            auto signal = mAsyncSignal.load(std::memory_order_seq_cst);
+            size_t processed {};
+
+            // Process the ring in batches, the overflow is only touched when it has been used.
+            while (auto *message = mRing->Front()) {
+                Dispatch(*message);
+                mRing->Pop();
+                processed++;
+            }
+            if (mOverflowing.load(std::memory_order_acquire)) {
+                {
+                    std::lock_guard<mutex> lock(mOverflowMutex);
+                    overflow.swap(mOverflow);
+                    mOverflowing.store(false, std::memory_order_release);
+                }
+                for (auto &message : overflow) Dispatch(*message);
+                processed += overflow.size();
+                overflow.clear();
+            }
+            if (auto dropped = mDropped.exchange(0, std::memory_order_relaxed)) {
+                LogMessage message {};
+                Prepare(message, std::nullopt, { "Ultra::Logger: Dropped {} messages, the ring buffer was full!\n", LogLevel::Warn }, dropped);
+                Dispatch(message);
+                processed++;
+            }
+
+            if (processed) {
+                std::lock_guard<mutex> lock(mMutex);
+                for (const auto &sink : mSinks) sink->Flush();
+                continue;
+            }
+            if (!mAsyncRunning.load(std::memory_order_acquire)) break;
+
+            mAsyncSleeping.store(true, std::memory_order_seq_cst);
+            if (!mRing->Front() && !mOverflowing.load(std::memory_order_seq_cst)) mAsyncSignal.wait(signal, std::memory_order_seq_cst);
+            mAsyncSleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
 private:
     // Properties
     LogLevel mLogLevel;
     mutex mMutex {};
     vector<Scope<ILogger>> mSinks {};
 
+    // Asynchronous Backend
+    atomic<bool> mAsync {};
+    atomic<bool> mAsyncRunning {};
+    atomic<bool> mAsyncSleeping {};
+    atomic<uint32_t> mAsyncSignal {};
+    atomic<uint64_t> mDropped {};
+    thread mAsyncThread {};
+    Scope<LogRingBuffer> mRing {};
+    LogOverflowPolicy mOverflowPolicy { LogOverflowPolicy::Block };
+    atomic<bool> mOverflowing {};
+    mutex mOverflowMutex {};
+    vector<Scope<LogMessage>> mOverflow {};
+
     // States
     uint64_t mCounter {};
     bool mSkip = false;
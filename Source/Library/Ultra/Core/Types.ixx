@@ -5,11 +5,15 @@
 export import <algorithm>;
 export import <array>;
 export import <atomic>;
+export import <bit>;
 export import <bitset>;
+export import <charconv>;
 export import <chrono>;
 export import <condition_variable>;
 export import <cstdlib>;
 export import <cstdint>;
+export import <cstring>;
+export import <deque>;
 export import <exception>;
 export import <format>;
 export import <functional>;
@@ -23,8 +27,10 @@ export import <limits>;
 export import <list>;
 export import <map>;
 export import <memory>;
+export import <memory_resource>;
 export import <mutex>;
 export import <numbers>;
+export import <optional>;
 export import <ostream>;
 export import <print>;
 export import <queue>;
@@ -44,6 +50,7 @@ export import <unordered_map>;
 export import <unordered_set>;
 export import <vector>;
 export import <utility>;
+export import <variant>;
 
 ///
 /// @brief The following containers, literals and types are used quite often, therefore they are exposed under the root namespace.
@@ -61,6 +68,7 @@ using std::thread;
 // Container
 using std::array;
 using std::byte;
+using std::deque;
 using std::function;
 using std::list;
 using std::map;
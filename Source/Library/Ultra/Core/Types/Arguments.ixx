@@ -9,6 +9,7 @@ export namespace Ultra {
 /// 
 /// @example
 /// Arguments arguments { argv + 1, argv + argc };
+/// auto frames = arguments.GetValue("--benchmark");
 ///
 class Arguments {
 private:
@@ -18,6 +19,20 @@ public:
     Arguments() = default;
     Arguments(const ArgumentList &arguments): mArgumentList(arguments) {}
 
+    // Accessors
+    bool Contains(string_view option) const {
+        return std::ranges::any_of(mArgumentList, [&](const auto &argument) { return argument == option || argument.starts_with(string(option) + "="); });
+    }
+    // Returns the value of an option passed as '<option>=<value>', or an empty view
+    string_view GetValue(string_view option) const {
+        for (const auto &argument : mArgumentList) {
+            if (argument.size() > option.size() && argument.starts_with(option) && argument[option.size()] == '=') {
+                return string_view(argument).substr(option.size() + 1);
+            }
+        }
+        return {};
+    }
+
 private:
     ArgumentList mArgumentList = {};
 };
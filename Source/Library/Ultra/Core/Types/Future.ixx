@@ -1,39 +1,478 @@
 ﻿export module Ultra.Core.Future;
 
 import Ultra.Core;
+import Ultra.Core.JobSystem;
+import Ultra.Core.ThreadPool;
+
+///
+/// @brief Futures with continuations, combinators and cancellation.
+/// A continuation is attached with 'Then' and runs, as soon as its ancestor completed, on the chosen executor:
+///  - Inline:      on the thread which completed the ancestor
+///  - Worker:      as task on a thread pool for long running work (default)
+///  - MainThread:  on the main thread, when the CompletionQueue is drained (once per frame by the application)
+/// Errors propagate through the chain and skip the continuations, 'Get' rethrows them at the end.
+///
+/// @example
+/// auto texture = Async([] { return File::LoadAsBinary("Assets/Textures/Wall.png"); })
+///     .Then([](const vector<char> &data) { return Image::Decode(data); })
+///     .Then([](const Image &image) { return Texture::Create(image); }, Launch::MainThread);
+/// ...
+/// if (texture.IsReady()) mTexture = texture.Get();
+///
+/// @note Cancelling a future completes it with 'FutureCancelled' and skips the continuations, which didn't start yet.
+/// Long running producers can check the token passed to 'Async' and stop early.
+///
 
 export namespace Ultra {
 
 ///
-/// @brief Container for future objects, with some syntactic sugar.
-/// @note ToDo: Implement future utility classes, functions here.
+/// @brief Executors for asynchronous functions and continuations
+///
+enum class Launch {
+    Inline,
+    Worker,
+    MainThread,
+};
+
+///
+/// @brief The exception of a cancelled future
+///
+class FutureCancelled: public std::runtime_error {
+public:
+    FutureCancelled(): std::runtime_error("Future: The operation was cancelled!") {}
+};
+
+///
+/// @brief Queue for continuations, which have to run on the main thread (e.g. graphics resource creation)
+///
+class CompletionQueue {
+    // Types
+    using Task = std::move_only_function<void()>;
+
+public:
+    // Get the engine-wide instance
+    static CompletionQueue &Instance() {
+        static CompletionQueue instance;
+        return instance;
+    }
+
+    // Methods
+    void Post(Task task) {
+        std::lock_guard<mutex> lock(mMutex);
+        mTasks.push_back(std::move(task));
+    }
+
+    /// Executes the queued tasks and returns their count, tasks which are posted meanwhile run with the next drain
+    size_t Drain() {
+        {
+            std::lock_guard<mutex> lock(mMutex);
+            if (mTasks.empty()) return 0;
+            mTasks.swap(mPending);
+        }
+        for (auto &task : mPending) task();
+        auto count = mPending.size();
+        mPending.clear();
+        return count;
+    }
+
+private:
+    mutex mMutex;
+    vector<Task> mTasks;
+    vector<Task> mPending;
+};
+
+}
+
+namespace Ultra {
+
+void Schedule(Launch launch, std::move_only_function<void()> task) {
+    switch (launch) {
+        case Launch::Inline: {
+            task();
+            break;
+        }
+        case Launch::Worker: {
+            // Tasks (file loads, shader compiles, etc.) can outlive thousands of job allocations, so they stay out of the
+            // recycled job ring, the pool copies its tasks, so the task is moved behind a shared pointer.
+            static ThreadPool pool(std::max(thread::hardware_concurrency() / 2, 2u));
+            pool.Enqueue([task = std::make_shared<std::move_only_function<void()>>(std::move(task))] { (*task)(); });
+            break;
+        }
+        case Launch::MainThread: {
+            CompletionQueue::Instance().Post(std::move(task));
+            break;
+        }
+    }
+}
+
+struct FutureStateBase {
+    atomic<bool> Cancelled {};
+    atomic<bool> Ready {};
+};
+
+///
+/// @brief Shared state between promise and futures, the continuations are executed by the thread which completes it.
+///
+template<typename T>
+struct FutureState: FutureStateBase {
+    using Storage = std::conditional_t<std::is_void_v<T>, empty_t, T>;
+
+    // Returns false, if the state was already completed (e.g. by a cancellation)
+    template<typename ...Args>
+    bool SetValue(Args &&...args) {
+        return Complete([&] { Value.emplace(std::forward<Args>(args)...); });
+    }
+    bool SetException(std::exception_ptr error) {
+        return Complete([&] { Error = error; });
+    }
+
+    // Executes the callback immediately, if the state is already completed
+    void OnReady(std::move_only_function<void()> callback) {
+        {
+            std::lock_guard<mutex> lock(Mutex);
+            if (!Ready.load(std::memory_order_relaxed)) {
+                Continuations.push_back(std::move(callback));
+                return;
+            }
+        }
+        callback();
+    }
+
+    template<typename Duration>
+    void WaitFor(Duration duration) {
+        std::unique_lock<mutex> lock(Mutex);
+        Condition.wait_for(lock, duration, [this] { return Ready.load(std::memory_order_relaxed); });
+    }
+
+    // Properties
+    std::optional<Storage> Value;
+    std::exception_ptr Error;
+
+private:
+    template<typename F>
+    bool Complete(F &&store) {
+        vector<std::move_only_function<void()>> continuations;
+        {
+            std::lock_guard<mutex> lock(Mutex);
+            if (Ready.load(std::memory_order_relaxed)) return false;
+            store();
+            Ready.store(true, std::memory_order_release);
+            continuations.swap(Continuations);
+        }
+        Condition.notify_all();
+        for (auto &continuation : continuations) continuation();
+        return true;
+    }
+
+private:
+    mutex Mutex;
+    condition_variable Condition;
+    vector<std::move_only_function<void()>> Continuations;
+};
+
+}
+
+export namespace Ultra {
+
+template<typename T>
+class Future;
+
+template<typename T>
+class Promise;
+
+template<typename Result, typename Value, typename Invoker>
+void Fulfill(Promise<Value> &promise, Invoker &&invoke);
+
+template<typename T>
+struct IsFuture: std::false_type {};
+template<typename T>
+struct IsFuture<Future<T>>: std::true_type {};
+
+// Futures returned by continuations are unwrapped, so that asynchronous steps can be chained
+template<typename T>
+struct UnwrapFuture { using Type = T; };
+template<typename T>
+struct UnwrapFuture<Future<T>> { using Type = T; };
+
+///
+/// @brief Lets a running producer check, if its result is still wanted.
+///
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    CancellationToken(shared_ptr<const FutureStateBase> state): mState(std::move(state)) {}
+
+    bool IsCancelled() const { return mState && mState->Cancelled.load(std::memory_order_relaxed); }
+
+private:
+    shared_ptr<const FutureStateBase> mState;
+};
+
+///
+/// @brief The producing side of a future.
+///
+template<typename T>
+class Promise {
+public:
+    Promise(): mState(std::make_shared<FutureState<T>>()) {}
+
+    // Accessors
+    Future<T> GetFuture() const { return Future<T>(mState); }
+    CancellationToken GetToken() const { return CancellationToken(mState); }
+    bool IsCancelled() const { return mState->Cancelled.load(std::memory_order_relaxed); }
+
+    // Mutators
+    /// Completes the future, returns false if it was already completed or cancelled
+    template<typename ...Args>
+    bool SetValue(Args &&...args) {
+        return mState->SetValue(std::forward<Args>(args)...);
+    }
+    bool SetException(std::exception_ptr error) {
+        return mState->SetException(error);
+    }
+
+private:
+    shared_ptr<FutureState<T>> mState;
+};
+
+///
+/// @brief The consuming side, copies share the same result.
 ///
 template<typename T>
 class Future {
+    // Friends
+    friend class Promise<T>;
+
 public:
+    // Default
     Future() noexcept = default;
-    Future(std::future<T> &&future) noexcept: mFuture(std::move(future)) {}
+    ~Future() = default;
+
+    // Accessors
+    bool IsCancelled() const noexcept { return mState && mState->Cancelled.load(std::memory_order_relaxed); }
+    bool IsReady() const noexcept { return mState && mState->Ready.load(std::memory_order_acquire); }
+    bool IsValid() const noexcept { return mState != nullptr; }
+    /// Retrieve the exception of a failed future (only valid when ready)
+    std::exception_ptr GetException() const { return IsReady() ? mState->Error : nullptr; }
+
+    /// Retrieve the result, blocks if it isn't ready and rethrows the exception of a failed future
+    decltype(auto) Get() const & {
+        Wait();
+        if (mState->Error) std::rethrow_exception(mState->Error);
+        if constexpr (!std::is_void_v<T>) return static_cast<T &>(*mState->Value);
+    }
+    /// Temporary futures return the result by value, as the shared state may be released with them
+    auto Get() && -> T {
+        Wait();
+        if (mState->Error) std::rethrow_exception(mState->Error);
+        if constexpr (!std::is_void_v<T>) {
+            if (mState.use_count() == 1) return std::move(*mState->Value);
+            return *mState->Value;
+        }
+    }
+
+    ///
+    /// @brief Blocks until the result is ready, pending jobs are executed meanwhile, so that waiting on a job thread can't deadlock.
+    /// @note Waiting on the main thread for a 'Launch::MainThread' continuation never finishes, as the queue isn't drained.
+    ///
+    void Wait() const {
+        if (!mState) throw std::runtime_error("Future: Wait on an empty future!");
+        auto &jobs = JobSystem::Instance();
+        while (!IsReady()) {
+            if (jobs.TryExecute()) continue;
+            mState->WaitFor(std::chrono::microseconds(100));
+        }
+    }
 
-    T &Get() noexcept {
-        if (mFuture.valid()) mCurrent = mFuture.get();
-        return *mCurrent;
+    // Methods
+    /// Completes the future with 'FutureCancelled', continuations which didn't start yet are skipped
+    void Cancel() {
+        if (!mState) return;
+        mState->Cancelled.store(true, std::memory_order_relaxed);
+        mState->SetException(std::make_exception_ptr(FutureCancelled()));
     }
 
-    constexpr operator bool() const noexcept {
-        return mFuture.valid() || mCurrent;
+    ///
+    /// @brief Attaches a continuation, which receives the value (or nothing for void) and runs on the chosen executor.
+    /// @return A future for the result of the continuation, returned futures are unwrapped.
+    ///
+    template<typename F>
+    auto Then(F &&function, Launch launch = Launch::Worker) {
+        using Result = decltype(Invoke(function, std::declval<const FutureState<T> &>()));
+        using Value = typename UnwrapFuture<Result>::Type;
+
+        Promise<Value> promise;
+        auto result = promise.GetFuture();
+        mState->OnReady([state = mState, promise, function = std::forward<F>(function), launch]() mutable {
+            Schedule(launch, [state = std::move(state), promise = std::move(promise), function = std::move(function)]() mutable {
+                if (promise.IsCancelled()) return;
+                if (state->Error) {
+                    promise.SetException(state->Error);
+                    return;
+                }
+                Fulfill<Result>(promise, [&]() -> Result { return Invoke(function, *state); });
+            });
+        });
+        return result;
     }
-    constexpr operator T &() const noexcept {
-        return *Get();
+
+    ///
+    /// @brief Attaches a callback, which receives this future after it completed, regardless whether it succeeded, failed or was cancelled.
+    ///
+    template<typename F>
+    void OnComplete(F &&callback, Launch launch = Launch::Inline) const {
+        mState->OnReady([future = *this, callback = std::forward<F>(callback), launch]() mutable {
+            Schedule(launch, [future = std::move(future), callback = std::move(callback)]() mutable { callback(future); });
+        });
     }
 
-    bool operator==(const Future &rhs) const noexcept { return (mFuture == rhs.mFuture && mCurrent == rhs.mCurrent); }
+    // Operators
+    explicit operator bool() const noexcept { return IsValid(); }
+    bool operator==(const Future &rhs) const noexcept { return mState == rhs.mState; }
     bool operator!=(const Future &rhs) const noexcept { return !operator==(rhs); }
-    T &operator*() noexcept { return Get(); }
-    T &operator->() noexcept { return Get(); }
+    decltype(auto) operator*() const requires (!std::is_void_v<T>) { return Get(); }
+    auto operator->() const requires (!std::is_void_v<T>) { return &Get(); }
+
+private:
+    Future(shared_ptr<FutureState<T>> state) noexcept: mState(std::move(state)) {}
+
+    template<typename F>
+    static decltype(auto) Invoke(F &function, const FutureState<T> &state) {
+        if constexpr (std::is_void_v<T>) {
+            return function();
+        } else {
+            return function(std::as_const(*state.Value));
+        }
+    }
 
 private:
-    std::optional<T> mCurrent;
-    std::future<T> mFuture;
+    shared_ptr<FutureState<T>> mState;
 };
 
+///
+/// @brief Completes the promise with the result of the invocation, returned futures are forwarded when they complete.
+///
+template<typename Result, typename Value, typename Invoker>
+void Fulfill(Promise<Value> &promise, Invoker &&invoke) {
+    try {
+        if constexpr (IsFuture<Result>::value) {
+            auto inner = invoke();
+            if (!inner) throw std::runtime_error("Future: A continuation returned an empty future!");
+            inner.OnComplete([promise](const Result &inner) mutable {
+                if (auto error = inner.GetException()) {
+                    promise.SetException(error);
+                } else if constexpr (std::is_void_v<Value>) {
+                    promise.SetValue();
+                } else {
+                    promise.SetValue(inner.Get());
+                }
+            });
+        } else if constexpr (std::is_void_v<Result>) {
+            invoke();
+            promise.SetValue();
+        } else {
+            promise.SetValue(invoke());
+        }
+    } catch (...) {
+        promise.SetException(std::current_exception());
+    }
+}
+
+///
+/// @brief Runs the function on the chosen executor, it may accept a CancellationToken to stop early.
+///
+template<typename F>
+auto Async(F &&function, Launch launch = Launch::Worker) {
+    constexpr bool cancellable = std::is_invocable_v<F, const CancellationToken &>;
+    using Result = typename std::conditional_t<cancellable, std::invoke_result<F, const CancellationToken &>, std::invoke_result<F>>::type;
+    using Value = typename UnwrapFuture<Result>::Type;
+
+    Promise<Value> promise;
+    auto result = promise.GetFuture();
+    Schedule(launch, [promise, function = std::forward<F>(function)]() mutable {
+        if (promise.IsCancelled()) return;
+        Fulfill<Result>(promise, [&]() -> Result {
+            if constexpr (cancellable) {
+                return function(promise.GetToken());
+            } else {
+                return function();
+            }
+        });
+    });
+    return result;
+}
+
+///
+/// @brief Creates an already completed future.
+///
+template<typename T>
+Future<std::decay_t<T>> MakeReadyFuture(T &&value) {
+    Promise<std::decay_t<T>> promise;
+    promise.SetValue(std::forward<T>(value));
+    return promise.GetFuture();
+}
+inline Future<void> MakeReadyFuture() {
+    Promise<void> promise;
+    promise.SetValue();
+    return promise.GetFuture();
+}
+
+///
+/// @brief Completes with all values (in order) when every future succeeded, or with the first exception.
+///
+template<typename T>
+auto WhenAll(vector<Future<T>> futures) {
+    using Values = std::conditional_t<std::is_void_v<T>, void, vector<T>>;
+    struct Context {
+        Promise<Values> Result;
+        vector<Future<T>> Futures;
+        atomic<size_t> Remaining;
+    };
+
+    auto context = std::make_shared<Context>();
+    auto result = context->Result.GetFuture();
+    context->Futures = std::move(futures);
+    context->Remaining = context->Futures.size();
+    if (context->Futures.empty()) {
+        context->Result.SetValue();
+        return result;
+    }
+
+    for (const auto &future : context->Futures) {
+        future.OnComplete([context](const Future<T> &current) {
+            if (auto error = current.GetException()) {
+                context->Result.SetException(error);
+                return;
+            }
+            if (context->Remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            if constexpr (std::is_void_v<T>) {
+                context->Result.SetValue();
+            } else {
+                vector<T> values;
+                values.reserve(context->Futures.size());
+                for (const auto &future : context->Futures) values.push_back(future.Get());
+                context->Result.SetValue(std::move(values));
+            }
+        });
+    }
+    return result;
+}
+
+///
+/// @brief Completes with the index of the first future, which completed (successfully or not).
+///
+template<typename T>
+Future<size_t> WhenAny(const vector<Future<T>> &futures) {
+    Promise<size_t> promise;
+    auto result = promise.GetFuture();
+    if (futures.empty()) {
+        promise.SetException(std::make_exception_ptr(std::invalid_argument("Future: WhenAny needs at least one future!")));
+        return result;
+    }
+    for (size_t index = 0; index < futures.size(); index++) {
+        futures[index].OnComplete([promise, index](const Future<T> &) mutable { promise.SetValue(index); });
+    }
+    return result;
+}
+
 }
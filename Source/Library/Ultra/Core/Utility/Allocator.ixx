@@ -0,0 +1,355 @@
+﻿export module Ultra.Core.Allocator;
+
+import Ultra.Core;
+
+///
+/// @brief Memory resources for hot paths, which can be used with all 'std::pmr' containers and with the 'Allocator'
+/// template parameters of the Dispatcher and Signal (see 'pmr::Dispatcher' and 'pmr::Signal').
+///
+/// - LinearArena:    bump allocator, which releases everything at once
+/// - FrameAllocator: double-buffered linear arenas, the data of the last frame stays valid during the current frame
+/// - PoolResource:   fixed-size blocks with a free list
+/// - ScratchStack:   thread-local stack, which is rewound by a ScratchScope
+///
+/// @example
+/// std::pmr::vector<Vertex> vertices(FrameAllocator::Instance().GetResource());
+/// {
+///     ScratchScope scratch;
+///     std::pmr::string text(scratch.GetResource());
+/// }
+///
+
+export namespace Ultra {
+
+///
+/// @brief Linear Arena
+/// The offset is advanced atomically, so that multiple threads can allocate at once. Requests which don't fit are served
+/// by the upstream resource and released at the next reset, which also grows the arena to the required size.
+///
+class LinearArena: public std::pmr::memory_resource {
+    // Types
+    struct Overflow {
+        void *Memory;
+        size_t Size;
+        size_t Alignment;
+    };
+
+public:
+    // Constructors and Destructor
+    explicit LinearArena(size_t capacity, std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()):
+        mUpstream(upstream) {
+        Grow(capacity);
+    }
+    LinearArena(const LinearArena &) = delete;
+    LinearArena &operator=(const LinearArena &) = delete;
+    ~LinearArena() override {
+        Release();
+        if (mBuffer) mUpstream->deallocate(mBuffer, mCapacity, alignof(std::max_align_t));
+    }
+
+    // Methods
+    void Reset() {
+        auto required = mOffset.load(std::memory_order_relaxed) + mOverflowSize;
+        Release();
+        if (required > mCapacity) Grow(std::bit_ceil(required));
+        mPeak = std::max(mPeak, required);
+        mOffset.store(0, std::memory_order_relaxed);
+    }
+
+    // Accessors
+    size_t GetCapacity() const { return mCapacity; }
+    size_t GetUsed() const { return std::min(mOffset.load(std::memory_order_relaxed), mCapacity) + mOverflowSize; }
+    size_t GetPeak() const { return std::max(mPeak, GetUsed()); }
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        auto base = reinterpret_cast<uintptr_t>(mBuffer);
+        auto offset = mOffset.load(std::memory_order_relaxed);
+        size_t next {};
+        size_t aligned {};
+        do {
+            aligned = ((base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+            next = aligned + bytes;
+            if (next > mCapacity) return AllocateOverflow(bytes, alignment);
+        } while (!mOffset.compare_exchange_weak(offset, next, std::memory_order_relaxed));
+        return mBuffer + aligned;
+    }
+    void do_deallocate(void *, size_t, size_t) override {
+        // Everything is released at once with 'Reset'
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    void *AllocateOverflow(size_t bytes, size_t alignment) {
+        std::lock_guard<mutex> lock(mOverflowMutex);
+        auto *memory = mUpstream->allocate(bytes, alignment);
+        mOverflow.push_back({ memory, bytes, alignment });
+        mOverflowSize += bytes + alignment;
+        return memory;
+    }
+    void Grow(size_t capacity) {
+        if (mBuffer) mUpstream->deallocate(mBuffer, mCapacity, alignof(std::max_align_t));
+        mBuffer = static_cast<std::byte *>(mUpstream->allocate(capacity, alignof(std::max_align_t)));
+        mCapacity = capacity;
+    }
+    void Release() {
+        std::lock_guard<mutex> lock(mOverflowMutex);
+        for (const auto &block : mOverflow) mUpstream->deallocate(block.Memory, block.Size, block.Alignment);
+        mOverflow.clear();
+        mOverflowSize = 0;
+    }
+
+private:
+    // Properties
+    std::pmr::memory_resource *mUpstream;
+    std::byte *mBuffer {};
+    size_t mCapacity {};
+    size_t mPeak {};
+    atomic<size_t> mOffset {};
+
+    // Overflow
+    mutex mOverflowMutex;
+    vector<Overflow> mOverflow;
+    size_t mOverflowSize {};
+};
+
+///
+/// @brief Frame Allocator
+/// Two linear arenas, which are swapped at the frame boundary. Data created during a frame stays valid until the end of
+/// the next frame, which is enough for data that is still in flight (e.g. uploads or deferred events).
+///
+class FrameAllocator {
+public:
+    // Limits
+    static constexpr size_t DefaultCapacity = 4 * 1024 * 1024;
+
+    // Constructors and Destructor
+    FrameAllocator(size_t capacity = DefaultCapacity):
+        mArenas { CreateScope<LinearArena>(capacity), CreateScope<LinearArena>(capacity) } {
+    }
+    ~FrameAllocator() = default;
+
+    static FrameAllocator &Instance() {
+        static FrameAllocator instance;
+        return instance;
+    }
+
+    // Methods
+    /// Called by the application at the frame boundary, when no other thread allocates from the current arena
+    void NextFrame() {
+        auto next = mIndex.load(std::memory_order_relaxed) ^ 1u;
+        mArenas[next]->Reset();
+        mIndex.store(next, std::memory_order_release);
+    }
+
+    // Accessors
+    std::pmr::memory_resource *GetResource() { return mArenas[mIndex.load(std::memory_order_acquire)].get(); }
+    const LinearArena &GetArena() const { return *mArenas[mIndex.load(std::memory_order_acquire)]; }
+
+private:
+    array<Scope<LinearArena>, 2> mArenas;
+    atomic<uint32_t> mIndex {};
+};
+
+///
+/// @brief Pool Resource
+/// Fixed-size blocks, which are carved out of chunks and recycled through a free list. Requests that are larger than
+/// the block size (or stricter aligned) are forwarded to the upstream resource.
+///
+class PoolResource: public std::pmr::memory_resource {
+    // Types
+    struct Node {
+        Node *Next;
+    };
+
+public:
+    // Constructors and Destructor
+    explicit PoolResource(size_t blockSize, size_t blocksPerChunk = 256, std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()):
+        mBlockSize(std::bit_ceil(std::max(blockSize, sizeof(Node)))),
+        mBlocksPerChunk(std::max<size_t>(blocksPerChunk, 1)),
+        mUpstream(upstream) {
+    }
+    PoolResource(const PoolResource &) = delete;
+    PoolResource &operator=(const PoolResource &) = delete;
+    ~PoolResource() override {
+        for (auto *chunk : mChunks) mUpstream->deallocate(chunk, mBlockSize * mBlocksPerChunk, BlockAlignment());
+    }
+
+    // Accessors
+    size_t GetBlockSize() const { return mBlockSize; }
+    size_t GetUsedBlocks() const { return mUsed.load(std::memory_order_relaxed); }
+    size_t GetCapacity() const { return mChunks.size() * mBlocksPerChunk; }
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        if (bytes > mBlockSize || alignment > BlockAlignment()) return mUpstream->allocate(bytes, alignment);
+
+        std::lock_guard<mutex> lock(mMutex);
+        if (!mFree) AllocateChunk();
+        auto *node = mFree;
+        mFree = node->Next;
+        mUsed.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+    void do_deallocate(void *memory, size_t bytes, size_t alignment) override {
+        if (bytes > mBlockSize || alignment > BlockAlignment()) {
+            mUpstream->deallocate(memory, bytes, alignment);
+            return;
+        }
+
+        std::lock_guard<mutex> lock(mMutex);
+        auto *node = static_cast<Node *>(memory);
+        node->Next = mFree;
+        mFree = node;
+        mUsed.fetch_sub(1, std::memory_order_relaxed);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    size_t BlockAlignment() const {
+        return std::min(mBlockSize, alignof(std::max_align_t));
+    }
+    void AllocateChunk() {
+        auto *chunk = static_cast<std::byte *>(mUpstream->allocate(mBlockSize * mBlocksPerChunk, BlockAlignment()));
+        mChunks.push_back(chunk);
+        for (size_t index = mBlocksPerChunk; index-- > 0;) {
+            auto *node = reinterpret_cast<Node *>(chunk + index * mBlockSize);
+            node->Next = mFree;
+            mFree = node;
+        }
+    }
+
+private:
+    // Properties
+    size_t mBlockSize;
+    size_t mBlocksPerChunk;
+    std::pmr::memory_resource *mUpstream;
+
+    // States
+    mutex mMutex;
+    Node *mFree {};
+    vector<std::byte *> mChunks;
+    atomic<size_t> mUsed {};
+};
+
+///
+/// @brief Scratch Stack
+/// Thread-local stack for temporary data, allocations are released in LIFO order when the enclosing ScratchScope ends.
+/// Requests which exceed the capacity are served by the upstream resource and released with their scope.
+///
+class ScratchStack: public std::pmr::memory_resource {
+    // Types
+    struct Overflow {
+        void *Memory;
+        size_t Size;
+        size_t Alignment;
+    };
+
+public:
+    // Types
+    struct Marker {
+        size_t Offset;
+        size_t Overflows;
+    };
+
+    // Limits
+    static constexpr size_t DefaultCapacity = 1024 * 1024;
+
+    // Constructors and Destructor
+    explicit ScratchStack(size_t capacity = DefaultCapacity, std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()):
+        mUpstream(upstream),
+        mBuffer(static_cast<std::byte *>(upstream->allocate(capacity, alignof(std::max_align_t)))),
+        mCapacity(capacity) {
+        mOverflow.reserve(16);
+    }
+    ScratchStack(const ScratchStack &) = delete;
+    ScratchStack &operator=(const ScratchStack &) = delete;
+    ~ScratchStack() override {
+        Rewind({});
+        mUpstream->deallocate(mBuffer, mCapacity, alignof(std::max_align_t));
+    }
+
+    // Get the stack of the current thread
+    static ScratchStack &Local() {
+        thread_local ScratchStack stack;
+        return stack;
+    }
+
+    // Methods
+    Marker GetMarker() const { return { mOffset, mOverflow.size() }; }
+    void Rewind(const Marker &marker) {
+        while (mOverflow.size() > marker.Overflows) {
+            const auto &block = mOverflow.back();
+            mUpstream->deallocate(block.Memory, block.Size, block.Alignment);
+            mOverflow.pop_back();
+        }
+        mOffset = marker.Offset;
+    }
+
+    // Accessors
+    size_t GetCapacity() const { return mCapacity; }
+    size_t GetUsed() const { return mOffset; }
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        auto base = reinterpret_cast<uintptr_t>(mBuffer);
+        auto aligned = ((base + mOffset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+        if (aligned + bytes > mCapacity) {
+            auto *memory = mUpstream->allocate(bytes, alignment);
+            mOverflow.push_back({ memory, bytes, alignment });
+            return memory;
+        }
+        mOffset = aligned + bytes;
+        return mBuffer + aligned;
+    }
+    void do_deallocate(void *memory, size_t bytes, size_t) override {
+        // The most recent allocation can be released directly, everything else is released with its scope
+        if (static_cast<std::byte *>(memory) + bytes == mBuffer + mOffset) mOffset -= bytes;
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    std::pmr::memory_resource *mUpstream;
+    std::byte *mBuffer;
+    size_t mCapacity;
+    size_t mOffset {};
+    vector<Overflow> mOverflow;
+};
+
+///
+/// @brief Releases all scratch allocations of the current thread, which were made during the lifetime of the scope.
+///
+class ScratchScope {
+public:
+    ScratchScope(): mStack(ScratchStack::Local()), mMarker(mStack.GetMarker()) {}
+    ScratchScope(const ScratchScope &) = delete;
+    ScratchScope &operator=(const ScratchScope &) = delete;
+    ~ScratchScope() { mStack.Rewind(mMarker); }
+
+    std::pmr::memory_resource *GetResource() { return &mStack; }
+
+private:
+    ScratchStack &mStack;
+    ScratchStack::Marker mMarker;
+};
+
+///
+/// @brief Helpers
+///
+
+// Resource of the current frame
+inline std::pmr::memory_resource *FrameResource() {
+    return FrameAllocator::Instance().GetResource();
+}
+
+// Containers for per-frame data
+template<typename T>
+using FrameVector = std::pmr::vector<T>;
+
+}
@@ -7,6 +7,7 @@ export module Ultra.Core.Dispatcher;
 import Ultra.Core.Signal;
 
 import <entt/entt.hpp>;
+import <memory_resource>;
 
 namespace {
 
@@ -27,9 +28,9 @@ class dispatcher_handler final: public basic_dispatcher_handler {
     using container_type = std::vector<Type, typename alloc_traits::template rebind_alloc<Type>>;
 
 public:
-    using allocator_type = Allocator;
-
-    dispatcher_handler(const allocator_type &allocator)
+    // No 'allocator_type' on purpose, otherwise allocators with uses-allocator construction (std::pmr) would pass the
+    // allocator a second time when the handler is created with 'std::allocate_shared'.
+    dispatcher_handler(const Allocator &allocator)
         : signal { allocator },
         events { allocator } {
     }
@@ -379,6 +380,13 @@ class BasicDispatcher;
 /// @brief Alias declaration for the most common use case.
 using Dispatcher = BasicDispatcher<>;
 
+namespace pmr {
+
+/// @brief Dispatcher, which takes its memory from a memory resource (e.g. the FrameAllocator or a PoolResource).
+using Dispatcher = BasicDispatcher<std::pmr::polymorphic_allocator<>>;
+
+}
+
 
 // ToDo: Merge
 
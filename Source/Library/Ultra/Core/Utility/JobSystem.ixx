@@ -0,0 +1,392 @@
+﻿export module Ultra.Core.JobSystem;
+
+import Ultra.Core;
+
+///
+/// @brief Work-stealing job system, the successor of the ThreadPool for fine-grained work.
+/// Every worker owns a lock-free deque (Chase-Lev) and a ring of preallocated jobs, idle workers steal from the others.
+/// Small callables are stored inline in the job, so scheduling doesn't touch the heap.
+///
+/// @example
+/// auto &jobs = JobSystem::Instance();
+/// auto *root = jobs.CreateJob([] {});
+/// for (auto i = 0; i < 4; i++) jobs.Run(jobs.CreateChildJob(root, [i] { Work(i); }));
+/// jobs.Run(root);
+/// jobs.Wait(root);
+///
+/// @note Jobs are recycled from a per-thread ring with 'MaxJobCount' entries, slots of unfinished jobs are skipped, so a
+/// thread can't have more unfinished jobs at once. Long running tasks belong on a thread pool (see 'Launch::Worker').
+/// Dependencies have to be wired up before the ancestor is passed to 'Run'.
+///
+
+export namespace Ultra {
+
+///
+/// @brief A job holds its callable inline, a parent for fork/join and continuations as dependency graph.
+///
+struct alignas(64) Job {
+    // Types
+    using Function = void(*)(Job &);
+
+    // Limits
+    static constexpr size_t MaxContinuations = 4;
+    static constexpr size_t StorageSize = 64;
+
+    // Properties
+    Function Invoke {};
+    Job *Parent {};
+    atomic<int32_t> UnfinishedJobs {};      // The job itself and all of its unfinished children
+    atomic<int32_t> Dependencies {};        // Unfinished ancestors plus one for the 'Run' call
+    atomic<uint32_t> ContinuationCount {};
+    array<Job *, MaxContinuations> Continuations {};
+    alignas(std::max_align_t) std::byte Storage[StorageSize] {};
+};
+
+///
+/// @brief Lock-free single-producer multi-consumer deque, the owner pushes and pops at the bottom, thieves steal from the top.
+///
+class WorkStealingQueue {
+public:
+    static constexpr int64_t Capacity = 4096;
+    static constexpr int64_t Mask = Capacity - 1;
+
+    WorkStealingQueue() = default;
+    ~WorkStealingQueue() = default;
+
+    // Owner
+    bool Push(Job *job) {
+        auto bottom = mBottom.load(std::memory_order_relaxed);
+        auto top = mTop.load(std::memory_order_acquire);
+        if (bottom - top >= Capacity) return false;
+
+        mJobs[bottom & Mask].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+    Job *Pop() {
+        auto bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = mTop.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto *job = mJobs[bottom & Mask].load(std::memory_order_relaxed);
+        if (top != bottom) return job;
+
+        // Last job in the queue, race against the thieves
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return job;
+    }
+
+    // Thieves
+    Job *Steal() {
+        auto top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto bottom = mBottom.load(std::memory_order_acquire);
+        if (top >= bottom) return nullptr;
+
+        auto *job = mJobs[top & Mask].load(std::memory_order_relaxed);
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+        return job;
+    }
+
+    // Accessors
+    bool Empty() const {
+        return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+    }
+
+private:
+    alignas(64) atomic<int64_t> mTop {};
+    alignas(64) atomic<int64_t> mBottom {};
+    array<atomic<Job *>, Capacity> mJobs {};
+};
+
+///
+/// @brief Work-Stealing Job System
+///
+class JobSystem {
+public:
+    // Limits
+    static constexpr uint32_t MaxJobCount = 4096;
+
+private:
+    // Types
+    struct alignas(64) Worker {
+        WorkStealingQueue Queue;
+        array<Job, MaxJobCount> Jobs;
+        uint32_t Allocated {};
+    };
+
+public:
+    // Constructors and Destructor
+    JobSystem(size_t threads = std::max(thread::hardware_concurrency(), 2u) - 1) {
+        // Slot 0 belongs to the creating thread, the last slot is shared by all unregistered threads.
+        // A thread participates in one system only, so a local system doesn't take the thread away from the global one.
+        mWorkerCount = static_cast<uint32_t>(threads) + 1;
+        for (uint32_t i = 0; i <= mWorkerCount; i++) {
+            mWorkers.emplace_back(CreateScope<Worker>());
+        }
+        if (!sOwner) {
+            sOwner = this;
+            sWorkerIndex = 0;
+        }
+
+        mRunning = true;
+        for (uint32_t i = 1; i < mWorkerCount; i++) {
+            mThreads.emplace_back([this, i] {
+                sOwner = this;
+                sWorkerIndex = i;
+                Loop();
+            });
+        }
+    }
+    ~JobSystem() {
+        mRunning = false;
+        mSignal.fetch_add(1, std::memory_order_seq_cst);
+        mSignal.notify_all();
+        for (auto &thread : mThreads) thread.join();
+        if (sOwner == this) {
+            sOwner = nullptr;
+            sWorkerIndex = 0;
+        }
+    }
+
+    // Get the engine-wide instance
+    static JobSystem &Instance() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    ///
+    /// @brief Creates a job from a callable, which must fit into the inline storage.
+    ///
+    template<typename F>
+    Job *CreateJob(F &&function) {
+        return CreateChildJob(nullptr, std::forward<F>(function));
+    }
+
+    ///
+    /// @brief Creates a job, which has to finish before its parent counts as finished.
+    ///
+    template<typename F>
+    Job *CreateChildJob(Job *parent, F &&function) {
+        using Callable = std::decay_t<F>;
+        static_assert(sizeof(Callable) <= Job::StorageSize, "JobSystem: The callable exceeds the inline job storage!");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "JobSystem: The callable is over-aligned!");
+
+        auto *job = Allocate();
+        job->Invoke = [](Job &job) {
+            auto *callable = std::launder(reinterpret_cast<Callable *>(job.Storage));
+            (*callable)();
+            std::destroy_at(callable);
+        };
+        job->Parent = parent;
+        job->UnfinishedJobs.store(1, std::memory_order_relaxed);
+        job->Dependencies.store(1, std::memory_order_relaxed);
+        job->ContinuationCount.store(0, std::memory_order_relaxed);
+        new (job->Storage) Callable(std::forward<F>(function));
+
+        if (parent) parent->UnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    ///
+    /// @brief Schedules the continuation when the ancestor finished, the continuation still has to be passed to 'Run'.
+    ///
+    void AddContinuation(Job *ancestor, Job *continuation) {
+        auto index = ancestor->ContinuationCount.fetch_add(1, std::memory_order_relaxed);
+        if (index >= Job::MaxContinuations) throw std::runtime_error("JobSystem: Too many continuations for a single job!");
+
+        continuation->Dependencies.fetch_add(1, std::memory_order_relaxed);
+        ancestor->Continuations[index] = continuation;
+    }
+
+    ///
+    /// @brief Releases the job, it gets executed as soon as all of its dependencies are finished.
+    ///
+    void Run(Job *job) {
+        if (job->Dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) Submit(job);
+    }
+
+    ///
+    /// @brief Executes other jobs until the job and all of its children are finished, so the calling thread never blocks.
+    ///
+    void Wait(const Job *job) {
+        while (!IsFinished(job)) {
+            if (auto *next = GetJob()) {
+                Execute(next);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    ///
+    /// @brief Executes a single pending job if there is one, used by threads which have to wait for other work.
+    ///
+    bool TryExecute() {
+        if (auto *job = GetJob()) {
+            Execute(job);
+            return true;
+        }
+        return false;
+    }
+
+    ///
+    /// @brief Splits [0, count) into chunks of 'grain' elements and processes them in parallel, the function receives (begin, end).
+    ///
+    template<typename F>
+    void ParallelFor(size_t count, size_t grain, F &&function) {
+        if (count == 0) return;
+        // Keep the number of chunks well below the job ring capacity
+        grain = std::max({ grain, size_t(1), (count + MaxJobCount / 4 - 1) / (MaxJobCount / 4) });
+
+        auto *root = CreateJob([] {});
+        for (size_t begin = 0; begin < count; begin += grain) {
+            auto end = std::min(begin + grain, count);
+            Run(CreateChildJob(root, [&function, begin, end] { function(begin, end); }));
+        }
+        Run(root);
+        Wait(root);
+    }
+    template<typename F>
+    void ParallelFor(size_t count, F &&function) {
+        ParallelFor(count, count / (static_cast<size_t>(mWorkerCount) * 4), std::forward<F>(function));
+    }
+
+    // Accessors
+    bool IsFinished(const Job *job) const {
+        return job->UnfinishedJobs.load(std::memory_order_acquire) == 0;
+    }
+    uint32_t GetWorkerCount() const {
+        return mWorkerCount;
+    }
+
+private:
+    // Methods
+    Worker &GetWorker() {
+        if (sOwner == this) return *mWorkers[sWorkerIndex];
+        return *mWorkers[mWorkerCount];
+    }
+
+    Job *Allocate() {
+        if (sOwner == this) return Allocate(*mWorkers[sWorkerIndex]);
+        std::lock_guard<mutex> lock(mExternalMutex);
+        return Allocate(*mWorkers[mWorkerCount]);
+    }
+
+    Job *Allocate(Worker &worker) {
+        // Jobs, which are still running or waiting, are skipped instead of being overwritten
+        for (uint32_t i = 0; i < MaxJobCount; i++) {
+            auto *job = &worker.Jobs[worker.Allocated++ & (MaxJobCount - 1)];
+            if (job->UnfinishedJobs.load(std::memory_order_acquire) == 0) return job;
+        }
+        throw std::runtime_error("JobSystem: All jobs of the thread are unfinished, the ring is exhausted!");
+    }
+
+    void Submit(Job *job) {
+        bool pushed {};
+        if (sOwner == this) {
+            pushed = mWorkers[sWorkerIndex]->Queue.Push(job);
+        } else {
+            std::lock_guard<mutex> lock(mExternalMutex);
+            pushed = mWorkers[mWorkerCount]->Queue.Push(job);
+        }
+        if (!pushed) {
+            // The queue is full, so there is enough work for everyone, just execute it.
+            Execute(job);
+            return;
+        }
+
+        mSignal.fetch_add(1, std::memory_order_seq_cst);
+        if (mSleeping.load(std::memory_order_seq_cst) > 0) mSignal.notify_one();
+    }
+
+    Job *GetJob() {
+        if (sOwner == this) {
+            if (auto *job = mWorkers[sWorkerIndex]->Queue.Pop()) return job;
+        }
+
+        // Steal from a random victim, then sweep all others
+        auto &worker = GetWorker();
+        sSeed ^= sSeed << 13;
+        sSeed ^= sSeed >> 17;
+        sSeed ^= sSeed << 5;
+        auto count = mWorkerCount + 1;
+        auto start = sSeed % count;
+        for (uint32_t i = 0; i < count; i++) {
+            auto &victim = *mWorkers[(start + i) % count];
+            if (&victim == &worker && sOwner == this) continue;
+            if (auto *job = victim.Queue.Steal()) return job;
+        }
+        return nullptr;
+    }
+
+    void Execute(Job *job) {
+        job->Invoke(*job);
+        Finish(job);
+    }
+
+    void Finish(Job *job) {
+        if (job->UnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+        auto continuations = std::min<uint32_t>(job->ContinuationCount.load(std::memory_order_acquire), Job::MaxContinuations);
+        for (uint32_t i = 0; i < continuations; i++) Run(job->Continuations[i]);
+        if (job->Parent) Finish(job->Parent);
+    }
+
+    void Loop() {
+        while (mRunning.load(std::memory_order_relaxed)) {
+            if (auto *job = GetJob()) {
+                Execute(job);
+                continue;
+            }
+
+            // Spin shortly, then sleep until new work is submitted
+            bool found {};
+            for (auto i = 0; i < 64 && !found; i++) {
+                std::this_thread::yield();
+                if (auto *job = GetJob()) {
+                    Execute(job);
+                    found = true;
+                }
+            }
+            if (found) continue;
+
+            mSleeping.fetch_add(1, std::memory_order_seq_cst);
+            auto signal = mSignal.load(std::memory_order_seq_cst);
+            if (auto *job = GetJob()) {
+                mSleeping.fetch_sub(1, std::memory_order_relaxed);
+                Execute(job);
+                continue;
+            }
+            if (mRunning.load(std::memory_order_relaxed)) mSignal.wait(signal, std::memory_order_seq_cst);
+            mSleeping.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // Workers
+    uint32_t mWorkerCount {};
+    vector<Scope<Worker>> mWorkers;
+    vector<thread> mThreads;
+
+    // Synchronization
+    atomic<bool> mRunning {};
+    atomic<uint32_t> mSignal {};
+    atomic<uint32_t> mSleeping {};
+    mutex mExternalMutex;
+
+    // Thread Registration
+    static inline thread_local JobSystem *sOwner = nullptr;
+    static inline thread_local uint32_t sWorkerIndex = 0;
+    static inline thread_local uint32_t sSeed = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1u;
+};
+
+}
@@ -10,6 +10,7 @@ export namespace Ultra {
 /// @note The functions and utilities here are useful for creating random data within the application.
 ///
 class Random {
+public:
     static void Load() {
         sRandomEngine.seed(std::random_device()());
     }
@@ -7,6 +7,7 @@ export module Ultra.Core.Signal;
 import Ultra.Core.Delegate;
 
 import <entt/entt.hpp>;
+import <memory_resource>;
 
 export namespace Ultra {
 
@@ -567,5 +568,12 @@ class Sink;
 template<typename Type, typename = std::allocator<void>>
 class Signal;
 
+namespace pmr {
+
+/// @brief Signal, which takes its memory from a memory resource (e.g. the FrameAllocator or a PoolResource).
+template<typename Type>
+using Signal = Ultra::Signal<Type, std::pmr::polymorphic_allocator<>>;
+
+}
 
 }
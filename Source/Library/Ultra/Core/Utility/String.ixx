@@ -74,6 +74,29 @@ public:
             return (c >= '0' && c <= '7');
         });
     }
+    // Escapes quotes, backslashes and control characters, so that the value can be written into a JSON string
+    static string EscapeJson(string_view value) {
+        string result;
+        result.reserve(value.size());
+        for (auto character : value) {
+            switch (character) {
+                case '"':   { result += "\\\""; break; }
+                case '\\':  { result += "\\\\"; break; }
+                case '\n':  { result += "\\n"; break; }
+                case '\r':  { result += "\\r"; break; }
+                case '\t':  { result += "\\t"; break; }
+                default: {
+                    if (static_cast<unsigned char>(character) < 0x20) {
+                        result += std::format("\\u{:04x}", static_cast<unsigned char>(character));
+                        break;
+                    }
+                    result += character;
+                    break;
+                }
+            }
+        }
+        return result;
+    }
     static string Join(const vector<string> &values, char separator) {
         std::string result;
         for (auto it = values.begin(); it != values.end(); ++it) {
@@ -118,6 +141,19 @@ public:
         }
         return tokens;
     }
+    // Splits without copying, the tokens reference 'value' and the container uses the resource (e.g. FrameResource())
+    static std::pmr::vector<string_view> Split(string_view value, char seperator, std::pmr::memory_resource *resource) noexcept {
+        std::pmr::vector<string_view> tokens(resource);
+        size_t start {};
+        while (start <= value.size()) {
+            auto end = value.find(seperator, start);
+            if (end == string_view::npos) end = value.size();
+            if (end == value.size() && start == end) break;
+            tokens.emplace_back(value.substr(start, end - start));
+            start = end + 1;
+        }
+        return tokens;
+    }
     template<typename T> // ToDo: Concept doesn't work as expected after 16.10 Preview 2
     static T &ToLower(T &value) noexcept {
         std::transform(value.begin(), value.end(), value.begin(), ::tolower);
@@ -0,0 +1,324 @@
+﻿export module Ultra.Core.TaskGraph;
+
+import Ultra.Core;
+import Ultra.Core.JobSystem;
+
+///
+/// @brief Declarative per-frame task graph, which is executed on the JobSystem.
+/// Nodes declare the resources they read and write, the edges are derived in declaration order (read after write,
+/// write after read and write after write). Nodes with main-thread affinity are executed by the thread calling 'Execute',
+/// which also helps with the other jobs, so the end of 'Execute' is the join point of the frame.
+///
+/// @example
+/// TaskGraph graph;
+/// graph.Add("Physics", [](Timestamp deltaTime) { ... }).Write("Transforms");
+/// graph.Add("Animation", [](Timestamp deltaTime) { ... }).Write("Poses");
+/// graph.Add("Renderer", [](Timestamp deltaTime) { ... }).Read("Transforms").Read("Poses").Affinity(TaskAffinity::MainThread);
+/// graph.Compile();
+/// graph.Execute(deltaTime);
+///
+
+export namespace Ultra {
+
+///
+/// @brief Determines which threads are allowed to execute a task.
+///
+enum class TaskAffinity: uint8_t {
+    Any,
+    MainThread,
+};
+
+///
+/// @brief Node in the task graph with its declared resource accesses and the measurements of the last frame.
+///
+class TaskNode {
+    friend class TaskGraph;
+
+public:
+    // Types
+    using Task = function<void(Timestamp)>;
+
+    // Constructors and Destructor
+    TaskNode(const string &name, Task task): mName(name), mTask(std::move(task)) {}
+    ~TaskNode() = default;
+
+    // Declarations
+    TaskNode &Read(string_view resource) { mReads.emplace_back(resource); return *this; }
+    TaskNode &Write(string_view resource) { mWrites.emplace_back(resource); return *this; }
+    TaskNode &After(string_view node) { mAfter.emplace_back(node); return *this; }
+    TaskNode &Affinity(TaskAffinity affinity) { mAffinity = affinity; return *this; }
+
+    // Accessors
+    const string &GetName() const { return mName; }
+    TaskAffinity GetAffinity() const { return mAffinity; }
+    const vector<string> &GetReads() const { return mReads; }
+    const vector<string> &GetWrites() const { return mWrites; }
+    const vector<size_t> &GetPredecessors() const { return mPredecessors; }
+    const vector<size_t> &GetSuccessors() const { return mSuccessors; }
+    /// Start time relative to the frame start in ms
+    double GetStartTime() const { return mStartTime; }
+    /// Duration of the last execution in ms
+    double GetDuration() const { return mDuration; }
+
+private:
+    // Properties
+    string mName;
+    Task mTask;
+    TaskAffinity mAffinity { TaskAffinity::Any };
+    vector<string> mReads;
+    vector<string> mWrites;
+    vector<string> mAfter;
+
+    // Graph
+    vector<size_t> mPredecessors;
+    vector<size_t> mSuccessors;
+    atomic<uint32_t> mPending {};
+
+    // Measurements
+    double mStartTime {};
+    double mDuration {};
+};
+
+///
+/// @brief Task Graph
+///
+class TaskGraph {
+    // Types
+    using Clock = std::chrono::steady_clock;
+
+public:
+    struct Statistics {
+        double FrameTime {};            // Wall time of the whole graph in ms
+        double CriticalPath {};         // Longest dependency chain of the last frame in ms
+        double WorkTime {};             // Sum of all node durations in ms
+        vector<size_t> CriticalNodes;   // Node indices along the critical path
+    };
+
+    // Constructors and Destructor
+    TaskGraph() = default;
+    ~TaskGraph() = default;
+
+    // Methods
+    TaskNode &Add(const string &name, TaskNode::Task task) {
+        mCompiled = false;
+        return *mNodes.emplace_back(CreateScope<TaskNode>(name, std::move(task)));
+    }
+    void Clear() {
+        mNodes.clear();
+        mOrder.clear();
+        mStatistics = {};
+        mCompiled = false;
+    }
+
+    ///
+    /// @brief Derives the edges from the declared accesses and validates the graph.
+    ///
+    void Compile() {
+        struct Access {
+            size_t Writer = npos;
+            vector<size_t> Readers;
+        };
+        unordered_map<string, Access> accesses;
+
+        auto connect = [&](size_t from, size_t to) {
+            if (from == npos || from == to) return;
+            auto &successors = mNodes[from]->mSuccessors;
+            if (std::find(successors.begin(), successors.end(), to) != successors.end()) return;
+            successors.push_back(to);
+            mNodes[to]->mPredecessors.push_back(from);
+        };
+
+        for (auto &node : mNodes) {
+            node->mPredecessors.clear();
+            node->mSuccessors.clear();
+        }
+        for (size_t index = 0; index < mNodes.size(); index++) {
+            auto &node = *mNodes[index];
+            for (const auto &resource : node.mReads) {
+                auto &access = accesses[resource];
+                connect(access.Writer, index);
+                access.Readers.push_back(index);
+            }
+            for (const auto &resource : node.mWrites) {
+                auto &access = accesses[resource];
+                connect(access.Writer, index);
+                for (auto reader : access.Readers) connect(reader, index);
+                access.Writer = index;
+                access.Readers.clear();
+            }
+        }
+        for (size_t index = 0; index < mNodes.size(); index++) {
+            for (const auto &name : mNodes[index]->mAfter) {
+                auto found = false;
+                for (size_t other = 0; other < mNodes.size(); other++) {
+                    if (mNodes[other]->mName == name) {
+                        connect(other, index);
+                        found = true;
+                    }
+                }
+                if (!found) throw std::runtime_error(std::format("TaskGraph: Node '{}' depends on unknown node '{}'!", mNodes[index]->mName, name));
+            }
+        }
+
+        // Topological order, which is also used for the critical path
+        mOrder.clear();
+        vector<size_t> pending(mNodes.size());
+        for (size_t index = 0; index < mNodes.size(); index++) {
+            pending[index] = mNodes[index]->mPredecessors.size();
+            if (!pending[index]) mOrder.push_back(index);
+        }
+        for (size_t i = 0; i < mOrder.size(); i++) {
+            for (auto successor : mNodes[mOrder[i]]->mSuccessors) {
+                if (--pending[successor] == 0) mOrder.push_back(successor);
+            }
+        }
+        if (mOrder.size() != mNodes.size()) throw std::runtime_error("TaskGraph: The graph contains a cycle!");
+
+        mCompiled = true;
+    }
+
+    ///
+    /// @brief Executes all nodes and returns when the whole graph is finished.
+    /// @note A node which throws still counts as finished, so the graph drains, the first exception is rethrown afterwards.
+    ///
+    void Execute(Timestamp deltaTime, JobSystem &jobs = JobSystem::Instance()) {
+        if (!mCompiled) Compile();
+        if (mNodes.empty()) return;
+
+        mError = nullptr;
+        mDeltaTime = deltaTime;
+        mJobs = &jobs;
+        mFrameStart = Clock::now();
+        mRemaining.store(static_cast<uint32_t>(mNodes.size()), std::memory_order_relaxed);
+        for (auto &node : mNodes) node->mPending.store(static_cast<uint32_t>(node->mPredecessors.size()), std::memory_order_relaxed);
+        for (auto &node : mNodes) {
+            if (node->mPredecessors.empty()) Dispatch(node.get());
+        }
+
+        // Join: execute main-thread nodes and help the workers until everything is done
+        while (mRemaining.load(std::memory_order_acquire) > 0) {
+            if (auto *node = PopMainThreadNode()) {
+                Process(node);
+            } else if (!jobs.TryExecute()) {
+                std::this_thread::yield();
+            }
+        }
+
+        UpdateStatistics(std::chrono::duration<double, std::milli>(Clock::now() - mFrameStart).count());
+        if (mError) std::rethrow_exception(std::exchange(mError, nullptr));
+    }
+
+    // Accessors
+    const vector<Scope<TaskNode>> &GetNodes() const { return mNodes; }
+    const vector<size_t> &GetExecutionOrder() const { return mOrder; }
+    const Statistics &GetStatistics() const { return mStatistics; }
+
+    ///
+    /// @brief Exports the graph in the Graphviz dot format, the critical path is highlighted.
+    ///
+    string ToDot() const {
+        string result = "digraph TaskGraph {\n    node [shape=box];\n";
+        for (size_t index = 0; index < mNodes.size(); index++) {
+            auto &node = *mNodes[index];
+            auto critical = std::find(mStatistics.CriticalNodes.begin(), mStatistics.CriticalNodes.end(), index) != mStatistics.CriticalNodes.end();
+            result += std::format("    n{} [label=\"{}\\n{:.3f} ms{}\"{}];\n",
+                index, node.mName, node.mDuration,
+                node.mAffinity == TaskAffinity::MainThread ? "\\n[main]" : "",
+                critical ? " color=red" : ""
+            );
+            for (auto successor : node.mSuccessors) result += std::format("    n{} -> n{};\n", index, successor);
+        }
+        result += "}\n";
+        return result;
+    }
+
+private:
+    // Methods
+    void Dispatch(TaskNode *node) {
+        if (node->mAffinity == TaskAffinity::MainThread) {
+            std::lock_guard<mutex> lock(mMainThreadMutex);
+            mMainThreadNodes.push_back(node);
+            return;
+        }
+        mJobs->Run(mJobs->CreateJob([this, node] { Process(node); }));
+    }
+
+    void Process(TaskNode *node) {
+        auto start = Clock::now();
+        try {
+            node->mTask(mDeltaTime);
+        } catch (...) {
+            std::lock_guard<mutex> lock(mErrorMutex);
+            if (!mError) mError = std::current_exception();
+        }
+        auto finish = Clock::now();
+        node->mStartTime = std::chrono::duration<double, std::milli>(start - mFrameStart).count();
+        node->mDuration = std::chrono::duration<double, std::milli>(finish - start).count();
+
+        for (auto successor : node->mSuccessors) {
+            auto *next = mNodes[successor].get();
+            if (next->mPending.fetch_sub(1, std::memory_order_acq_rel) == 1) Dispatch(next);
+        }
+        mRemaining.fetch_sub(1, std::memory_order_release);
+    }
+
+    TaskNode *PopMainThreadNode() {
+        std::lock_guard<mutex> lock(mMainThreadMutex);
+        if (mMainThreadNodes.empty()) return nullptr;
+        auto *node = mMainThreadNodes.back();
+        mMainThreadNodes.pop_back();
+        return node;
+    }
+
+    void UpdateStatistics(double frameTime) {
+        vector<double> finish(mNodes.size());
+        vector<size_t> previous(mNodes.size(), npos);
+        auto last = npos;
+
+        mStatistics.FrameTime = frameTime;
+        mStatistics.CriticalPath = 0.0;
+        mStatistics.WorkTime = 0.0;
+        for (auto index : mOrder) {
+            auto &node = *mNodes[index];
+            auto start = 0.0;
+            for (auto predecessor : node.mPredecessors) {
+                if (finish[predecessor] > start) {
+                    start = finish[predecessor];
+                    previous[index] = predecessor;
+                }
+            }
+            finish[index] = start + node.mDuration;
+            mStatistics.WorkTime += node.mDuration;
+            if (last == npos || finish[index] > mStatistics.CriticalPath) {
+                mStatistics.CriticalPath = finish[index];
+                last = index;
+            }
+        }
+
+        mStatistics.CriticalNodes.clear();
+        for (auto index = last; index != npos; index = previous[index]) mStatistics.CriticalNodes.push_back(index);
+        std::reverse(mStatistics.CriticalNodes.begin(), mStatistics.CriticalNodes.end());
+    }
+
+private:
+    // Constants
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Properties
+    vector<Scope<TaskNode>> mNodes;
+    vector<size_t> mOrder;
+    Statistics mStatistics;
+    bool mCompiled {};
+
+    // Frame
+    Timestamp mDeltaTime {};
+    JobSystem *mJobs {};
+    Clock::time_point mFrameStart {};
+    atomic<uint32_t> mRemaining {};
+    mutex mMainThreadMutex;
+    vector<TaskNode *> mMainThreadNodes;
+    mutex mErrorMutex;
+    std::exception_ptr mError;
+};
+
+}
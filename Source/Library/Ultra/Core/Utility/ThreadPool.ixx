@@ -4,6 +4,10 @@ import Ultra.Core;
 
 export namespace Ultra {
 
+///
+/// @brief Simple thread pool with a shared task queue, suited for long running tasks.
+/// @note For many small tasks use the JobSystem, which avoids the shared lock and the allocations.
+///
 class ThreadPool {
 public:
     ThreadPool(size_t threads = thread::hardware_concurrency()): mStop(false) {
@@ -1,4 +1,12 @@
-﻿export module Ultra.Core.Timer;
+﻿module;
+
+#include "Ultra/Core/Platform.h"
+
+export module Ultra.Core.Timer;
+
+#if defined(APP_PLATFORM_WINDOWS)
+    import <Windows.h>;
+#endif
 
 import Ultra.Core.Types;
 
@@ -60,4 +68,95 @@ private:
     std::chrono::time_point<std::chrono::steady_clock> mStartTime;
 };
 
+///
+/// @brief FrameLimiter: Paces a loop to a target rate by sleeping until the next frame is due, instead of spinning.
+/// @note  The OS sleep is only trusted up to a small margin before the deadline, the remainder is yielded away.
+///        On Windows a high-resolution waitable timer is used, as the default scheduler tick is about 15.6ms.
+///
+/// @example
+/// FrameLimiter limiter(60);
+/// while (running) {
+///     Update();
+///     limiter.Wait();
+/// }
+///
+class FrameLimiter {
+    // Types
+    using Clock = std::chrono::steady_clock;
+
+public:
+    // Default
+    FrameLimiter(uint32_t rate = 0) {
+    #if defined(APP_PLATFORM_WINDOWS)
+        mTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    #endif
+        SetLimit(rate);
+    }
+    ~FrameLimiter() {
+    #if defined(APP_PLATFORM_WINDOWS)
+        if (mTimer) CloseHandle(mTimer);
+    #endif
+    }
+    FrameLimiter(const FrameLimiter &) = delete;
+    FrameLimiter &operator=(const FrameLimiter &) = delete;
+
+    // Accessors
+    /// Retrieve the target rate in frames per second (0 = unlimited)
+    inline const uint32_t GetLimit() const { return mRate; }
+
+    // Mutators
+    /// Set the target rate in frames per second (0 = unlimited)
+    inline void SetLimit(uint32_t rate) {
+        mRate = rate;
+        mPeriod = rate ? std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / rate : Clock::duration::zero();
+        mDeadline = Clock::now() + mPeriod;
+    }
+
+    // Methods
+    /// Blocks until the next frame is due and returns the time spent waiting in ms
+    float Wait() {
+        if (!mRate) return 0.0f;
+
+        auto start = Clock::now();
+        if (start < mDeadline) {
+            auto remaining = mDeadline - start;
+            if (remaining > sSpinMargin) Sleep(remaining - sSpinMargin);
+            while (Clock::now() < mDeadline) std::this_thread::yield();
+        }
+
+        // The next deadline continues from the last one, so that the rate doesn't drift, but after a hitch the limiter doesn't try to catch up.
+        auto now = Clock::now();
+        mDeadline += mPeriod;
+        if (mDeadline < now) mDeadline = now + mPeriod;
+        return std::chrono::duration<float, std::milli>(now - start).count();
+    }
+
+private:
+    // Methods
+    void Sleep(Clock::duration duration) {
+    #if defined(APP_PLATFORM_WINDOWS)
+        if (mTimer) {
+            // Relative due times are negative and measured in 100ns intervals
+            LARGE_INTEGER due {};
+            due.QuadPart = -static_cast<LONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 100);
+            if (SetWaitableTimerEx(mTimer, &due, 0, nullptr, nullptr, nullptr, 0)) {
+                WaitForSingleObject(mTimer, INFINITE);
+                return;
+            }
+        }
+    #endif
+        std::this_thread::sleep_for(duration);
+    }
+
+private:
+    // Properties
+    static constexpr std::chrono::microseconds sSpinMargin { 500 };
+    Clock::duration mPeriod {};
+    Clock::time_point mDeadline {};
+    uint32_t mRate {};
+#if defined(APP_PLATFORM_WINDOWS)
+    HANDLE mTimer {};
+#endif
+};
+
 }
@@ -0,0 +1,370 @@
+﻿export module Ultra.Debug.Benchmark;
+
+import Ultra.Core;
+import Ultra.Core.String;
+import Ultra.Debug.Memory;
+import Ultra.Logger;
+
+///
+/// @brief: Frame benchmark, which records the CPU time and the allocations of every frame and summarizes them as percentiles.
+/// @note:  The samples are stored in a preallocated vector, so that the recording doesn't allocate during the measured frames.
+///         Statistics use the nearest-rank method, the first 'warmup' frames are discarded.
+///
+/// @example
+/// Debug::FrameBenchmark benchmark("Scene", 1000, 60);
+/// while (!benchmark.IsFinished()) {
+///     benchmark.BeginFrame();
+///     ...
+///     benchmark.EndFrame();
+/// }
+/// benchmark.Save("Benchmark.json");
+///
+
+export namespace Ultra::Debug {
+
+///
+/// @brief Prevents the compiler from discarding a value, which is computed only for measurement.
+///
+template<typename T>
+inline void DoNotOptimize(const T &value) {
+    if constexpr (std::is_scalar_v<T>) {
+        static thread_local volatile T sSink {};
+        sSink = value;
+    } else {
+        static thread_local const void *volatile sSink {};
+        sSink = &value;
+    }
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+///
+/// @brief Summary of a sample set (in the unit of the samples)
+///
+struct BenchmarkStatistics {
+    size_t Samples {};
+    double Min {};
+    double Mean {};
+    double Median {};
+    double MAD {};      // Median absolute deviation
+    double P95 {};
+    double P99 {};
+    double Max {};
+};
+
+struct FrameSample {
+    double Time {};             // CPU time in ms
+    int64_t Allocations {};     // Heap allocations
+    int64_t Bytes {};           // Allocated bytes
+};
+
+struct HistogramBucket {
+    double Limit {};            // Upper bound in ms (inclusive)
+    size_t Count {};
+};
+
+///
+/// @brief Summarizes the samples, they are passed by value as the percentiles reorder them.
+///
+BenchmarkStatistics Summarize(vector<double> samples) {
+    BenchmarkStatistics statistics { samples.size() };
+    if (samples.empty()) return statistics;
+
+    auto rank = [&](double percentile) {
+        auto index = static_cast<size_t>(std::ceil(percentile / 100.0 * samples.size()));
+        return samples[std::clamp<size_t>(index, 1, samples.size()) - 1];
+    };
+
+    std::sort(samples.begin(), samples.end());
+    statistics.Min = samples.front();
+    statistics.Max = samples.back();
+    for (auto sample : samples) statistics.Mean += sample;
+    statistics.Mean /= samples.size();
+    statistics.Median = rank(50.0);
+    statistics.P95 = rank(95.0);
+    statistics.P99 = rank(99.0);
+
+    for (auto &sample : samples) sample = std::abs(sample - statistics.Median);
+    std::sort(samples.begin(), samples.end());
+    statistics.MAD = rank(50.0);
+    return statistics;
+}
+
+///
+/// @brief Records a fixed number of frames
+///
+class FrameBenchmark {
+public:
+    FrameBenchmark(const string &name, size_t frames, size_t warmup = 0):
+        mName(name),
+        mFrames(frames),
+        mWarmup(warmup) {
+        mSamples.reserve(frames);
+    }
+    ~FrameBenchmark() = default;
+
+    // Methods
+    void BeginFrame() {
+        auto memory = GetMemoryStatistics().Total;
+        mAllocations = memory.Allocations;
+        mBytes = memory.Allocated;
+        mStart = std::chrono::steady_clock::now();
+    }
+    void EndFrame() {
+        auto end = std::chrono::steady_clock::now();
+        auto memory = GetMemoryStatistics().Total;
+        if (mWarmup) {
+            mWarmup--;
+            return;
+        }
+        if (IsFinished()) return;
+        mSamples.push_back({
+            std::chrono::duration<double, std::milli>(end - mStart).count(),
+            memory.Allocations - mAllocations,
+            memory.Allocated - mBytes,
+        });
+    }
+
+    // Accessors
+    bool IsFinished() const { return !mWarmup && mSamples.size() >= mFrames; }
+    const string &GetName() const { return mName; }
+    const vector<FrameSample> &GetSamples() const { return mSamples; }
+    BenchmarkStatistics GetStatistics() const {
+        vector<double> times;
+        times.reserve(mSamples.size());
+        for (const auto &sample : mSamples) times.push_back(sample.Time);
+        return Summarize(std::move(times));
+    }
+    // Power of two buckets, starting at 1/8 ms, the last bucket catches everything above 256 ms
+    vector<HistogramBucket> GetHistogram() const {
+        vector<HistogramBucket> histogram;
+        for (double limit = 0.125; limit <= 256.0; limit *= 2.0) histogram.push_back({ limit });
+        histogram.push_back({ std::numeric_limits<double>::infinity() });
+        for (const auto &sample : mSamples) {
+            auto bucket = std::find_if(histogram.begin(), histogram.end(), [&](const auto &bucket) { return sample.Time <= bucket.Limit; });
+            bucket->Count++;
+        }
+        return histogram;
+    }
+
+    // Output
+    void Write(ostream &stream, double deltaTime = {}) const {
+        auto time = GetStatistics();
+        int64_t allocations {}, bytes {}, peak {}, frames {};
+        for (const auto &sample : mSamples) {
+            allocations += sample.Allocations;
+            bytes += sample.Bytes;
+            peak = std::max(peak, sample.Allocations);
+            if (sample.Allocations) frames++;
+        }
+        auto count = std::max<size_t>(mSamples.size(), 1);
+
+        stream << "{\n";
+        stream << std::format(R"(  "name": "{}",)" "\n", String::EscapeJson(mName));
+        stream << std::format(R"(  "frames": {},)" "\n", mSamples.size());
+        stream << std::format(R"(  "deltaTime": {:.3f},)" "\n", deltaTime);
+        stream << std::format(
+            R"(  "cpu": {{ "min": {:.4f}, "mean": {:.4f}, "p50": {:.4f}, "p95": {:.4f}, "p99": {:.4f}, "max": {:.4f}, "mad": {:.4f} }},)" "\n",
+            time.Min, time.Mean, time.Median, time.P95, time.P99, time.Max, time.MAD
+        );
+        stream << std::format(
+            R"(  "allocations": {{ "total": {}, "bytes": {}, "perFrame": {:.2f}, "maxPerFrame": {}, "framesWithAllocations": {} }},)" "\n",
+            allocations, bytes, static_cast<double>(allocations) / count, peak, frames
+        );
+        stream << R"(  "histogram": [)";
+        auto histogram = GetHistogram();
+        for (size_t i = 0; i < histogram.size(); i++) {
+            auto limit = std::isinf(histogram[i].Limit) ? string("null") : std::format("{}", histogram[i].Limit);
+            stream << std::format(R"({}{{ "limit": {}, "count": {} }})", i ? ", " : " ", limit, histogram[i].Count);
+        }
+        stream << " ],\n";
+        stream << R"(  "samples": [)";
+        for (size_t i = 0; i < mSamples.size(); i++) {
+            stream << std::format("{}{:.4f}", i ? ", " : " ", mSamples[i].Time);
+        }
+        stream << " ]\n";
+        stream << "}\n";
+    }
+    bool Save(const std::filesystem::path &path, double deltaTime = {}) const {
+        ofstream stream(path);
+        if (!stream.is_open()) {
+            LogError("Benchmark: Couldn't open output file '{}'!", path.string());
+            return false;
+        }
+        Write(stream, deltaTime);
+        return stream.good();
+    }
+
+private:
+    // Properties
+    string mName;
+    size_t mFrames;
+    size_t mWarmup;
+    vector<FrameSample> mSamples;
+
+    // States
+    std::chrono::steady_clock::time_point mStart {};
+    int64_t mAllocations {};
+    int64_t mBytes {};
+};
+
+///
+/// @brief Result of a micro benchmark (times in ns per call)
+///
+struct BenchmarkResult {
+    string Name;
+    size_t Iterations {};
+    BenchmarkStatistics Statistics {};
+    std::optional<double> Baseline {};  // Median of the baseline
+    double Change {};                   // Relative change of the median against the baseline
+    bool Regression {};
+};
+
+///
+/// @brief Runs registered micro benchmarks over warmup and measured repetitions and compares them against a stored baseline.
+/// @note  Every repetition calls the function 'iterations' times and yields one sample in ns per call.
+///        The median and the median absolute deviation (MAD) are robust against outliers from the scheduler,
+///        a result counts as regression, if it exceeds the baseline by the threshold and by more than three MADs.
+///
+/// @example
+/// Debug::BenchmarkSuite suite("Core");
+/// suite.Add("String::Split", 1000, [] { Debug::DoNotOptimize(String::Split("a,b,c", ',')); });
+/// suite.LoadBaseline("Baseline.json");
+/// suite.Run();
+/// suite.Save("Benchmark.json");
+///
+class BenchmarkSuite {
+    // Types
+    struct BenchmarkCase {
+        string Name;
+        size_t Iterations;
+        function<void()> Function;
+    };
+
+public:
+    BenchmarkSuite(const string &name, size_t warmup = 3, size_t repetitions = 15):
+        mName(name),
+        mWarmup(warmup),
+        mRepetitions(std::max<size_t>(repetitions, 1)) {
+    }
+    ~BenchmarkSuite() = default;
+
+    // Accessors
+    const vector<BenchmarkResult> &GetResults() const { return mResults; }
+    size_t GetRegressions() const {
+        return static_cast<size_t>(std::count_if(mResults.begin(), mResults.end(), [](const auto &result) { return result.Regression; }));
+    }
+
+    // Mutators
+    /// Relative slowdown of the median, which is tolerated before a result counts as regression (default 10%)
+    void SetThreshold(double threshold) { mThreshold = threshold; }
+
+    // Methods
+    void Add(const string &name, size_t iterations, function<void()> function) {
+        mCases.push_back({ name, std::max<size_t>(iterations, 1), std::move(function) });
+    }
+
+    /// Reads the medians of a previous run (written by 'Save'), missing or invalid files are reported and ignored
+    bool LoadBaseline(const std::filesystem::path &path) {
+        std::ifstream stream(path);
+        if (!stream.is_open()) {
+            LogWarning("Benchmark: Couldn't open baseline '{}'!", path.string());
+            return false;
+        }
+
+        static const std::regex pattern(R"lit("name": "((?:[^"\\]|\\.)*)".*"median": ([-+0-9.eE]+))lit");
+        mBaseline.clear();
+        string line;
+        std::smatch match;
+        while (std::getline(stream, line)) {
+            if (!std::regex_search(line, match, pattern)) continue;
+            auto name = std::regex_replace(match[1].str(), std::regex(R"(\\(.))"), "$1");
+            mBaseline[name] = std::stod(match[2].str());
+        }
+        return !mBaseline.empty();
+    }
+
+    /// Runs all benchmarks, which contain the filter in their name
+    const vector<BenchmarkResult> &Run(string_view filter = {}) {
+        mResults.clear();
+        vector<double> samples;
+        samples.reserve(mRepetitions);
+
+        for (const auto &test : mCases) {
+            if (!filter.empty() && test.Name.find(filter) == string::npos) continue;
+
+            for (size_t repetition = 0; repetition < mWarmup; repetition++) {
+                for (size_t i = 0; i < test.Iterations; i++) test.Function();
+            }
+            samples.clear();
+            for (size_t repetition = 0; repetition < mRepetitions; repetition++) {
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < test.Iterations; i++) test.Function();
+                auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+                samples.push_back(duration.count() / test.Iterations);
+            }
+
+            BenchmarkResult result { test.Name, test.Iterations, Summarize(samples) };
+            if (auto baseline = mBaseline.find(test.Name); baseline != mBaseline.end() && baseline->second > 0.0) {
+                const auto &median = result.Statistics.Median;
+                result.Baseline = baseline->second;
+                result.Change = (median - baseline->second) / baseline->second;
+                result.Regression = result.Change > mThreshold && (median - baseline->second) > 3.0 * result.Statistics.MAD;
+            }
+
+            if (result.Baseline) {
+                auto message = std::format("{:<40} {:>12.2f} ns/op ±{:<10.2f} {:>+7.1f}% vs. baseline", result.Name, result.Statistics.Median, result.Statistics.MAD, result.Change * 100.0);
+                result.Regression ? LogWarning("{}", message) : LogInfo("{}", message);
+            } else {
+                LogInfo("{:<40} {:>12.2f} ns/op ±{:.2f}", result.Name, result.Statistics.Median, result.Statistics.MAD);
+            }
+            mResults.push_back(std::move(result));
+        }
+        return mResults;
+    }
+
+    // Output
+    void Write(ostream &stream) const {
+        stream << "{\n";
+        stream << std::format(R"(  "name": "{}",)" "\n", String::EscapeJson(mName));
+        stream << std::format(R"(  "warmup": {},)" "\n", mWarmup);
+        stream << std::format(R"(  "repetitions": {},)" "\n", mRepetitions);
+        stream << std::format(R"(  "threshold": {},)" "\n", mThreshold);
+        stream << R"(  "results": [)" << "\n";
+        for (size_t i = 0; i < mResults.size(); i++) {
+            const auto &result = mResults[i];
+            const auto &statistics = result.Statistics;
+            // One result per line, so that a saved run can be read back as baseline without a JSON parser
+            stream << std::format(
+                R"(    {{ "name": "{}", "iterations": {}, "median": {:.4f}, "mad": {:.4f}, "min": {:.4f}, "mean": {:.4f}, "max": {:.4f})",
+                String::EscapeJson(result.Name), result.Iterations, statistics.Median, statistics.MAD, statistics.Min, statistics.Mean, statistics.Max
+            );
+            if (result.Baseline) {
+                stream << std::format(R"(, "baseline": {:.4f}, "change": {:.4f}, "regression": {})", *result.Baseline, result.Change, result.Regression);
+            }
+            stream << (i + 1 < mResults.size() ? " },\n" : " }\n");
+        }
+        stream << "  ]\n";
+        stream << "}\n";
+    }
+    bool Save(const std::filesystem::path &path) const {
+        ofstream stream(path);
+        if (!stream.is_open()) {
+            LogError("Benchmark: Couldn't open output file '{}'!", path.string());
+            return false;
+        }
+        Write(stream);
+        return stream.good();
+    }
+
+private:
+    // Properties
+    string mName;
+    size_t mWarmup;
+    size_t mRepetitions;
+    double mThreshold = 0.1;
+    vector<BenchmarkCase> mCases;
+    vector<BenchmarkResult> mResults;
+    unordered_map<string, double> mBaseline;
+};
+
+}
@@ -1,69 +1,362 @@
-﻿export module Ultra.Debug.Memory;
+﻿module;
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define APP_RETURN_ADDRESS() _ReturnAddress()
+#else
+    #define APP_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+export module Ultra.Debug.Memory;
 
 ///
 /// @brief: This module serves something like a memory allocation/deallocation watcher.
 ///         It will notify the application, if possible memory leaks are detected.
-/// @note:  Currently this is only the barebone, there is still some work to be done.
-/// 
+/// @note:  Every allocation carries a small header with its size and tag, so that also unsized deletes are counted.
+///         The counters are kept per thread (no contention in the allocator) and merged when they are read.
+///         Aligned allocations (std::align_val_t) are not tracked.
+///
+/// @example
+/// {
+///     Debug::MemoryTagScope tag(Debug::MemoryTag::Renderer);
+///     auto *vertices = new Vertex[1024];  // accounted to the renderer
+/// }
+/// Debug::NextMemoryFrame();
+/// auto &renderer = Debug::GetMemoryStatistics()[Debug::MemoryTag::Renderer];
+///
 
 import Ultra.Core;
 import Ultra.Logger;
 
+export namespace Ultra::Debug {
+
+///
+/// @brief Tags
+///
+
+enum class MemoryTag: uint8_t {
+    Untagged,
+    Core,
+    Assets,
+    Audio,
+    Physics,
+    Renderer,
+    Scene,
+    Scripting,
+    UI,
+    Count,
+};
+
+constexpr array<string_view, static_cast<size_t>(MemoryTag::Count)> MemoryTagNames = {
+    "Untagged", "Core", "Assets", "Audio", "Physics", "Renderer", "Scene", "Scripting", "UI",
+};
+
+///
+/// @brief Statistics of a tag, merged from all threads (in bytes and counts).
+///
+struct MemoryStatistics {
+    int64_t Allocated {};           // Total allocated bytes
+    int64_t Freed {};               // Total freed bytes
+    int64_t Live {};                // Currently allocated bytes
+    int64_t Peak {};                // Highest live bytes (high-water mark, updated by every allocation)
+    int64_t Allocations {};         // Total allocation count
+    int64_t Deallocations {};       // Total deallocation count
+    int64_t FrameAllocations {};    // Allocations during the last frame (see 'NextMemoryFrame')
+};
+
+struct MemoryReport {
+    array<MemoryStatistics, static_cast<size_t>(MemoryTag::Count)> Tags {};
+    MemoryStatistics Total {};
+
+    const MemoryStatistics &operator[](MemoryTag tag) const { return Tags[static_cast<size_t>(tag)]; }
+};
+
+///
+/// @brief Call site (return address of the allocation) with its allocation count and bytes.
+///
+struct AllocationSite {
+    const void *Address {};
+    int64_t Allocations {};
+    int64_t Bytes {};
+};
+
+}
+
+namespace Ultra::Debug {
+
 ///
 /// @brief Properties
 ///
 
-struct AllocationMetrics {
-    size_t TotalAllocated {};
-    size_t TotalFreed {};
+// Header in front of every allocation, which keeps the default alignment of the returned memory
+struct alignas(alignof(std::max_align_t)) AllocationHeader {
+    size_t Size;
+    MemoryTag Tag;
+};
 
-    size_t CurrentUsage() { return TotalAllocated - TotalFreed; }
-} static sAllocationMetrics {};
+struct MemoryCounters {
+    atomic<int64_t> Allocated;
+    atomic<int64_t> Freed;
+    atomic<int64_t> Allocations;
+    atomic<int64_t> Deallocations;
+};
+
+// Slot 0 is shared by threads without an own slot (and threads which are shutting down), it is updated atomically.
+struct alignas(64) MemorySlot {
+    atomic<bool> InUse;
+    array<MemoryCounters, static_cast<size_t>(MemoryTag::Count)> Tags;
+};
+
+struct MemorySite {
+    atomic<const void *> Address;
+    atomic<int64_t> Allocations;
+    atomic<int64_t> Bytes;
+};
+
+// The peak needs the global live bytes, which the per-thread slots can't provide, so they are tracked separately.
+struct alignas(64) MemoryLevel {
+    atomic<int64_t> Live;
+    atomic<int64_t> Peak;
+};
+
+constexpr size_t MaxMemorySlots = 256;
+constexpr size_t MaxMemorySites = 4096;
+
+static MemorySlot sMemorySlots[MaxMemorySlots] {};
+static MemorySite sMemorySites[MaxMemorySites] {};
+static atomic<bool> sMemorySitesEnabled {};
+static MemoryLevel sMemoryLevels[static_cast<size_t>(MemoryTag::Count) + 1] {};  // Tags and the total
+static thread_local MemorySlot *tMemorySlot {};
+static thread_local MemoryTag tMemoryTag {};
+
+// Frame state, only touched by 'NextMemoryFrame' and the statistics (main thread)
+static array<int64_t, static_cast<size_t>(MemoryTag::Count) + 1> sFrameAllocations {};
+static array<int64_t, static_cast<size_t>(MemoryTag::Count) + 1> sLastAllocations {};
+
+struct MemorySlotRelease {
+    ~MemorySlotRelease() {
+        if (tMemorySlot && tMemorySlot != &sMemorySlots[0]) tMemorySlot->InUse.store(false, std::memory_order_release);
+        tMemorySlot = &sMemorySlots[0];
+    }
+};
+
+inline MemorySlot &GetMemorySlot() {
+    if (tMemorySlot) [[likely]] return *tMemorySlot;
+
+    // The shared slot is used until a free slot was claimed, which also covers allocations during the registration
+    tMemorySlot = &sMemorySlots[0];
+    for (size_t index = 1; index < MaxMemorySlots; index++) {
+        auto expected = false;
+        if (sMemorySlots[index].InUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            thread_local MemorySlotRelease release;
+            tMemorySlot = &sMemorySlots[index];
+            break;
+        }
+    }
+    return *tMemorySlot;
+}
+
+inline void AddCounter(atomic<int64_t> &counter, int64_t value, bool shared) {
+    if (shared) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    } else {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+}
+
+inline void RaiseLevel(MemoryLevel &level, int64_t size) {
+    auto live = level.Live.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak = level.Peak.load(std::memory_order_relaxed);
+    while (peak < live && !level.Peak.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+}
+
+inline void RecordSite(const void *address, size_t size) {
+    auto hash = std::hash<const void *>{}(address);
+    for (size_t probe = 0; probe < MaxMemorySites; probe++) {
+        auto &site = sMemorySites[(hash + probe) & (MaxMemorySites - 1)];
+        auto current = site.Address.load(std::memory_order_acquire);
+        if (!current && site.Address.compare_exchange_strong(current, address, std::memory_order_acq_rel)) current = address;
+        if (current == address) {
+            site.Allocations.fetch_add(1, std::memory_order_relaxed);
+            site.Bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+inline void *Allocate(size_t size, const void *site) {
+    auto *header = static_cast<AllocationHeader *>(malloc(sizeof(AllocationHeader) + size));
+    if (!header) throw std::bad_alloc();
+    header->Size = size;
+    header->Tag = tMemoryTag;
+
+    auto &slot = GetMemorySlot();
+    auto &counters = slot.Tags[static_cast<size_t>(header->Tag)];
+    auto shared = &slot == &sMemorySlots[0];
+    AddCounter(counters.Allocated, static_cast<int64_t>(size), shared);
+    AddCounter(counters.Allocations, 1, shared);
+    RaiseLevel(sMemoryLevels[static_cast<size_t>(header->Tag)], static_cast<int64_t>(size));
+    RaiseLevel(sMemoryLevels[static_cast<size_t>(MemoryTag::Count)], static_cast<int64_t>(size));
+    if (sMemorySitesEnabled.load(std::memory_order_relaxed)) RecordSite(site, size);
+    return header + 1;
+}
+
+inline void Deallocate(void *memory) noexcept {
+    if (!memory) return;
+    auto *header = static_cast<AllocationHeader *>(memory) - 1;
+
+    auto &slot = GetMemorySlot();
+    auto &counters = slot.Tags[static_cast<size_t>(header->Tag)];
+    auto shared = &slot == &sMemorySlots[0];
+    AddCounter(counters.Freed, static_cast<int64_t>(header->Size), shared);
+    AddCounter(counters.Deallocations, 1, shared);
+    sMemoryLevels[static_cast<size_t>(header->Tag)].Live.fetch_sub(static_cast<int64_t>(header->Size), std::memory_order_relaxed);
+    sMemoryLevels[static_cast<size_t>(MemoryTag::Count)].Live.fetch_sub(static_cast<int64_t>(header->Size), std::memory_order_relaxed);
+    free(header);
+}
+
+}
 
 ///
 /// @brief Overrides
 ///
 
 export void *operator new(size_t size) {
-    sAllocationMetrics.TotalAllocated += size;
-    return malloc(size);
+    return Ultra::Debug::Allocate(size, APP_RETURN_ADDRESS());
 }
 
 export void *operator new[](size_t size) {
-    sAllocationMetrics.TotalAllocated += size;
-    return malloc(size);
+    return Ultra::Debug::Allocate(size, APP_RETURN_ADDRESS());
+}
+
+export void operator delete(void *memory) noexcept {
+    Ultra::Debug::Deallocate(memory);
 }
 
-export void operator delete(void *memory, size_t const size) noexcept {
-    sAllocationMetrics.TotalFreed += size;
-    free(memory);
+export void operator delete(void *memory, [[maybe_unused]] size_t size) noexcept {
+    Ultra::Debug::Deallocate(memory);
 }
 
 export void operator delete[](void *memory) noexcept {
-    free(memory);
+    Ultra::Debug::Deallocate(memory);
 }
 
-export void operator delete[](void *memory, size_t size) noexcept {
-    sAllocationMetrics.TotalFreed += size;
-    free(memory);
+export void operator delete[](void *memory, [[maybe_unused]] size_t size) noexcept {
+    Ultra::Debug::Deallocate(memory);
 }
+
+export namespace Ultra::Debug {
+
 ///
 /// @brief Functions
 ///
 
+///
+/// @brief Accounts all allocations of the current thread to the tag until the scope ends.
+///
+class MemoryTagScope {
+public:
+    MemoryTagScope(MemoryTag tag): mPrevious(tMemoryTag) { tMemoryTag = tag; }
+    ~MemoryTagScope() { tMemoryTag = mPrevious; }
+
+    MemoryTagScope(const MemoryTagScope &) = delete;
+    MemoryTagScope &operator=(const MemoryTagScope &) = delete;
+
+private:
+    MemoryTag mPrevious;
+};
+
+///
+/// @brief Merges the per-thread counters with the peaks of the tags and the total.
+///
+MemoryReport GetMemoryStatistics() {
+    MemoryReport report {};
+    for (auto &slot : sMemorySlots) {
+        for (size_t tag = 0; tag < report.Tags.size(); tag++) {
+            auto &counters = slot.Tags[tag];
+            auto &statistics = report.Tags[tag];
+            statistics.Allocated += counters.Allocated.load(std::memory_order_relaxed);
+            statistics.Freed += counters.Freed.load(std::memory_order_relaxed);
+            statistics.Allocations += counters.Allocations.load(std::memory_order_relaxed);
+            statistics.Deallocations += counters.Deallocations.load(std::memory_order_relaxed);
+        }
+    }
+
+    auto update = [](MemoryStatistics &statistics, size_t index) {
+        statistics.Live = statistics.Allocated - statistics.Freed;
+        statistics.Peak = sMemoryLevels[index].Peak.load(std::memory_order_relaxed);
+        statistics.FrameAllocations = sFrameAllocations[index];
+    };
+    for (size_t tag = 0; tag < report.Tags.size(); tag++) {
+        auto &statistics = report.Tags[tag];
+        report.Total.Allocated += statistics.Allocated;
+        report.Total.Freed += statistics.Freed;
+        report.Total.Allocations += statistics.Allocations;
+        report.Total.Deallocations += statistics.Deallocations;
+        update(statistics, tag);
+    }
+    update(report.Total, report.Tags.size());
+    return report;
+}
+
+///
+/// @brief Marks the frame boundary for the per-frame allocation counts (main thread).
+///
+void NextMemoryFrame() {
+    auto report = GetMemoryStatistics();
+    for (size_t tag = 0; tag <= report.Tags.size(); tag++) {
+        auto allocations = tag < report.Tags.size() ? report.Tags[tag].Allocations : report.Total.Allocations;
+        sFrameAllocations[tag] = allocations - sLastAllocations[tag];
+        sLastAllocations[tag] = allocations;
+    }
+}
+
+///
+/// @brief Call-site histogram, which counts the allocations per return address (off by default).
+///
+void EnableAllocationSites(bool enable = true) {
+    sMemorySitesEnabled.store(enable, std::memory_order_relaxed);
+}
+
+vector<AllocationSite> GetAllocationSites(size_t count = 16) {
+    vector<AllocationSite> sites;
+    for (auto &site : sMemorySites) {
+        auto address = site.Address.load(std::memory_order_acquire);
+        if (!address) continue;
+        sites.push_back({ address, site.Allocations.load(std::memory_order_relaxed), site.Bytes.load(std::memory_order_relaxed) });
+    }
+    auto middle = sites.begin() + static_cast<ptrdiff_t>(std::min(count, sites.size()));
+    std::partial_sort(sites.begin(), middle, sites.end(), [](const auto &a, const auto &b) { return a.Allocations > b.Allocations; });
+    sites.erase(middle, sites.end());
+    return sites;
+}
+
+}
+
 export inline void VerifyMemoryUsage() {
-    Ultra::Log("Current Memory Usage: {} bytes\n - Total Allocated: {} bytes\n - Total Deallocated: {} bytes",
-        sAllocationMetrics.CurrentUsage(),
-        sAllocationMetrics.TotalAllocated,
-        sAllocationMetrics.TotalFreed
+    using namespace Ultra::Debug;
+    auto report = GetMemoryStatistics();
+    Ultra::Log("Current Memory Usage: {} bytes\n - Total Allocated: {} bytes\n - Total Deallocated: {} bytes\n - Peak: {} bytes",
+        report.Total.Live,
+        report.Total.Allocated,
+        report.Total.Freed,
+        report.Total.Peak
     );
+    for (size_t tag = 0; tag < report.Tags.size(); tag++) {
+        const auto &statistics = report.Tags[tag];
+        if (!statistics.Allocations) continue;
+        Ultra::Log(" - {:<10} live: {} bytes | peak: {} bytes | allocations: {} | last frame: {}",
+            MemoryTagNames[tag], statistics.Live, statistics.Peak, statistics.Allocations, statistics.FrameAllocations
+        );
+    }
 }
 
 export inline void DetectMemoryLeaks() {
-    auto usage = sAllocationMetrics.CurrentUsage();
+    auto report = Ultra::Debug::GetMemoryStatistics();
+    auto usage = report.Total.Live;
     if (usage != 0) {
         Ultra::LogWarning("Memory Leaks Detected [leaked '{}' bytes]!", usage);
-    } else if (sAllocationMetrics.TotalAllocated == 0 && sAllocationMetrics.TotalFreed == 0) {
+    } else if (report.Total.Allocated == 0 && report.Total.Freed == 0) {
         Ultra::LogError("Memory Leak Detection failed!");
     } else {
         Ultra::LogInfo("No Memory Leaks Detected");
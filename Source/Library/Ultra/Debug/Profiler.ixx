@@ -1,104 +1,550 @@
 ﻿export module Ultra.Debug.Profiler;
 
 import Ultra.Core;
+import Ultra.Core.String;
 import Ultra.Logger;
 
 
 ///
 /// @brief: Profiles code and generates tracing data for chrome based browsers (URL: chrome://tracing/)
+/// Scopes are recorded into per-thread ring buffers without locks or allocations. A background writer drains them into a
+/// compact binary capture, which is converted into the chrome tracing format at the end of the session or offline.
 ///
+/// Capture Layout:
+/// Header: "UPRF" [u8 version] [i64 period numerator] [i64 period denominator] [i64 session start]
+/// Name:   [u8 tag] [u32 id] [u16 length] [chars]
+/// Thread: [u8 tag] [u32 id] [u16 length] [chars]
+/// Events: [u8 tag] [u32 thread] [u32 count] { [u32 name] [i64 start] [i64 end] }*
+///
+/// The history keeps the last frames in memory, so that overlays can show the timeline and per-scope statistics live.
+///
+
+export namespace Ultra::Debug {
+
+///
+/// @brief: Scope of a frame in the history, the times are in ms relative to the frame start.
+///
+struct ProfilerFrameEvent {
+    const char *Name {};
+    uint32_t Thread {};
+    uint32_t Depth {};
+    double Start {};
+    double Duration {};
+};
+
+///
+/// @brief: Frame in the history with all scopes, which started during it (sorted by thread and start time).
+///
+struct ProfilerFrame {
+    uint64_t Index {};
+    double Duration {};
+    vector<ProfilerFrameEvent> Events {};
+};
+
+///
+/// @brief: Per-scope statistics over all frames in the history in ms.
+///
+struct ProfilerScopeStatistics {
+    string_view Name {};
+    size_t Calls {};
+    double Min {};
+    double Average {};
+    double Max {};
+    double P99 {};
+};
+
+}
 
 namespace Ultra::Debug {
 
 // Types
 using SteadyClock = std::chrono::steady_clock;
-using Duration = std::chrono::microseconds;
-using TimeStep = std::chrono::duration<double, std::micro>;
 
-// ToDo: Hold all results in memory, later for the UI
-struct ProfilerResult {
-    string Name {};
-    std::thread::id ThreadID {};
-    double StartTime {};
-    double DeltaTime {};
-} static sProfilerResults {};
+enum class ProfilerTag: uint8_t {
+    Name    = 0x1,
+    Thread  = 0x2,
+    Events  = 0x3,
+};
 
-using ProfileResults = std::vector<ProfilerResult>;
+///
+/// @brief: Raw scope event, the name must be a string literal (or outlive the session).
+///
+struct ProfilerEvent {
+    const char *Name;
+    int64_t Start;
+    int64_t End;
+};
 
 struct ProfilerSession {
     string Name;
+    std::filesystem::path Capture;
+    std::filesystem::path Target;
+};
+
+///
+/// @brief: Single producer single consumer ring, owned by the recording thread and drained by the writer.
+///
+class ProfilerBuffer {
+public:
+    // Limits
+    static constexpr size_t Capacity = 16 * 1024;
+
+    ProfilerBuffer(uint32_t id, const string &thread): mEvents(Capacity), mID(id), mThread(thread) {}
+    ~ProfilerBuffer() = default;
+
+    // Producer, returns true when the buffer became half full and should be drained early
+    bool Push(const ProfilerEvent &event) {
+        auto head = mHead.load(std::memory_order_relaxed);
+        auto used = head - mTail.load(std::memory_order_acquire);
+        if (used >= Capacity) {
+            mDropped.store(mDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        mEvents[head & (Capacity - 1)] = event;
+        mHead.store(head + 1, std::memory_order_release);
+        return used == Capacity / 2;
+    }
+
+    // Consumer
+    template<typename F>
+    size_t Drain(F &&callback) {
+        auto tail = mTail.load(std::memory_order_relaxed);
+        auto head = mHead.load(std::memory_order_acquire);
+        for (auto index = tail; index != head; index++) callback(mEvents[index & (Capacity - 1)]);
+        mTail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+    void Reset() {
+        mTail.store(mHead.load(std::memory_order_acquire), std::memory_order_release);
+        mDropped.store(0, std::memory_order_relaxed);
+        mAnnounced = false;
+    }
+
+    // Accessors
+    uint32_t GetID() const { return mID; }
+    const string &GetThread() const { return mThread; }
+    size_t GetDroppedEvents() const { return mDropped.load(std::memory_order_relaxed); }
+    bool IsEmpty() const { return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire); }
+
+private:
+    friend class Instrumentor;
+
+    vector<ProfilerEvent> mEvents;
+    alignas(64) atomic<size_t> mHead {};
+    atomic<size_t> mDropped {};
+    alignas(64) atomic<size_t> mTail {};
+
+    // Writer State
+    uint32_t mID {};
+    string mThread {};
+    bool mAnnounced {};
+    bool mRetired {};
 };
 
 ///
 /// @brief: Instrumentor
-/// 
+///
 /// @example
 /// ProfileScope("Application");
 ///
 class Instrumentor {
 private:
     Instrumentor() = default;
-    ~Instrumentor() = default;
+    ~Instrumentor() { EndSession(); }
 
 public:
+    // Limits
+    static constexpr uint8_t Version = 1;
+    static constexpr auto WriterInterval = std::chrono::milliseconds(50);
+
     static Instrumentor &Instance() {
         static Instrumentor instance;
         return instance;
     }
 
-    void BeginSession(const std::string &name, const std::string &file = "results.json") {
-        std::lock_guard lock(mMutex);
-        if (mCurrentSession) { EndSessionInternal(); }
-        mStream.open(file);
+    ///
+    /// @brief: Starts a capture, a target with the '.json' extension is converted into the chrome tracing format
+    /// at the end of the session, the binary capture is written next to it with the '.uprf' extension.
+    ///
+    void BeginSession(const string &name, const string &file = "ProfilerResults.json") {
+        std::lock_guard session(mSessionMutex);
+        StopSession();
+
+        std::filesystem::path target = file;
+        auto capture = target;
+        capture.replace_extension(".uprf");
 
-        if (mStream.is_open()) {
-            mCurrentSession = CreateScope<ProfilerSession>(name);
-            WriteHeader();
-        } else {
-            Ultra::LogError("Instrumentor couldn't open target file '{}'!\n", file);
+        std::lock_guard lock(mMutex);
+        mStream.open(capture, std::ios::binary | std::ios::trunc);
+        if (!mStream.is_open()) {
+            Ultra::LogError("Instrumentor couldn't open target file '{}'!\n", capture.string());
+            return;
         }
+
+        mCurrentSession = CreateScope<ProfilerSession>(name, capture, target);
+        mNames.clear();
+        if (!mHistoryLimit) for (auto &buffer : mBuffers) buffer->Reset();
+        for (auto &buffer : mBuffers) buffer->mAnnounced = false;
+        WriteHeader();
+
+        mStopWriter = false;
+        mWriter = thread([this] { WriterLoop(); });
+        sActive.store(true, std::memory_order_release);
+    }
+    void EndSession() {
+        std::lock_guard session(mSessionMutex);
+        StopSession();
     }
-    void WriteProfile(const ProfilerResult &result) {
+
+    ///
+    /// @brief: Drains all thread buffers into the capture immediately (on-demand writer).
+    ///
+    void Flush() {
         std::lock_guard lock(mMutex);
+        if (!mStream.is_open()) return;
+        DrainBuffers();
+        mStream.flush();
+    }
 
-        stringstream json;
-        json << std::setprecision(3) << std::fixed;
-        json <<
-            ",\n"
-            << "    {"
-            << R"( "name": ")"   << result.Name         << R"(", )"
-            << R"( "cat": ")"    << "function"          << R"(", )"
-            << R"( "ph": ")"     << "X"                 << R"(", )"
-            << R"( "ts": )"      << result.StartTime    << R"(, )"
-            << R"( "dur": )"     << result.DeltaTime    << R"(, )"
-            << R"( "pid": )"     << 0                   << R"(, )"
-            << R"( "tid": )"     << result.ThreadID     << R"(, )"
-            << R"( "args": )"    << "{}"                << R"( )"
-            << " }";
-
-        if (mCurrentSession) {
-            mStream << json.str();
-            mStream.flush();
-        }
+    ///
+    /// @brief: Keeps the scopes of the last frames in memory, the frames are separated by 'NextFrame'.
+    ///
+    void EnableHistory(size_t frames = 120) {
+        std::lock_guard lock(mMutex);
+        if (!mHistoryLimit) for (auto &buffer : mBuffers) buffer->Reset();
+        mHistoryLimit = std::max<size_t>(frames, 1);
+        while (mHistory.size() > mHistoryLimit) mHistory.pop_front();
+        sActive.store(true, std::memory_order_release);
     }
-    void EndSession() {
+    void DisableHistory() {
+        std::lock_guard lock(mMutex);
+        mHistoryLimit = 0;
+        mHistory.clear();
+        mOpenFrames.clear();
+        mPending.clear();
+        mStatistics.clear();
+        if (!mCurrentSession) sActive.store(false, std::memory_order_release);
+    }
+
+    ///
+    /// @brief: Marks the frame boundary, must be called by the main thread (which also owns the history).
+    /// Scopes are assigned to the frame in which they started, a frame is moved into the history one frame later,
+    /// so that late scopes of worker threads are included.
+    ///
+    void NextFrame() {
+        if (!sActive.load(std::memory_order_relaxed)) return;
         std::lock_guard lock(mMutex);
-        EndSessionInternal();
+        if (!mHistoryLimit) return;
+        DrainBuffers();
+
+        auto now = Now();
+        for (const auto &[thread, event] : mPending) {
+            for (auto frame = mOpenFrames.rbegin(); frame != mOpenFrames.rend(); frame++) {
+                if (event.Start >= frame->Start) {
+                    frame->Events.emplace_back(thread, event);
+                    break;
+                }
+            }
+        }
+        mPending.clear();
+
+        if (!mOpenFrames.empty()) mOpenFrames.back().End = now;
+        if (mOpenFrames.size() == 2) {
+            mHistory.push_back(Finalize(mOpenFrames.front()));
+            mOpenFrames.pop_front();
+            while (mHistory.size() > mHistoryLimit) mHistory.pop_front();
+            mStatisticsDirty = true;
+        }
+        mOpenFrames.push_back({ mFrameIndex++, now });
+    }
+
+    // Accessors (main thread)
+    const deque<ProfilerFrame> &GetHistory() const {
+        return mHistory;
+    }
+    const vector<ProfilerScopeStatistics> &GetStatistics() {
+        if (!mStatisticsDirty) return mStatistics;
+        mStatisticsDirty = false;
+
+        unordered_map<string_view, vector<double>> durations;
+        for (const auto &frame : mHistory) {
+            for (const auto &event : frame.Events) durations[event.Name].push_back(event.Duration);
+        }
+
+        mStatistics.clear();
+        for (auto &[name, samples] : durations) {
+            ProfilerScopeStatistics statistics { name, samples.size() };
+            auto [min, max] = std::minmax_element(samples.begin(), samples.end());
+            statistics.Min = *min;
+            statistics.Max = *max;
+            for (auto sample : samples) statistics.Average += sample;
+            statistics.Average /= samples.size();
+            auto p99 = samples.begin() + static_cast<ptrdiff_t>((samples.size() * 99 + 99) / 100 - 1);
+            std::nth_element(samples.begin(), p99, samples.end());
+            statistics.P99 = *p99;
+            mStatistics.push_back(statistics);
+        }
+        std::sort(mStatistics.begin(), mStatistics.end(), [](const auto &a, const auto &b) { return a.Max > b.Max; });
+        return mStatistics;
+    }
+    bool IsHistoryEnabled() const {
+        return mHistoryLimit > 0;
+    }
+
+    // Recording
+    static bool IsActive() {
+        return sActive.load(std::memory_order_relaxed);
+    }
+    static int64_t Now() {
+        return SteadyClock::now().time_since_epoch().count();
+    }
+    void Record(const ProfilerEvent &event) {
+        if (GetBuffer().Push(event)) mWriterSignal.notify_one();
+    }
+
+    ///
+    /// @brief: Converts a binary capture into the chrome tracing format.
+    ///
+    static bool Convert(const std::filesystem::path &input, ostream &output) {
+        std::ifstream stream(input, std::ios::binary);
+        if (!stream.is_open()) {
+            Ultra::LogError("Instrumentor couldn't open capture '{}'!\n", input.string());
+            return false;
+        }
+        vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+        size_t position {};
+        if (data.size() < 5 || std::memcmp(data.data(), "UPRF", 4) != 0 || data[4] != Version) {
+            Ultra::LogError("Instrumentor: '{}' is not a valid capture!\n", input.string());
+            return false;
+        }
+        position = 5;
+        int64_t numerator {}, denominator {}, origin {};
+        if (!Read(data, position, numerator) || !Read(data, position, denominator) || !Read(data, position, origin) || !denominator) {
+            Ultra::LogError("Instrumentor: '{}' is not a valid capture!\n", input.string());
+            return false;
+        }
+        // Ticks to microseconds
+        auto scale = 1'000'000.0 * static_cast<double>(numerator) / static_cast<double>(denominator);
+
+        unordered_map<uint32_t, string> names;
+        WriteHeader(output);
+        // A truncated capture (e.g. after a crash) is converted up to the last complete record
+        while (position < data.size()) {
+            auto tag = static_cast<ProfilerTag>(data[position++]);
+            if (tag == ProfilerTag::Name || tag == ProfilerTag::Thread) {
+                uint32_t id {};
+                uint16_t length {};
+                if (!Read(data, position, id) || !Read(data, position, length) || position + length > data.size()) break;
+                string text(reinterpret_cast<const char *>(data.data() + position), length);
+                position += length;
+                if (tag == ProfilerTag::Name) {
+                    names[id] = String::EscapeJson(text);
+                } else {
+                    output << std::format(
+                        ",\n    {{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": {}, \"args\": {{ \"name\": \"Thread {}\" }} }}",
+                        id, String::EscapeJson(text)
+                    );
+                }
+            } else if (tag == ProfilerTag::Events) {
+                uint32_t thread {}, count {};
+                if (!Read(data, position, thread) || !Read(data, position, count)) break;
+                for (uint32_t i = 0; i < count; i++) {
+                    uint32_t name {};
+                    int64_t start {}, end {};
+                    if (!Read(data, position, name) || !Read(data, position, start) || !Read(data, position, end)) break;
+                    output << std::format(
+                        ",\n    {{ \"name\": \"{}\", \"cat\": \"function\", \"ph\": \"X\", \"ts\": {:.3f}, \"dur\": {:.3f}, \"pid\": 0, \"tid\": {}, \"args\": {{}} }}",
+                        names[name], (start - origin) * scale, (end - start) * scale, thread
+                    );
+                }
+            } else {
+                Ultra::LogError("Instrumentor: Unknown record in capture '{}'!\n", input.string());
+                break;
+            }
+        }
+        WriteFooter(output);
+        return true;
+    }
+    static bool Convert(const std::filesystem::path &input, const std::filesystem::path &output) {
+        ofstream stream(output);
+        if (!stream.is_open()) {
+            Ultra::LogError("Instrumentor couldn't open target file '{}'!\n", output.string());
+            return false;
+        }
+        return Convert(input, stream);
     }
 
 private:
-    void EndSessionInternal() {
-        if (mCurrentSession) {
-            WriteFooter();
+    // Session
+    void StopSession() {
+        if (!mCurrentSession) return;
+        {
+            std::lock_guard lock(mMutex);
+            if (!mHistoryLimit) sActive.store(false, std::memory_order_release);
+            mStopWriter = true;
+        }
+        mWriterSignal.notify_all();
+        if (mWriter.joinable()) mWriter.join();
+
+        size_t dropped {};
+        {
+            std::lock_guard lock(mMutex);
+            DrainBuffers();
             mStream.close();
-            mCurrentSession.reset(nullptr);
+            for (auto &buffer : mBuffers) dropped += buffer->GetDroppedEvents();
+        }
+        if (dropped) Ultra::LogWarning("Instrumentor dropped {} events, the thread buffers were full!\n", dropped);
+        if (mCurrentSession->Target.extension() == ".json") Convert(mCurrentSession->Capture, mCurrentSession->Target);
+        mCurrentSession.reset(nullptr);
+    }
+
+    // Writer
+    void WriterLoop() {
+        std::unique_lock lock(mMutex);
+        while (!mStopWriter) {
+            mWriterSignal.wait_for(lock, WriterInterval);
+            DrainBuffers();
+        }
+    }
+    void DrainBuffers() {
+        for (auto &buffer : mBuffers) {
+            if (buffer->IsEmpty()) continue;
+
+            mEvents.clear();
+            buffer->Drain([this](const ProfilerEvent &event) { mEvents.push_back(event); });
+            if (mHistoryLimit) {
+                for (const auto &event : mEvents) mPending.emplace_back(buffer->mID, event);
+            }
+            if (!mStream.is_open()) continue;
+
+            if (!buffer->mAnnounced) {
+                WriteString(ProfilerTag::Thread, buffer->mID, buffer->mThread);
+                buffer->mAnnounced = true;
+            }
+            for (const auto &event : mEvents) {
+                if (mNames.contains(event.Name)) continue;
+                auto id = static_cast<uint32_t>(mNames.size());
+                mNames.emplace(event.Name, id);
+                WriteString(ProfilerTag::Name, id, event.Name);
+            }
+
+            Write(ProfilerTag::Events);
+            Write(buffer->mID);
+            Write(static_cast<uint32_t>(mEvents.size()));
+            for (const auto &event : mEvents) {
+                Write(mNames[event.Name]);
+                Write(event.Start);
+                Write(event.End);
+            }
+        }
+    }
+
+    // History
+    struct OpenFrame {
+        uint64_t Index {};
+        int64_t Start {};
+        int64_t End {};
+        vector<std::pair<uint32_t, ProfilerEvent>> Events {};
+    };
+
+    static ProfilerFrame Finalize(OpenFrame &open) {
+        using Milliseconds = std::chrono::duration<double, std::milli>;
+        auto toMilliseconds = [](int64_t ticks) { return Milliseconds(SteadyClock::duration(ticks)).count(); };
+
+        // Parents before their children: by thread, start time and the longer scope first
+        std::sort(open.Events.begin(), open.Events.end(), [](const auto &a, const auto &b) {
+            if (a.first != b.first) return a.first < b.first;
+            if (a.second.Start != b.second.Start) return a.second.Start < b.second.Start;
+            return a.second.End > b.second.End;
+        });
+
+        ProfilerFrame frame { open.Index, toMilliseconds(open.End - open.Start) };
+        frame.Events.reserve(open.Events.size());
+        vector<int64_t> stack;
+        auto thread = std::numeric_limits<uint32_t>::max();
+        for (const auto &[id, event] : open.Events) {
+            if (id != thread) {
+                thread = id;
+                stack.clear();
+            }
+            while (!stack.empty() && stack.back() <= event.Start) stack.pop_back();
+            frame.Events.push_back({
+                event.Name,
+                id,
+                static_cast<uint32_t>(stack.size()),
+                toMilliseconds(event.Start - open.Start),
+                toMilliseconds(event.End - event.Start),
+            });
+            stack.push_back(event.End);
+        }
+        return frame;
+    }
+
+    // Registration (once per thread, buffers of finished threads are reused after they were drained)
+    ProfilerBuffer &GetBuffer() {
+        struct Owner {
+            ProfilerBuffer *Buffer {};
+            ~Owner() {
+                if (!Buffer) return;
+                std::lock_guard lock(Instrumentor::Instance().mMutex);
+                Buffer->mRetired = true;
+            }
+        };
+        thread_local Owner owner;
+        if (owner.Buffer) return *owner.Buffer;
+
+        stringstream thread;
+        thread << std::this_thread::get_id();
+
+        std::lock_guard lock(mMutex);
+        for (auto &buffer : mBuffers) {
+            if (buffer->mRetired && buffer->IsEmpty()) {
+                buffer->mID = mNextThreadID++;
+                buffer->mThread = thread.str();
+                buffer->mAnnounced = false;
+                buffer->mRetired = false;
+                owner.Buffer = buffer.get();
+                return *owner.Buffer;
+            }
         }
+        owner.Buffer = mBuffers.emplace_back(CreateScope<ProfilerBuffer>(mNextThreadID++, thread.str())).get();
+        mEvents.reserve(ProfilerBuffer::Capacity);
+        return *owner.Buffer;
     }
 
+    // Serialization
+    template<typename T>
+    void Write(const T &value) {
+        mStream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+    void WriteString(ProfilerTag tag, uint32_t id, string_view text) {
+        auto length = static_cast<uint16_t>(std::min<size_t>(text.size(), std::numeric_limits<uint16_t>::max()));
+        Write(tag);
+        Write(id);
+        Write(length);
+        mStream.write(text.data(), length);
+    }
     void WriteHeader() {
+        mStream.write("UPRF", 4);
+        Write(Version);
+        Write(static_cast<int64_t>(SteadyClock::period::num));
+        Write(static_cast<int64_t>(SteadyClock::period::den));
+        Write(Now());
+    }
+
+    template<typename T>
+    static bool Read(const vector<uint8_t> &data, size_t &position, T &value) {
+        if (position + sizeof(T) > data.size()) return false;
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    static void WriteHeader(ostream &stream) {
         auto application = "Ultra";
         auto version = "v1.0.0";
-        mStream << "{\n"
+        stream << "{\n"
             << R"(  "displayTimeUnit": "ms",)"  << "\n"
             << R"(  "otherData": {)"            << "\n"
             << R"(    "application": ")"    << application  << R"(",)"  << "\n"
@@ -106,20 +552,40 @@ private:
             << R"(  },)"                    << "\n"
             << R"(  "traceEvents": [)"      << "\n"
             << R"(    {})";
-        mStream.flush();
     }
-    void WriteFooter() {
-        mStream
+    static void WriteFooter(ostream &stream) {
+        stream
             << "\n"
             << "  ]\n"
             << "}\n";
-        mStream.flush();
+        stream.flush();
     }
 
 private:
+    // Session
     Scope<ProfilerSession> mCurrentSession {};
+    mutex mSessionMutex {};
+    static inline atomic<bool> sActive {};
+
+    // Writer
     mutex mMutex {};
+    condition_variable mWriterSignal {};
+    thread mWriter {};
+    bool mStopWriter {};
     ofstream mStream {};
+    vector<Scope<ProfilerBuffer>> mBuffers {};
+    vector<ProfilerEvent> mEvents {};
+    unordered_map<const char *, uint32_t> mNames {};
+    uint32_t mNextThreadID {};
+
+    // History
+    size_t mHistoryLimit {};
+    uint64_t mFrameIndex {};
+    vector<std::pair<uint32_t, ProfilerEvent>> mPending {};
+    deque<OpenFrame> mOpenFrames {};
+    deque<ProfilerFrame> mHistory {};
+    vector<ProfilerScopeStatistics> mStatistics {};
+    bool mStatisticsDirty {};
 };
 
 ///
@@ -127,33 +593,23 @@ private:
 ///
 class ScopedTimer {
 public:
-    ScopedTimer(const char *name, const function<void(const string &, double duration)> &function = nullptr):
+    ScopedTimer(const char *name):
         mName(name),
-        mStopped(false),
-        mStartTime(SteadyClock::now()),
-        mCallback(function) {
+        mStartTime(Instrumentor::IsActive() ? Instrumentor::Now() : 0) {
     }
-    ~ScopedTimer() { if (!mStopped) { Stop(); } };
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+    ~ScopedTimer() { Stop(); };
 
     void Stop() {
-        auto stopTime = std::chrono::time_point_cast<Duration>(SteadyClock::now()).time_since_epoch().count();
-        auto startTime = std::chrono::time_point_cast<Duration>(mStartTime).time_since_epoch().count();
-        auto duration = (stopTime - startTime) * 0.001f;
-
-        mStopped = true;
-        if (mCallback) {
-            mCallback(mName, duration);
-        } else {
-            ProfilerResult result { mName, std::this_thread::get_id(), static_cast<double>(startTime), duration };
-            Instrumentor::Instance().WriteProfile(result);
-        }
+        if (!mStartTime) return;
+        Instrumentor::Instance().Record({ mName, mStartTime, Instrumentor::Now() });
+        mStartTime = 0;
     }
 
 private:
     const char *mName;
-    bool mStopped {};
-    std::chrono::time_point<SteadyClock> mStartTime;
-    function<void(const string&, double duration)> mCallback;
+    int64_t mStartTime {};
 };
 
 }
@@ -164,12 +620,45 @@ void StartProfiling(const string &name, const string &file = "ProfilerResults.js
     Instrumentor::Instance().BeginSession(name, file);
 }
 
-ScopedTimer ProfileScope(const char *name, const function<void(const string &, double duration)> &function = nullptr, [[maybe_unused]] const SourceLocation &location = SourceLocation::Current()) {
-    return ScopedTimer(name, function);
+ScopedTimer ProfileScope(const char *name, [[maybe_unused]] const SourceLocation &location = SourceLocation::Current()) {
+    return ScopedTimer(name);
 }
 
 void StopProfiling() {
     Instrumentor::Instance().EndSession();
 }
 
+bool IsProfiling() {
+    return Instrumentor::IsActive();
+}
+
+bool ConvertProfile(const std::filesystem::path &capture, const std::filesystem::path &target) {
+    return Instrumentor::Convert(capture, target);
+}
+
+// History
+void EnableProfilerHistory(size_t frames = 120) {
+    Instrumentor::Instance().EnableHistory(frames);
+}
+
+void DisableProfilerHistory() {
+    Instrumentor::Instance().DisableHistory();
+}
+
+void ProfileFrame() {
+    Instrumentor::Instance().NextFrame();
+}
+
+const deque<ProfilerFrame> &GetProfilerHistory() {
+    return Instrumentor::Instance().GetHistory();
+}
+
+const vector<ProfilerScopeStatistics> &GetProfilerStatistics() {
+    return Instrumentor::Instance().GetStatistics();
+}
+
+bool IsProfilerHistoryEnabled() {
+    return Instrumentor::Instance().IsHistoryEnabled();
+}
+
 }
@@ -23,8 +23,8 @@ int main(int argc, char **argv) {
 
     // Initialization
     Ultra::Debug::StartProfiling("Application");
+    Ultra::Application::SetArguments(Ultra::Arguments({ argv + 1, argv + argc }));
     auto app = Ultra::CreateApplication();
-    app->SetArguments(Ultra::Arguments({ argv + 1, argv + argc }));
     Ultra::Debug::StopProfiling();
 
     // Main
@@ -5,17 +5,23 @@
 module Ultra.Graphics.Context;
 
 import Ultra.Logger;
+import Ultra.Platform.Graphics.SWContext;
 
 #ifdef APP_PLATFORM_WINDOWS
     import Ultra.Platform.Graphics.DXContext;
     import Ultra.Platform.Graphics.GLContext;
-    import Ultra.Platform.Graphics.SWContext;
     import Ultra.Platform.Graphics.VKContext;
 #endif
 
 namespace Ultra {
 
 Reference<Context> Context::Create(void *window) {
+    // The software backend is portable and also works without a window
+    if (API == GraphicsAPI::Software) {
+        LogDebug("Application: Created context for 'Software'");
+        return CreateReference<SWContext>(window);
+    }
+
 #ifdef APP_PLATFORM_WINDOWS
     switch (API) {
         case GraphicsAPI::OpenGL: {
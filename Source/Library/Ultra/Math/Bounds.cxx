@@ -0,0 +1,106 @@
+﻿module;
+
+#include "Ultra/Core/Platform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #define BOUNDS_SIMD_SSE2
+    #include <emmintrin.h>
+#endif
+
+module Ultra.Math.Bounds;
+
+namespace Ultra {
+
+Frustum::Frustum(const glm::mat4 &viewProjection) {
+    // GLM stores the columns, so the rows are gathered, the depth range is [0, 1], so the near plane is the third row alone
+    auto row = [&](int index) {
+        return glm::vec4(viewProjection[0][index], viewProjection[1][index], viewProjection[2][index], viewProjection[3][index]);
+    };
+    auto x = row(0);
+    auto y = row(1);
+    auto z = row(2);
+    auto w = row(3);
+
+    mPlanes = {
+        w + x,  // Left
+        w - x,  // Right
+        w + y,  // Bottom
+        w - y,  // Top
+        z,      // Near
+        w - z,  // Far
+    };
+    for (auto &plane : mPlanes) {
+        auto length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) plane /= length;
+    }
+}
+
+
+bool Frustum::Intersects(const BoundingBox &box) const {
+    if (!box.IsValid()) return false;
+
+    // Only the corner, which lies farthest along the plane normal (p-vertex), has to be tested
+    for (const auto &plane : mPlanes) {
+        glm::vec3 corner {
+            plane.x >= 0.0f ? box.Max.x : box.Min.x,
+            plane.y >= 0.0f ? box.Max.y : box.Min.y,
+            plane.z >= 0.0f ? box.Max.z : box.Min.z,
+        };
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) return false;
+    }
+    return true;
+}
+
+bool Frustum::Intersects(const BoundingSphere &sphere) const {
+    if (!sphere.IsValid()) return false;
+
+    for (const auto &plane : mPlanes) {
+        if (glm::dot(glm::vec3(plane), sphere.Center) + plane.w < -sphere.Radius) return false;
+    }
+    return true;
+}
+
+size_t Frustum::Cull(const vector<BoundingSphere> &spheres, vector<uint8_t> &visibility) const {
+    visibility.resize(spheres.size());
+    size_t visible = 0;
+    size_t i = 0;
+
+#if defined(BOUNDS_SIMD_SSE2)
+    __m128 planes[6][4];
+    for (size_t p = 0; p < mPlanes.size(); p++) {
+        for (glm::length_t c = 0; c < 4; c++) planes[p][c] = _mm_set1_ps(mPlanes[p][c]);
+    }
+
+    // Four spheres are transposed into lanes and tested against all planes, a lane is culled as soon as one plane rejects it
+    for (; i + 4 <= spheres.size(); i += 4) {
+        const auto *data = &spheres[i];
+        auto x = _mm_setr_ps(data[0].Center.x, data[1].Center.x, data[2].Center.x, data[3].Center.x);
+        auto y = _mm_setr_ps(data[0].Center.y, data[1].Center.y, data[2].Center.y, data[3].Center.y);
+        auto z = _mm_setr_ps(data[0].Center.z, data[1].Center.z, data[2].Center.z, data[3].Center.z);
+        auto radius = _mm_setr_ps(data[0].Radius, data[1].Radius, data[2].Radius, data[3].Radius);
+        auto negativeRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+
+        auto outside = _mm_cmplt_ps(radius, _mm_setzero_ps());
+        for (const auto &plane : planes) {
+            auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], x), _mm_mul_ps(plane[1], y)), _mm_add_ps(_mm_mul_ps(plane[2], z), plane[3]));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+        }
+
+        auto mask = _mm_movemask_ps(outside);
+        for (int lane = 0; lane < 4; lane++) {
+            auto inside = !(mask & (1 << lane));
+            visibility[i + lane] = inside;
+            visible += inside;
+        }
+    }
+#endif
+
+    for (; i < spheres.size(); i++) {
+        auto inside = Intersects(spheres[i]);
+        visibility[i] = inside;
+        visible += inside;
+    }
+    return visible;
+}
+
+}
@@ -0,0 +1,94 @@
+﻿export module Ultra.Math.Bounds;
+
+import Ultra.Core;
+export import Ultra.Math;
+
+export namespace Ultra {
+
+///
+/// @brief Axis-aligned bounding box, an empty box (min > max) contains nothing.
+///
+struct BoundingBox {
+    glm::vec3 Min { std::numeric_limits<float>::max() };
+    glm::vec3 Max { std::numeric_limits<float>::lowest() };
+
+    // Methods
+    void Extend(const glm::vec3 &point) {
+        Min = glm::min(Min, point);
+        Max = glm::max(Max, point);
+    }
+    void Extend(const BoundingBox &box) {
+        if (!box.IsValid()) return;
+        Min = glm::min(Min, box.Min);
+        Max = glm::max(Max, box.Max);
+    }
+
+    // Accessors
+    glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+    glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+    bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+};
+
+///
+/// @brief Bounding sphere, cheaper to test than a box, but less tight for long and flat objects.
+///
+struct BoundingSphere {
+    glm::vec3 Center {};
+    float Radius = -1.0f;
+
+    ///
+    /// @brief The sphere is centered in the box, the radius reaches the farthest point (tighter than half the diagonal).
+    ///
+    template<typename T, typename F>
+    static BoundingSphere Create(const BoundingBox &box, const vector<T> &points, F &&position) {
+        if (!box.IsValid()) return {};
+        BoundingSphere result { box.GetCenter(), 0.0f };
+        for (const auto &point : points) {
+            auto delta = position(point) - result.Center;
+            result.Radius = std::max(result.Radius, glm::dot(delta, delta));
+        }
+        result.Radius = std::sqrt(result.Radius);
+        return result;
+    }
+    static BoundingSphere Create(const BoundingBox &box) {
+        if (!box.IsValid()) return {};
+        return { box.GetCenter(), glm::length(box.GetExtents()) };
+    }
+
+    // Accessors
+    bool IsValid() const { return Radius >= 0.0f; }
+};
+
+///
+/// @brief View frustum, the planes are extracted from a (view) projection matrix with a depth range of [0, 1] and point inwards.
+/// If the matrix includes the model transform, the test works in model space, so the bounds don't need to be transformed.
+///
+/// @example: How-To
+/// Frustum frustum(camera.GetViewProjectionMatrix() * transform);
+/// auto visibleCount = frustum.Cull(spheres, visibility);
+/// for (size_t i = 0; i < spheres.size(); i++) if (visibility[i] && frustum.Intersects(boxes[i])) ...
+///
+class Frustum {
+public:
+    Frustum() = default;
+    Frustum(const glm::mat4 &viewProjection);
+    ~Frustum() = default;
+
+    // Methods
+    bool Intersects(const BoundingBox &box) const;
+    bool Intersects(const BoundingSphere &sphere) const;
+
+    ///
+    /// @brief Tests four spheres at once against all planes (SSE where available, scalar otherwise), returns the number of visible spheres.
+    ///
+    size_t Cull(const vector<BoundingSphere> &spheres, vector<uint8_t> &visibility) const;
+
+    // Accessors
+    const array<glm::vec4, 6> &GetPlanes() const { return mPlanes; }
+
+private:
+    // Properties
+    array<glm::vec4, 6> mPlanes {};
+};
+
+}
@@ -49,16 +49,19 @@ public:
     }
     void Render(PerspectiveCamera &camera) {
         Renderer2D::StartScene(camera);
-        for (auto &particle : ParticlePool) {
-            if (!particle.Active) continue;
+        Renderer2D::DrawParallel(ParticlePool.size(), 1024, [&](DrawList2D &list, size_t begin, size_t end) {
+            for (auto i = begin; i < end; i++) {
+                const auto &particle = ParticlePool[i];
+                if (!particle.Active) continue;
 
-            float life = particle.LifeRemaining / particle.LifeTime;
-            glm::vec4 color = glm::lerp(particle.ColorEnd, particle.ColorBegin, life);
+                float life = particle.LifeRemaining / particle.LifeTime;
+                glm::vec4 color = glm::lerp(particle.ColorEnd, particle.ColorBegin, life);
 
-            float size = glm::lerp(particle.SizeEnd, particle.SizeBegin, life);
-            glm::vec3 position = { particle.Position.x, particle.Position.y, 0.2f };
-            Renderer2D::DrawRotatedQuad(position, { size, size }, particle.Rotation, color);
-        }
+                float size = glm::lerp(particle.SizeEnd, particle.SizeBegin, life);
+                glm::vec3 position = { particle.Position.x, particle.Position.y, 0.2f };
+                list.DrawRotatedQuad(position, { size, size }, particle.Rotation, color);
+            }
+        });
         Renderer2D::FinishScene();
     }
 
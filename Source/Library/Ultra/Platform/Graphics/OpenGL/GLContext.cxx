@@ -14,6 +14,7 @@ module Ultra.Platform.Graphics.GLContext;
 import <Windows.h>;
 
 import Ultra.Logger;
+import Ultra.Platform.Renderer.GLState;
 
 // Extensions
 #if defined(APP_PLATFORM_WINDOWS)
@@ -278,7 +279,7 @@ void *GLContext::GetNativeContext() {
 }
 
 void GLContext::SetViewport(uint32_t width, uint32_t height, int32_t x, int32_t y) {
-	glViewport(x, y, width, height);
+	GLState::Instance().SetViewport(x, y, width, height);
 }
 
 void GLContext::SetVSync(bool activate) {
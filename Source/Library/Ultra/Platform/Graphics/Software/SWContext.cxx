@@ -1 +1,54 @@
 ﻿module Ultra.Platform.Graphics.SWContext;
+
+import Ultra.Logger;
+import Ultra.Platform.Renderer.SWRasterizer;
+
+namespace Ultra {
+
+SWContext::SWContext(void *window): mWindow(window) {}
+
+SWContext::~SWContext() {
+    SWRasterizer::Instance().Flush();
+}
+
+void SWContext::Load() {
+    LogDebug("[Context::SW] Software rasterizer with {} pixel tiles{}", SWRasterizer::TileSize, mWindow ? "" : " (headless)");
+}
+
+
+// Controls
+void SWContext::Attach() {}
+
+void SWContext::Detach() {}
+
+void SWContext::Clear() {
+    SWRasterizer::Instance().Clear({ 0.0f, 0.0f, 0.0f, 1.0f });
+}
+
+void SWContext::SwapBuffers() {
+    SWRasterizer::Instance().Present(mWindow);
+}
+
+
+// Accessors & Mutators
+void *SWContext::GetNativeContext() {
+    return &SWRasterizer::Instance();
+}
+
+void SWContext::SetViewport(uint32_t width, uint32_t height, int32_t x, int32_t y) {
+    auto &rasterizer = SWRasterizer::Instance();
+    rasterizer.Resize(width + static_cast<uint32_t>(std::max(x, 0)), height + static_cast<uint32_t>(std::max(y, 0)));
+    rasterizer.SetViewport(static_cast<uint32_t>(std::max(x, 0)), static_cast<uint32_t>(std::max(y, 0)), width, height);
+}
+
+void SWContext::SetVSync([[maybe_unused]] bool activate) {
+    // Presenting is a plain blit, there is nothing to synchronize with
+}
+
+
+// Methods
+bool const SWContext::IsCurrentContext() {
+    return true;
+}
+
+}
@@ -1 +1,39 @@
 ﻿export module Ultra.Platform.Graphics.SWContext;
+
+import Ultra.Core;
+import Ultra.Graphics.Context;
+
+export namespace Ultra {
+
+///
+/// @brief Context of the software backend, it works with a window (presented via GDI on Windows) or headless without one.
+///
+class SWContext: public Context {
+public:
+    // Default
+    SWContext(void *window);
+    virtual ~SWContext();
+    virtual void Load() override;
+
+    // Controls
+    virtual void Attach() override;
+    virtual void Detach() override;
+    virtual void Clear() override;
+    virtual void SwapBuffers() override;
+
+    // Accessors
+    virtual void *GetNativeContext() override;
+
+    // Mutators
+    virtual void SetViewport(uint32_t width, uint32_t height, int32_t x = 0, int32_t y = 0) override;
+    virtual void SetVSync(bool activate) override;
+
+private:
+    // Methods
+    virtual bool const IsCurrentContext() override;
+
+    // Properties
+    void *mWindow;
+};
+
+}
@@ -24,7 +24,7 @@ void DXCommandBuffer::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_
 
 void DXCommandBuffer::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) {}
 
-void DXCommandBuffer::DrawIndexed(size_t count, PrimitiveType type, bool depthTest) {}
+void DXCommandBuffer::DrawIndexed(size_t count, PrimitiveType type, bool depthTest, int32_t vertexOffset) {}
 
 
 void DXCommandBuffer::Execute() {}
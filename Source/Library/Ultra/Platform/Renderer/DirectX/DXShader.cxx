@@ -22,53 +22,53 @@ int32_t DXShader::FindUniformLocation(const string &name) const {
 }
 
 
-void DXShader::UpdateUniformBuffer(const string &name, const void *data, size_t size) {}
+void DXShader::UpdateUniformBuffer(UniformHandle uniform, const void *data, size_t size) {}
 
-void DXShader::UpdateUniform(const string &name, const Bool &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Bool &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Bool2 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Bool2 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Bool3 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Bool3 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Bool4 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Bool4 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Double &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Double &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Double2 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Double2 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Double3 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Double3 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Double4 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Double4 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Float &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Float &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Float2 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Float2 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Float3 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Float3 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Float4 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Float4 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Int &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Int &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Int2 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Int2 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Int3 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Int3 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Int4 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Int4 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const UInt &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const UInt &data) {}
 
-void DXShader::UpdateUniform(const string &name, const UInt2 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const UInt2 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const UInt3 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const UInt3 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const UInt4 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const UInt4 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Matrix2 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Matrix2 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Matrix3 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Matrix3 &data) {}
 
-void DXShader::UpdateUniform(const string &name, const Matrix4 &data) {}
+void DXShader::UpdateUniform(UniformHandle uniform, const Matrix4 &data) {}
 
 }
 
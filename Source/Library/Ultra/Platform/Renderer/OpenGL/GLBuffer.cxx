@@ -2,6 +2,8 @@
 
 import <glad/gl.h>;
 
+import Ultra.Platform.Renderer.GLState;
+
 namespace Ultra {
 
 GLenum GetGLBufferType(BufferType type) {
@@ -29,33 +31,106 @@ GLBuffer::GLBuffer(BufferType type, const void *data, size_t size, BufferUsage u
     mNativeType = GetGLBufferType(type);
 
     glCreateBuffers(1, &mBufferID);
-    glNamedBufferData(mBufferID, size, data, bufferUsage);
+    if (usage == BufferUsage::Stream) {
+        // Immutable storage, which stays mapped for its whole lifetime, coherent writes don't need an explicit flush
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glNamedBufferStorage(mBufferID, size, data, flags);
+        mPersistentData = glMapNamedBufferRange(mBufferID, 0, size, flags);
+        if (!mPersistentData) LogError("GLBuffer: The persistent mapping of {} bytes failed!", size);
+    } else {
+        glNamedBufferData(mBufferID, size, data, bufferUsage);
+    }
 }
 
 GLBuffer::~GLBuffer() {
+    for (auto &fence : mFences) {
+        if (fence) glDeleteSync(fence);
+    }
+    if (mPersistentData) glUnmapNamedBuffer(mBufferID);
     glDeleteBuffers(1, &mBufferID);
+    GLState::Instance().ForgetBuffer(mBufferID);
 }
 
 
 void GLBuffer::Bind() const {
     if (mNativeType == GL_UNIFORM_BUFFER) return;
-    glBindBuffer(mNativeType, mBufferID);
+    GLState::Instance().BindBuffer(mNativeType, mBufferID);
 }
 
 void GLBuffer::Bind(uint32_t binding) const {
     if (mNativeType != GL_UNIFORM_BUFFER) return;
-    glBindBufferBase(GL_UNIFORM_BUFFER, binding, mBufferID);
+    GLState::Instance().BindBufferBase(GL_UNIFORM_BUFFER, binding, mBufferID);
 }
 
 void GLBuffer::Unbind() const {
     if (mNativeType == GL_UNIFORM_BUFFER) return;
-    glBindBuffer(mNativeType, 0);
+    GLState::Instance().BindBuffer(mNativeType, 0);
 }
 
 void GLBuffer::UpdateData(const void *data, size_t size) {
+    // Immutable storage can only be written through the mapping
+    if (mPersistentData) {
+        std::memcpy(mPersistentData, data, std::min(size, mSize));
+        return;
+    }
     glNamedBufferSubData(mBufferID, 0, size, data);
 }
 
+
+void GLBuffer::BindRange(uint32_t binding, size_t offset, size_t size) const {
+    if (mNativeType != GL_UNIFORM_BUFFER) return;
+    GLState::Instance().BindBufferRange(GL_UNIFORM_BUFFER, binding, mBufferID, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+}
+
+void *GLBuffer::Map(size_t offset, size_t size) {
+    if (offset + size > mSize) return nullptr;
+    if (mPersistentData) return static_cast<byte *>(mPersistentData) + offset;
+
+    // The previous content of the range is discarded, so the driver doesn't have to wait for pending reads
+    return glMapNamedBufferRange(mBufferID, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+void GLBuffer::Unmap() {
+    if (mPersistentData) return;
+    glUnmapNamedBuffer(mBufferID);
+}
+
+void GLBuffer::Fence(uint32_t frame) {
+    auto &fence = mFences[frame % FramesInFlight];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void GLBuffer::Wait(uint32_t frame) {
+    auto &fence = mFences[frame % FramesInFlight];
+    if (!fence) return;
+
+    // The first check only polls, usually the frame finished long ago, afterwards the commands are flushed, otherwise the fence could never signal
+    GLbitfield flags = 0;
+    GLuint64 timeout = 0;
+    while (true) {
+        auto result = glClientWaitSync(fence, flags, timeout);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) break;
+        if (result == GL_WAIT_FAILED) {
+            LogError("GLBuffer: Waiting for the fence of frame {} failed!", frame);
+            break;
+        }
+        flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        timeout = 1'000'000; // 1ms
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+bool GLBuffer::IsFinished(uint32_t frame) const {
+    auto fence = mFences[frame % FramesInFlight];
+    if (!fence) return true;
+
+    GLint status {};
+    glGetSynciv(fence, GL_SYNC_STATUS, 1, nullptr, &status);
+    return status == GL_SIGNALED;
+}
+
 #if UNDEFINED
 
 DetectCompressionLevel(data, size);
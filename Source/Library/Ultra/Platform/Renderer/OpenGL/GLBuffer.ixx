@@ -16,8 +16,17 @@ public:
     virtual void Unbind() const override;
     virtual void UpdateData(const void *data, size_t size) override;
 
+    virtual void BindRange(uint32_t binding, size_t offset, size_t size) const override;
+    virtual void *Map(size_t offset, size_t size) override;
+    virtual void Unmap() override;
+    virtual void Fence(uint32_t frame) override;
+    virtual void Wait(uint32_t frame) override;
+    virtual bool IsFinished(uint32_t frame) const override;
+
 private:
     GLenum mNativeType;
+    void *mPersistentData = nullptr;
+    array<GLsync, FramesInFlight> mFences {};
 };
 
 }
@@ -2,6 +2,8 @@
 
 import <glad/gl.h>;
 
+import Ultra.Platform.Renderer.GLState;
+
 #pragma warning(push)
 #pragma warning(disable: 4100)
 
@@ -22,6 +24,8 @@ void GLCommandBuffer::End() {
 
 
 void GLCommandBuffer::Clear(float r, float g, float b, float a) {
+    // Depth writes have to be enabled, otherwise the depth buffer keeps its content
+    GLState::Instance().SetDepthMask(true);
     glClearColor(r, g, b, a);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
@@ -29,7 +33,7 @@ void GLCommandBuffer::Clear(float r, float g, float b, float a) {
 void GLCommandBuffer::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
     // ToDo: Prevent sizes above imagination
     if (!(width == 0) || !(height == 0)) return;
-    glViewport(x, y, width, height);
+    GLState::Instance().SetViewport(x, y, width, height);
 }
 
 
@@ -51,13 +55,16 @@ void GLCommandBuffer::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, u
     //    case PrimitiveType::Triangle: { mode = GL_TRIANGLES; break; }
     //}
 
-    glDrawElements(mode, indexCount, type, nullptr);
+    // Non-instanced draws pass zero instances, which is the same as a single one
+    auto offset = reinterpret_cast<const void *>(static_cast<intptr_t>(firstIndex) * sizeof(uint32_t));
+    glDrawElementsInstancedBaseVertexBaseInstance(mode, indexCount, type, offset, std::max(instanceCount, 1u), vertexOffset, firstInstance);
 
     //if (!depthTest) glEnable(GL_DEPTH_TEST);
 }
 
-void GLCommandBuffer::DrawIndexed(size_t count, PrimitiveType primitive, bool depthTest) {
-    if (!depthTest) { glDepthMask(GL_FALSE); } else { glDepthMask(GL_TRUE); };
+void GLCommandBuffer::DrawIndexed(size_t count, PrimitiveType primitive, bool depthTest, int32_t vertexOffset) {
+    // The depth mask stays as it is after the draw, so consecutive draws with the same setting don't touch it
+    GLState::Instance().SetDepthMask(depthTest);
 
     GLenum type = GL_UNSIGNED_INT;
     //switch (properties.Type) {
@@ -74,9 +81,7 @@ void GLCommandBuffer::DrawIndexed(size_t count, PrimitiveType primitive, bool de
     }
 
     // ToDo: C4267 possible loss of data
-    glDrawElements(mode, static_cast<GLsizei>(count), type, nullptr);
-
-    if (!depthTest) { glDepthMask(GL_TRUE); } else { glDepthMask(GL_FALSE); };
+    glDrawElementsBaseVertex(mode, static_cast<GLsizei>(count), type, nullptr, vertexOffset);
 }
 
 void GLCommandBuffer::UpdateStencilBuffer() {
@@ -88,14 +93,14 @@ void GLCommandBuffer::UpdateStencilBuffer() {
 void GLCommandBuffer::EnableStencilTest() {
     glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
     glStencilMask(0x00);
-    glDisable(GL_DEPTH_TEST);
+    GLState::Instance().SetCapability(GL_DEPTH_TEST, false);
 }
 
 void GLCommandBuffer::ResetStencilTest() {
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
     glStencilFunc(GL_ALWAYS, 1, 0xFF);
     glStencilMask(0xFF);
-    glEnable(GL_DEPTH_TEST);
+    GLState::Instance().SetCapability(GL_DEPTH_TEST, true);
 }
 
 
@@ -17,7 +17,7 @@ public:
 
     virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
     virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) override;
-    virtual void DrawIndexed(size_t count, PrimitiveType type, bool depthTest = true) override;
+    virtual void DrawIndexed(size_t count, PrimitiveType type, bool depthTest = true, int32_t vertexOffset = 0) override;
     virtual void UpdateStencilBuffer() override;
     virtual void EnableStencilTest() override;
     virtual void ResetStencilTest() override;
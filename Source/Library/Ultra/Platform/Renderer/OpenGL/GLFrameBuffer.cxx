@@ -13,7 +13,6 @@ GLFramebuffer::GLFramebuffer(uint32_t width, uint32_t height, TextureFormat form
     // Attach a texture, renderbuffer, or other attachment as needed
     // Example: attach a color texture
     glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &mColorTextureID);
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, mColorTextureID);
 
 
     //switch (format) {
@@ -35,18 +34,15 @@ GLFramebuffer::GLFramebuffer(uint32_t width, uint32_t height, TextureFormat form
     //    default:
     //}
 
-    glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Direct state access keeps the texture units untouched, which are shadowed by the state cache
+    glTextureParameteri(mColorTextureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(mColorTextureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, mColorTextureID, 0);
 
 
     glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &mDepthTextureID);
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, mDepthTextureID);
     //glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, Properties.Samples, GL_DEPTH24_STENCIL8, Properties.Width, Properties.Height, GL_FALSE);
-    
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D_MULTISAMPLE, mDepthTextureID, 0);
 
 
@@ -2,6 +2,8 @@
 
 import <glad/gl.h>;
 
+import Ultra.Platform.Renderer.GLState;
+
 namespace Ultra {
 
 static GLenum ShaderDataTypeToGLBaseType(ShaderDataType type) {
@@ -35,90 +37,86 @@ GLPipelineState::GLPipelineState(const PipelineProperties &properties): Pipeline
 
 GLPipelineState::~GLPipelineState() {
     glDeleteVertexArrays(1, &mPipelineID);
+    GLState::Instance().ForgetVertexArray(mPipelineID);
 }
 
 void GLPipelineState::Apply() {
-    if (mPipelineID) glDeleteVertexArrays(1, &mPipelineID);
+    if (mPipelineID) {
+        glDeleteVertexArrays(1, &mPipelineID);
+        GLState::Instance().ForgetVertexArray(mPipelineID);
+    }
     glCreateVertexArrays(1, &mPipelineID);
-}
+    mAttributeBuffer = 0;
 
-void GLPipelineState::Bind() {
-    UpdateProperties();
-
-    glBindVertexArray(mPipelineID);
-
-    auto attributeIndex = 0;
-    const auto &layout = mProperties.Layout;
-    for (const auto &attribute : layout) {
+    // The attribute formats never change, so only the vertex buffer of binding point zero is swapped while binding
+    GLuint attributeIndex = 0;
+    for (const auto &attribute : mProperties.Layout) {
         auto baseType = ShaderDataTypeToGLBaseType(attribute.Type);
-        glEnableVertexAttribArray(attributeIndex);
+        glEnableVertexArrayAttrib(mPipelineID, attributeIndex);
         if (baseType == GL_INT) {
-            glVertexAttribIPointer(
-                attributeIndex,
-                attribute.GetComponentCount(),
-                baseType,
-                layout.GetStride(),
-                (const void *)(intptr_t)attribute.Offset
-            );
+            glVertexArrayAttribIFormat(mPipelineID, attributeIndex, attribute.GetComponentCount(), baseType, attribute.Offset);
         } else {
-            glVertexAttribPointer(
-                attributeIndex,
-                attribute.GetComponentCount(),
-                baseType,
-                attribute.Normalized ? GL_TRUE : GL_FALSE,
-                layout.GetStride(),
-                (const void *)(intptr_t)attribute.Offset
-            );
+            glVertexArrayAttribFormat(mPipelineID, attributeIndex, attribute.GetComponentCount(), baseType, attribute.Normalized ? GL_TRUE : GL_FALSE, attribute.Offset);
         }
+        glVertexArrayAttribBinding(mPipelineID, attributeIndex, 0);
         attributeIndex++;
     }
+    glVertexArrayBindingDivisor(mPipelineID, 0, mProperties.InputRate == VertexInputRate::Instance ? 1 : 0);
+}
+
+void GLPipelineState::Bind() {
+    UpdateProperties();
+
+    auto &state = GLState::Instance();
+    state.BindVertexArray(mPipelineID);
+
+    // Pipelines are shared, so the vertex buffer, which was bound last, is attached to the vertex array
+    auto buffer = state.GetBuffer(GL_ARRAY_BUFFER);
+    auto generation = state.GetBufferGeneration();
+    if (buffer != GLState::Unknown && buffer == mAttributeBuffer && generation == mAttributeGeneration) return;
+    if (buffer == GLState::Unknown) {
+        GLint binding {};
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &binding);
+        buffer = static_cast<GLuint>(binding);
+    }
+    mAttributeBuffer = buffer;
+    mAttributeGeneration = generation;
+    glVertexArrayVertexBuffer(mPipelineID, 0, buffer, 0, static_cast<GLsizei>(mProperties.Layout.GetStride()));
 }
 
 void GLPipelineState::Unbind() {
     ResetProperties();
-    glBindVertexArray(0);
+    GLState::Instance().BindVertexArray(0);
 }
 
 void GLPipelineState::ResetProperties() {
-    glBlendFunc(GL_ONE, GL_ZERO);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(true);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    auto &state = GLState::Instance();
+    state.SetBlendFunc(GL_ONE, GL_ZERO);
+    state.SetCapability(GL_CULL_FACE, false);
+    state.SetCapability(GL_DEPTH_TEST, false);
+    state.SetDepthMask(true);
+    state.SetPolygonMode(GL_FILL);
 }
 
 void GLPipelineState::UpdateProperties() {
+    auto &state = GLState::Instance();
     switch (mProperties.BlendMode) {
-        case BlendMode::Additive: { glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ONE, GL_ONE); break; }
-        case BlendMode::Alpha:    { glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); break; /* glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA); break;*/ }
-        case BlendMode::Disabled: { glBlendFunc(GL_ONE, GL_ZERO); break; }
-        case BlendMode::Multiply: { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); break; }
+        case BlendMode::Additive: { state.SetBlendFuncSeparate(GL_ONE, GL_ONE, GL_ONE, GL_ONE); break; }
+        case BlendMode::Alpha:    { state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); break; /* state.SetBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA); break;*/ }
+        case BlendMode::Disabled: { state.SetBlendFunc(GL_ONE, GL_ZERO); break; }
+        case BlendMode::Multiply: { state.SetBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); break; }
     }
 
     switch (mProperties.CullMode) {
-        case CullMode::Back:        { glEnable(GL_CULL_FACE); glCullFace(GL_BACK); glFrontFace(GL_CW); break; }
-        case CullMode::Front:       { glEnable(GL_CULL_FACE); glCullFace(GL_FRONT); glFrontFace(GL_CW); break; }
-        case CullMode::BackAndFront:{ glEnable(GL_CULL_FACE); glCullFace(GL_FRONT_AND_BACK); glFrontFace(GL_CW); break; }
-        case CullMode::None:        { glDisable(GL_CULL_FACE);  break; }
+        case CullMode::Back:        { state.SetCapability(GL_CULL_FACE, true); state.SetCullFace(GL_BACK); state.SetFrontFace(GL_CW); break; }
+        case CullMode::Front:       { state.SetCapability(GL_CULL_FACE, true); state.SetCullFace(GL_FRONT); state.SetFrontFace(GL_CW); break; }
+        case CullMode::BackAndFront:{ state.SetCapability(GL_CULL_FACE, true); state.SetCullFace(GL_FRONT_AND_BACK); state.SetFrontFace(GL_CW); break; }
+        case CullMode::None:        { state.SetCapability(GL_CULL_FACE, false);  break; }
     }
 
-    if (mProperties.DepthTest) {
-        glEnable(GL_DEPTH_TEST);
-    } else {
-        glDisable(GL_DEPTH_TEST);
-    }
-
-    if (mProperties.DepthWritable) {
-        glDepthMask(GL_TRUE);
-    } else {
-        glDepthMask(GL_FALSE);
-    }
-
-    if (mProperties.Wireframe) {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    } else {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    }
+    state.SetCapability(GL_DEPTH_TEST, mProperties.DepthTest);
+    state.SetDepthMask(mProperties.DepthWritable);
+    state.SetPolygonMode(mProperties.Wireframe ? GL_LINE : GL_FILL);
 }
 
 }
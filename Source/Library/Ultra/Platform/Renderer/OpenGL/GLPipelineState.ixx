@@ -16,6 +16,11 @@ public:
 private:
     void ResetProperties();
     void UpdateProperties();
+
+private:
+    // Properties
+    uint32_t mAttributeBuffer = 0;
+    uint32_t mAttributeGeneration = 0;
 };
 
 }
@@ -1,6 +1,7 @@
 ﻿module Ultra.Platform.Renderer.GLRenderDevice;
 
 import Ultra.Renderer;
+import Ultra.Platform.Renderer.GLState;
 
 #pragma warning(push)
 #pragma warning(disable: 4100)
@@ -53,9 +54,13 @@ GLRenderDevice::GLRenderDevice() {}
 GLRenderDevice::~GLRenderDevice() {}
 
 void GLRenderDevice::Load() {
+    // The context starts with unknown state, so the first change of everything reaches the driver
+    auto &state = GLState::Instance();
+    state.Invalidate();
+
     uint32_t vao;
     glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
+    state.BindVertexArray(vao);
 
     // Debugging-Support
     std::stacktrace trace;
@@ -65,8 +70,8 @@ void GLRenderDevice::Load() {
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 
     // 3D-Support
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);   // Interprets a smaller value as "closer"
+    state.SetCapability(GL_DEPTH_TEST, true);
+    state.SetDepthFunc(GL_LEQUAL);   // Interprets a smaller value as "closer"
 
     // Anti-Aliasing Support
     glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
@@ -74,14 +79,14 @@ void GLRenderDevice::Load() {
     glHint(GL_POLYGON_SMOOTH_HINT, GL_FASTEST);
 
     // Clipping-Support (triangles drawn anti-clock-wize are the front face)
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CW);
+    state.SetCapability(GL_CULL_FACE, true);
+    state.SetCullFace(GL_BACK);
+    state.SetFrontFace(GL_CW);
 
     // Color-Mixing and Transparency-Support
-    glEnable(GL_BLEND);
+    state.SetCapability(GL_BLEND, true);
     glBlendEquation(GL_FUNC_ADD);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Switch Depth-Buffer Coordinate System (makes it easier to support DirectX and Vulkan)
     //glDepthRange(0.0f, 1.0f);
@@ -97,7 +102,7 @@ void GLRenderDevice::Load() {
     glEnable(GL_MULTISAMPLE);
 
     // Stencil Support
-    glEnable(GL_STENCIL_TEST);
+    state.SetCapability(GL_STENCIL_TEST, true);
     glStencilMask(0xFF);
 
     // Information
@@ -122,6 +127,7 @@ void GLRenderDevice::Load() {
     glGetIntegerv(GL_MAX_SAMPLES, &capabilities.MaxSamples);
     glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &capabilities.MaxAnisotropy);
     glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &capabilities.MaxTextureUnits);
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &capabilities.UniformBufferAlignment);
 
     // Uniform Block Size
     GLint maxUniformBlockSize;
@@ -133,7 +139,7 @@ void GLRenderDevice::Load() {
     glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxUniformBindings);
     LogTrace("Max uniform bindings: {}", maxUniformBindings);
 
-    glBindVertexArray(0);
+    state.BindVertexArray(0);
     capabilities.Log();
 };
 
@@ -153,8 +159,8 @@ void GLRenderDevice::SetLineThickness(float value) {
 
 void GLRenderDevice::SetPolygonMode(PolygonMode mode) {
     switch (mode) {
-        case PolygonMode::Solid:     { glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); break; }
-        case PolygonMode::Wireframe: { glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); break; }
+        case PolygonMode::Solid:     { GLState::Instance().SetPolygonMode(GL_FILL); break; }
+        case PolygonMode::Wireframe: { GLState::Instance().SetPolygonMode(GL_LINE); break; }
         default: {
             //AppAssert(false, "The specified polygon mode isn't implemented yet!");
             break;
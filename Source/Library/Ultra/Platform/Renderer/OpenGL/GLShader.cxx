@@ -2,6 +2,8 @@
 
 import <glad/gl.h>;
 
+import Ultra.Platform.Renderer.GLState;
+
 import Ultra.Renderer.ShaderCompiler;
 import Ultra.System.FileSystem;
 
@@ -65,18 +67,23 @@ void GLShader::Compile(ShaderList shaders) {
     // Create the Program
     auto program = glCreateProgram();
 
+    // Option A: Compiled shaders (cached by content, the misses are compiled in parallel)
+    auto binaries = ShaderCompiler::CompileStages(mShaderName, shaders);
+
     vector<GLenum> ids;
     ids.reserve(shaders.size());
+    bool failed = false;
     for (auto &&[key, code] : shaders) {
+        auto &spirv = binaries[key];
+        if (spirv.empty()) {
+            LogError("Couldn't compile shader '{}' ({})!", mShaderName, ShaderTypeToString((ShaderType)key));
+            failed = true;
+            break;
+        }
+
         // Create Shader
         auto type = GetGLShaderType((ShaderType)key);
         auto shader = glCreateShader(type);
-        
-        // Option A: Compiled shader
-        //if (FileSystemObjectExists(cache)) {
-
-        //}
-        auto spirv = ShaderCompiler::Compile(mShaderName, (ShaderType)key, code);
         glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, spirv.data(), static_cast<GLsizei>(spirv.size() * sizeof(uint32_t)));
         string entrypoint = "main"; // Get VS entry point name
         glSpecializeShader(shader, entrypoint.c_str(), 0, nullptr, nullptr);
@@ -98,53 +105,56 @@ void GLShader::Compile(ShaderList shaders) {
             glDeleteShader(shader);
 
             LogError("Couldn't compile shader: {}", string(message.begin(), message.end()));
+            failed = true;
             break;
         }
 
         // Attach Shader
         glAttachShader(program, shader);
         ids.push_back(shader);
-
-        // Cache Shader
-        //if (!spirv.empty()) {
-        //    auto cache = "./Data/Cache/Shaders/" + mShaderName + "." + ShaderTypeToString((ShaderType)key) + ".spirv";
-        //    WriteFile(cache, spirv);
-        //}
     }
 
-    // Link them to the Program
+    // Link them to the Program (a partial program is never linked, so that a reload keeps the previous one)
     GLint linked = 0;
-    glLinkProgram(program);
-    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!failed) {
+        glLinkProgram(program);
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    }
     if (linked == GL_FALSE) {
-        GLint length = 0;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        if (!failed) {
+            GLint length = 0;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
 
-        vector<GLchar> message(length);
-        glGetProgramInfoLog(program, length, &length, message.data());
-        LogError("Couldn't link shaders: {}", string(message.begin(), message.end()));
+            vector<GLchar> message(length);
+            glGetProgramInfoLog(program, length, &length, message.data());
+            LogError("Couldn't link shaders: {}", string(message.begin(), message.end()));
+        }
 
         // CleanUp
-        glDeleteProgram(program);
         for (auto id : ids) {
             glDetachShader(program, id);
+            glDeleteShader(id);
         }
+        glDeleteProgram(program);
         return;
     }
 
-    // Detach all Shaders
-    mShaderID = program;
+    // Detach all Shaders and replace the previous program
     for (auto id : ids) {
         glDetachShader(program, id);
+        glDeleteShader(id);
     }
+    if (mShaderID) glDeleteProgram(mShaderID);
+    mShaderID = program;
+    Reflect(binaries);
 }
 
 void GLShader::Bind() const {
-    glUseProgram(mShaderID);
+    GLState::Instance().UseProgram(mShaderID);
 }
 
 void GLShader::Unbind() const {
-    glUseProgram(0);
+    GLState::Instance().UseProgram(0);
 }
 
 
@@ -153,126 +163,126 @@ int32_t GLShader::FindUniformLocation(const string &name) const {
 }
 
 
-void GLShader::UpdateUniformBuffer(const string &name, const void *data, size_t size) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniformBuffer(UniformHandle uniform, const void *data, size_t size) {
+    auto location = uniform.Location;
     glUniform1iv(location, static_cast<GLsizei>(size), reinterpret_cast<const GLint *>(data));
 }
 
-void GLShader::UpdateUniform(const string &name, const Bool &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Bool &data) {
+    auto location = uniform.Location;
     glUniform1i(location, static_cast<int32_t>(data));
 }
 
-void GLShader::UpdateUniform(const string &name, const Bool2 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Bool2 &data) {
+    auto location = uniform.Location;
     auto converted = data.ToArray<GLint>();
     glUniform2iv(location, 1, converted.data());
 }
 
-void GLShader::UpdateUniform(const string &name, const Bool3 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Bool3 &data) {
+    auto location = uniform.Location;
     auto converted = data.ToArray<GLint>();
     glUniform3iv(location, 1, converted.data());
 }
 
-void GLShader::UpdateUniform(const string &name, const Bool4 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Bool4 &data) {
+    auto location = uniform.Location;
     auto converted = data.ToArray<GLint>();
     glUniform4iv(location, 1, converted.data());
 }
 
-void GLShader::UpdateUniform(const string &name, const Double &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Double &data) {
+    auto location = uniform.Location;
     glUniform1dv(location, 1, &data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Double2 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Double2 &data) {
+    auto location = uniform.Location;
     glUniform2dv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Double3 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Double3 &data) {
+    auto location = uniform.Location;
     glUniform3dv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Double4 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Double4 &data) {
+    auto location = uniform.Location;
     glUniform4dv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Float &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Float &data) {
+    auto location = uniform.Location;
     glUniform1fv(location, 1, &data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Float2 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Float2 &data) {
+    auto location = uniform.Location;
     glUniform2fv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Float3 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Float3 &data) {
+    auto location = uniform.Location;
     glUniform3fv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Float4 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Float4 &data) {
+    auto location = uniform.Location;
     glUniform4fv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Int &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Int &data) {
+    auto location = uniform.Location;
     glUniform1iv(location, 1, &data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Int2 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Int2 &data) {
+    auto location = uniform.Location;
     glUniform2iv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Int3 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Int3 &data) {
+    auto location = uniform.Location;
     glUniform3iv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Int4 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Int4 &data) {
+    auto location = uniform.Location;
     glUniform4iv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const UInt &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const UInt &data) {
+    auto location = uniform.Location;
     glUniform1uiv(location, 1, &data);
 }
 
-void GLShader::UpdateUniform(const string &name, const UInt2 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const UInt2 &data) {
+    auto location = uniform.Location;
     glUniform2uiv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const UInt3 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const UInt3 &data) {
+    auto location = uniform.Location;
     glUniform3uiv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const UInt4 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const UInt4 &data) {
+    auto location = uniform.Location;
     glUniform4uiv(location, 1, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Matrix2 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Matrix2 &data) {
+    auto location = uniform.Location;
     glUniformMatrix2fv(location, 1, GL_FALSE, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Matrix3 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Matrix3 &data) {
+    auto location = uniform.Location;
     glUniformMatrix3fv(location, 1, GL_FALSE, data);
 }
 
-void GLShader::UpdateUniform(const string &name, const Matrix4 &data) {
-    auto location = FindUniformLocation(name);
+void GLShader::UpdateUniform(UniformHandle uniform, const Matrix4 &data) {
+    auto location = uniform.Location;
     glUniformMatrix4fv(location, 1, GL_FALSE, data);
 }
 
@@ -18,30 +18,32 @@ public:
     virtual int32_t FindUniformLocation(const string &name) const override;
 
     // Mutators
-    void UpdateUniformBuffer(const string &name, const void *data, size_t size) override;
-    void UpdateUniform(const string &name, const Bool &data) override;
-    void UpdateUniform(const string &name, const Bool2 &data) override;
-    void UpdateUniform(const string &name, const Bool3 &data) override;
-    void UpdateUniform(const string &name, const Bool4 &data) override;
-    void UpdateUniform(const string &name, const Double &data) override;
-    void UpdateUniform(const string &name, const Double2 &data) override;
-    void UpdateUniform(const string &name, const Double3 &data) override;
-    void UpdateUniform(const string &name, const Double4 &data) override;
-    void UpdateUniform(const string &name, const Float &data) override;
-    void UpdateUniform(const string &name, const Float2 &data) override;
-    void UpdateUniform(const string &name, const Float3 &data) override;
-    void UpdateUniform(const string &name, const Float4 &data) override;
-    void UpdateUniform(const string &name, const Int &data) override;
-    void UpdateUniform(const string &name, const Int2 &data) override;
-    void UpdateUniform(const string &name, const Int3 &data) override;
-    void UpdateUniform(const string &name, const Int4 &data) override;
-    void UpdateUniform(const string &name, const UInt &data) override;
-    void UpdateUniform(const string &name, const UInt2 &data) override;
-    void UpdateUniform(const string &name, const UInt3 &data) override;
-    void UpdateUniform(const string &name, const UInt4 &data) override;
-    void UpdateUniform(const string &name, const Matrix2 &data) override;
-    void UpdateUniform(const string &name, const Matrix3 &data) override;
-    void UpdateUniform(const string &name, const Matrix4 &data) override;
+    using Shader::UpdateUniform;
+    using Shader::UpdateUniformBuffer;
+    void UpdateUniformBuffer(UniformHandle uniform, const void *data, size_t size) override;
+    void UpdateUniform(UniformHandle uniform, const Bool &data) override;
+    void UpdateUniform(UniformHandle uniform, const Bool2 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Bool3 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Bool4 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Double &data) override;
+    void UpdateUniform(UniformHandle uniform, const Double2 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Double3 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Double4 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Float &data) override;
+    void UpdateUniform(UniformHandle uniform, const Float2 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Float3 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Float4 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Int &data) override;
+    void UpdateUniform(UniformHandle uniform, const Int2 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Int3 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Int4 &data) override;
+    void UpdateUniform(UniformHandle uniform, const UInt &data) override;
+    void UpdateUniform(UniformHandle uniform, const UInt2 &data) override;
+    void UpdateUniform(UniformHandle uniform, const UInt3 &data) override;
+    void UpdateUniform(UniformHandle uniform, const UInt4 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Matrix2 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Matrix3 &data) override;
+    void UpdateUniform(UniformHandle uniform, const Matrix4 &data) override;
 private:
 };
 
@@ -0,0 +1,232 @@
+﻿module Ultra.Platform.Renderer.GLState;
+
+import <glad/gl.h>;
+
+namespace Ultra {
+
+// Helpers
+namespace {
+
+// Capabilities, which are toggled per draw, others go straight to the driver
+int GetCapabilityIndex(GLenum capability) {
+    switch (capability) {
+        case GL_BLEND:          { return 0; }
+        case GL_CULL_FACE:      { return 1; }
+        case GL_DEPTH_TEST:     { return 2; }
+        case GL_SCISSOR_TEST:   { return 3; }
+        case GL_STENCIL_TEST:   { return 4; }
+        default:                { return -1; }
+    }
+}
+
+uint64_t GetIndexedKey(GLenum target, GLuint index) {
+    return (static_cast<uint64_t>(target) << 32) | index;
+}
+
+}
+
+
+GLState::GLState(): mStatistics(RenderDevice::GetStatistics()) {
+    Invalidate();
+}
+
+
+void GLState::Invalidate() {
+    mProgram = Unknown;
+    mVertexArray = Unknown;
+    mBuffers.clear();
+    mElementBuffers.clear();
+    mIndexedBuffers.clear();
+    mTextureUnits.clear();
+
+    mCapabilities.fill(Unknown);
+    mBlendFunc.fill(Unknown);
+    mCullFace = Unknown;
+    mFrontFace = Unknown;
+    mDepthFunc = Unknown;
+    mDepthMask = Unknown;
+    mPolygonMode = Unknown;
+    mViewportKnown = false;
+    mScissorKnown = false;
+}
+
+void GLState::ForgetBuffer(GLuint buffer) {
+    // The driver resets all bindings of the current context to zero, the name can be handed out again afterwards
+    for (auto &[target, current] : mBuffers) {
+        if (current == buffer) current = 0;
+    }
+    for (auto &[vertexArray, current] : mElementBuffers) {
+        if (current == buffer) current = vertexArray == mVertexArray ? 0 : Unknown;
+    }
+    for (auto &[key, binding] : mIndexedBuffers) {
+        if (binding.Buffer == buffer) binding = { 0, 0, 0 };
+    }
+    mBufferGeneration++;
+}
+
+void GLState::ForgetTexture(GLuint texture) {
+    for (auto &current : mTextureUnits) {
+        if (current == texture) current = 0;
+    }
+}
+
+void GLState::ForgetVertexArray(GLuint vertexArray) {
+    if (mVertexArray == vertexArray) mVertexArray = 0;
+    mElementBuffers.erase(vertexArray);
+}
+
+
+void GLState::UseProgram(GLuint program) {
+    if (Update(mProgram, program)) glUseProgram(program);
+}
+
+void GLState::BindVertexArray(GLuint vertexArray) {
+    if (Update(mVertexArray, vertexArray)) glBindVertexArray(vertexArray);
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer) {
+    // The element buffer binding is part of the vertex array state
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        if (mVertexArray == Unknown) {
+            mStatistics.IssuedStateCalls++;
+            glBindBuffer(target, buffer);
+            return;
+        }
+        auto [entry, created] = mElementBuffers.try_emplace(mVertexArray, Unknown);
+        if (Update(entry->second, buffer)) glBindBuffer(target, buffer);
+        return;
+    }
+
+    auto [entry, created] = mBuffers.try_emplace(target, Unknown);
+    if (Update(entry->second, buffer)) glBindBuffer(target, buffer);
+}
+
+void GLState::BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    // An indexed binding also replaces the generic binding of the target
+    auto &binding = mIndexedBuffers[GetIndexedKey(target, index)];
+    if (binding.Buffer == buffer && binding.Size == -1) {
+        mStatistics.SkippedStateCalls++;
+        return;
+    }
+    mStatistics.IssuedStateCalls++;
+    binding = { buffer, 0, -1 };
+    mBuffers[target] = buffer;
+    glBindBufferBase(target, index, buffer);
+}
+
+void GLState::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    auto &binding = mIndexedBuffers[GetIndexedKey(target, index)];
+    if (binding.Buffer == buffer && binding.Offset == offset && binding.Size == size) {
+        mStatistics.SkippedStateCalls++;
+        return;
+    }
+    mStatistics.IssuedStateCalls++;
+    binding = { buffer, offset, size };
+    mBuffers[target] = buffer;
+    glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void GLState::BindTextureUnit(GLuint unit, GLuint texture) {
+    if (unit >= mTextureUnits.size()) mTextureUnits.resize(unit + 1, Unknown);
+    if (Update(mTextureUnits[unit], texture)) glBindTextureUnit(unit, texture);
+}
+
+
+void GLState::SetCapability(GLenum capability, bool enabled) {
+    auto index = GetCapabilityIndex(capability);
+    if (index >= 0 && !Update(mCapabilities[index], enabled)) return;
+    if (index < 0) mStatistics.IssuedStateCalls++;
+
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+void GLState::SetBlendFunc(GLenum source, GLenum destination) {
+    if (mBlendFunc == array<GLuint, 4> { source, destination, source, destination }) {
+        mStatistics.SkippedStateCalls++;
+        return;
+    }
+    mStatistics.IssuedStateCalls++;
+    mBlendFunc = { source, destination, source, destination };
+    glBlendFunc(source, destination);
+}
+
+void GLState::SetBlendFuncSeparate(GLenum sourceColor, GLenum destinationColor, GLenum sourceAlpha, GLenum destinationAlpha) {
+    if (mBlendFunc == array<GLuint, 4> { sourceColor, destinationColor, sourceAlpha, destinationAlpha }) {
+        mStatistics.SkippedStateCalls++;
+        return;
+    }
+    mStatistics.IssuedStateCalls++;
+    mBlendFunc = { sourceColor, destinationColor, sourceAlpha, destinationAlpha };
+    glBlendFuncSeparate(sourceColor, destinationColor, sourceAlpha, destinationAlpha);
+}
+
+void GLState::SetCullFace(GLenum face) {
+    if (Update(mCullFace, face)) glCullFace(face);
+}
+
+void GLState::SetFrontFace(GLenum orientation) {
+    if (Update(mFrontFace, orientation)) glFrontFace(orientation);
+}
+
+void GLState::SetDepthFunc(GLenum function) {
+    if (Update(mDepthFunc, function)) glDepthFunc(function);
+}
+
+void GLState::SetDepthMask(bool writable) {
+    if (Update(mDepthMask, writable)) glDepthMask(writable ? GL_TRUE : GL_FALSE);
+}
+
+void GLState::SetPolygonMode(GLenum mode) {
+    if (Update(mPolygonMode, mode)) glPolygonMode(GL_FRONT_AND_BACK, mode);
+}
+
+void GLState::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    array<GLint, 4> viewport { x, y, width, height };
+    if (mViewportKnown && mViewport == viewport) {
+        mStatistics.SkippedStateCalls++;
+        return;
+    }
+    mStatistics.IssuedStateCalls++;
+    mViewport = viewport;
+    mViewportKnown = true;
+    glViewport(x, y, width, height);
+}
+
+void GLState::SetScissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+    array<GLint, 4> scissor { x, y, width, height };
+    if (mScissorKnown && mScissor == scissor) {
+        mStatistics.SkippedStateCalls++;
+        return;
+    }
+    mStatistics.IssuedStateCalls++;
+    mScissor = scissor;
+    mScissorKnown = true;
+    glScissor(x, y, width, height);
+}
+
+
+GLuint GLState::GetBuffer(GLenum target) const {
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        auto entry = mElementBuffers.find(mVertexArray);
+        return entry != mElementBuffers.end() ? entry->second : Unknown;
+    }
+    auto entry = mBuffers.find(target);
+    return entry != mBuffers.end() ? entry->second : Unknown;
+}
+
+
+bool GLState::Update(GLuint &current, GLuint value) {
+    if (current == value) {
+        mStatistics.SkippedStateCalls++;
+        return false;
+    }
+    mStatistics.IssuedStateCalls++;
+    current = value;
+    return true;
+}
+
+}
@@ -0,0 +1,101 @@
+﻿export module Ultra.Platform.Renderer.GLState;
+
+import <glad/gl.h>;
+
+import Ultra.Renderer.RenderDevice;
+
+export namespace Ultra {
+
+///
+/// @brief Shadows the bindings and fixed function state of the OpenGL context, so that redundant calls never reach the driver.
+/// Every change is counted as issued or skipped in the renderer statistics, which are reset at the start of every frame.
+///
+/// @example: How-To
+/// auto &state = GLState::Instance();
+/// state.UseProgram(program);
+/// state.BindTextureUnit(0, texture);
+/// state.SetDepthMask(false);
+///
+/// @note The whole backend has to go through the cache, raw calls in between would leave it out of sync, deleted objects
+/// have to be forgotten, because the driver recycles their names. After foreign code touched the context, call Invalidate.
+///
+class GLState {
+    GLState();
+
+public:
+    // Marks state, which wasn't set through the cache yet
+    static constexpr GLuint Unknown = std::numeric_limits<GLuint>::max();
+
+    ~GLState() = default;
+
+    static GLState &Instance() {
+        static GLState instance;
+        return instance;
+    }
+
+    // Methods
+    void Invalidate();
+    void ForgetBuffer(GLuint buffer);
+    void ForgetTexture(GLuint texture);
+    void ForgetVertexArray(GLuint vertexArray);
+
+    // Bindings
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vertexArray);
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void BindTextureUnit(GLuint unit, GLuint texture);
+
+    // States
+    void SetCapability(GLenum capability, bool enabled);
+    void SetBlendFunc(GLenum source, GLenum destination);
+    void SetBlendFuncSeparate(GLenum sourceColor, GLenum destinationColor, GLenum sourceAlpha, GLenum destinationAlpha);
+    void SetCullFace(GLenum face);
+    void SetFrontFace(GLenum orientation);
+    void SetDepthFunc(GLenum function);
+    void SetDepthMask(bool writable);
+    void SetPolygonMode(GLenum mode);
+    void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    void SetScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // Accessors
+    GLuint GetBuffer(GLenum target) const;
+    GLuint GetVertexArray() const { return mVertexArray; }
+    uint32_t GetBufferGeneration() const { return mBufferGeneration; }
+
+private:
+    bool Update(GLuint &current, GLuint value);
+
+private:
+    // Properties
+    struct IndexedBinding {
+        GLuint Buffer = Unknown;
+        GLintptr Offset = 0;
+        GLsizeiptr Size = 0;
+    };
+
+    RendererStatistics &mStatistics;
+
+    GLuint mProgram;
+    GLuint mVertexArray;
+    unordered_map<GLenum, GLuint> mBuffers;
+    unordered_map<GLuint, GLuint> mElementBuffers;
+    unordered_map<uint64_t, IndexedBinding> mIndexedBuffers;
+    vector<GLuint> mTextureUnits;
+    uint32_t mBufferGeneration = 0;
+
+    array<GLuint, 5> mCapabilities;
+    array<GLuint, 4> mBlendFunc;
+    GLuint mCullFace;
+    GLuint mFrontFace;
+    GLuint mDepthFunc;
+    GLuint mDepthMask;
+    GLuint mPolygonMode;
+    array<GLint, 4> mViewport;
+    array<GLint, 4> mScissor;
+    bool mViewportKnown;
+    bool mScissorKnown;
+};
+
+}
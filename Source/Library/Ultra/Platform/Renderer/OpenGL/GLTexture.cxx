@@ -2,6 +2,8 @@
 
 import <glad/gl.h>;
 
+import Ultra.Platform.Renderer.GLState;
+
 #pragma warning(push, 0)
 //https://github.com/nothings/stb/issues/334
 #ifndef STB_IMAGE_IMPLEMENTATION
@@ -249,15 +251,16 @@ GLTexture::GLTexture(const TextureProperties &properties, const string &path): T
 
 GLTexture::~GLTexture() {
     glDeleteTextures(1, &mTextureID);
+    GLState::Instance().ForgetTexture(mTextureID);
 }
 
 
 void GLTexture::Bind(uint32_t slot) const {
-    glBindTextureUnit(slot, mTextureID);
+    GLState::Instance().BindTextureUnit(slot, mTextureID);
 }
 
 void GLTexture::Unbind(uint32_t slot) const {
-    glBindTextureUnit(slot, 0);
+    GLState::Instance().BindTextureUnit(slot, 0);
 }
 
 bool GLTexture::Load(const string &path, void *&data, int &width, int &height) {
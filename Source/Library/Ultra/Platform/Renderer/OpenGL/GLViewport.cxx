@@ -2,10 +2,12 @@
 
 import <glad/gl.h>;
 
+import Ultra.Platform.Renderer.GLState;
+
 namespace Ultra {
 
 GLViewport::GLViewport(const ViewportProperties &properties): Viewport(properties) {
-    glViewport(static_cast<GLint>(properties.X), static_cast<GLint>(properties.Y), static_cast<GLsizei>(properties.Width), static_cast<GLsizei>(properties.Height));
+    GLState::Instance().SetViewport(static_cast<GLint>(properties.X), static_cast<GLint>(properties.Y), static_cast<GLsizei>(properties.Width), static_cast<GLsizei>(properties.Height));
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
 
@@ -1,21 +1,56 @@
 ﻿module Ultra.Platform.Renderer.SWBuffer;
 
-#pragma warning(push)
-#pragma warning(disable: 4100)
+import Ultra.Platform.Renderer.SWRasterizer;
 
 namespace Ultra {
 
-SWBuffer::SWBuffer(BufferType type, const void *data, size_t size, BufferUsage usage): Buffer(type, data, size, usage) {}
+SWBuffer::SWBuffer(BufferType type, const void *data, size_t size, BufferUsage usage): Buffer(type, data, size, usage) {
+    mStorage.resize(size);
+    if (data) std::memcpy(mStorage.data(), data, size);
+}
 
-SWBuffer::~SWBuffer() {}
+SWBuffer::~SWBuffer() {
+    SWRasterizer::Instance().ReleaseBindings(mStorage.data());
+}
 
 
-void SWBuffer::Bind() const {}
+void SWBuffer::Bind() const {
+    auto &rasterizer = SWRasterizer::Instance();
+    switch (mType) {
+        case BufferType::Vertex: { rasterizer.BindVertexBuffer(mStorage.data(), mStorage.size()); break; }
+        case BufferType::Index:  { rasterizer.BindIndexBuffer(reinterpret_cast<const uint32_t *>(mStorage.data()), mStorage.size()); break; }
+        default:                 { break; }
+    }
+}
 
-void SWBuffer::Unbind() const {}
+void SWBuffer::Bind(uint32_t binding) const {
+    if (mType != BufferType::Uniform) return;
+    SWRasterizer::Instance().BindUniformBuffer(binding, mStorage.data(), mStorage.size());
+}
 
-void SWBuffer::UpdateData(const void *data, size_t size) {}
+void SWBuffer::Unbind() const {
+    SWRasterizer::Instance().ReleaseBindings(mStorage.data());
+}
 
+void SWBuffer::UpdateData(const void *data, size_t size) {
+    // The storage is bound by address, so it never grows, like the fixed size GPU buffers
+    if (size > mStorage.size()) {
+        LogWarning("SWBuffer: The update of {} bytes exceeds the capacity of {} bytes and was truncated!", size, mStorage.size());
+        size = mStorage.size();
+    }
+    std::memcpy(mStorage.data(), data, size);
 }
 
-#pragma warning(pop)
+
+void SWBuffer::BindRange(uint32_t binding, size_t offset, size_t size) const {
+    if (mType != BufferType::Uniform || offset + size > mStorage.size()) return;
+    SWRasterizer::Instance().BindUniformBuffer(binding, mStorage.data() + offset, size);
+}
+
+void *SWBuffer::Map(size_t offset, size_t size) {
+    // Draws read the buffers while they are submitted, so there is nothing in flight, which requires fences
+    if (offset + size > mStorage.size()) return nullptr;
+    return mStorage.data() + offset;
+}
+
+}
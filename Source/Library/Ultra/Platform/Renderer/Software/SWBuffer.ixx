@@ -10,10 +10,15 @@ public:
     virtual ~SWBuffer() override;
 
     virtual void Bind() const override;
+    virtual void Bind(uint32_t binding) const override;
     virtual void Unbind() const override;
     virtual void UpdateData(const void *data, size_t size) override;
 
+    virtual void BindRange(uint32_t binding, size_t offset, size_t size) const override;
+    virtual void *Map(size_t offset, size_t size) override;
+
 private:
+    vector<byte> mStorage;
 };
 
 }
@@ -1,5 +1,7 @@
 ﻿module Ultra.Platform.Renderer.SWCommandBuffer;
 
+import Ultra.Platform.Renderer.SWRasterizer;
+
 #pragma warning(push)
 #pragma warning(disable: 4100)
 
@@ -15,19 +17,37 @@ void SWCommandBuffer::Begin() {}
 void SWCommandBuffer::End() {}
 
 
-void SWCommandBuffer::Clear(float r, float g, float b, float a) {}
+void SWCommandBuffer::Clear(float r, float g, float b, float a) {
+    SWRasterizer::Instance().Clear({ r, g, b, a });
+}
 
-void SWCommandBuffer::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {}
+void SWCommandBuffer::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    SWRasterizer::Instance().SetViewport(x, y, width, height);
+}
 
 
-void SWCommandBuffer::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {}
+void SWCommandBuffer::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {
+    // ToDo: Instancing isn't supported yet, only the first instance is drawn
+    SWRasterizer::Instance().Draw(PrimitiveType::Triangle, vertexCount, firstVertex);
+}
 
-void SWCommandBuffer::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) {}
+void SWCommandBuffer::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) {
+    if (instanceCount) {
+        SWRasterizer::Instance().DrawInstanced(PrimitiveType::Triangle, indexCount, instanceCount, firstIndex, firstInstance);
+        return;
+    }
+    SWRasterizer::Instance().DrawIndexed(PrimitiveType::Triangle, indexCount, firstIndex, vertexOffset);
+}
 
-void SWCommandBuffer::DrawIndexed(size_t count, PrimitiveType type, bool depthTest) {}
+void SWCommandBuffer::DrawIndexed(size_t count, PrimitiveType type, bool depthTest, int32_t vertexOffset) {
+    // Like the OpenGL backend, the flag only masks depth writes
+    SWRasterizer::Instance().DrawIndexed(type, count, 0, vertexOffset, depthTest);
+}
 
 
-void SWCommandBuffer::Execute() {}
+void SWCommandBuffer::Execute() {
+    SWRasterizer::Instance().Flush();
+}
 
 }
 
@@ -1,22 +1,37 @@
 ﻿module Ultra.Platform.Renderer.SWFramebuffer;
 
+import Ultra.Platform.Renderer.SWTexture;
+
 namespace Ultra {
 
-SWFramebuffer::SWFramebuffer(uint32_t width, uint32_t height, TextureFormat format): Framebuffer(width, height,format) {}
+SWFramebuffer::SWFramebuffer(uint32_t width, uint32_t height, TextureFormat format): Framebuffer(width, height,format) {
+    // Targets are always stored as RGBA8, the attachment shares the color image of the target
+    mTarget.Resize(width, height);
+    mColorAttachment = CreateReference<SWTexture>(TextureProperties { width, height, TextureFormat::RGBA8 }, mTarget.Color);
+}
 
-SWFramebuffer::~SWFramebuffer() {}
+SWFramebuffer::~SWFramebuffer() {
+    auto &rasterizer = SWRasterizer::Instance();
+    if (&rasterizer.GetTarget() == &mTarget) rasterizer.BindTarget(nullptr);
+}
 
 
-void SWFramebuffer::Bind() const {}
+void SWFramebuffer::Bind() const {
+    SWRasterizer::Instance().BindTarget(&mTarget);
+}
 
-void SWFramebuffer::Unbind() const {}
+void SWFramebuffer::Unbind() const {
+    SWRasterizer::Instance().BindTarget(nullptr);
+}
 
 
 Reference<Texture> SWFramebuffer::GetColorAttachment() const {
-    return nullptr;
+    SWRasterizer::Instance().Flush();
+    return mColorAttachment;
 }
 
 Reference<Texture> SWFramebuffer::GetDepthAttachment() const {
+    // ToDo: Depth is stored as float and can't be sampled yet
     return nullptr;
 }
 
@@ -1,6 +1,7 @@
 ﻿export module Ultra.Platform.Renderer.SWFramebuffer;
 
 import Ultra.Renderer.Framebuffer;
+import Ultra.Platform.Renderer.SWRasterizer;
 
 export namespace Ultra {
 
@@ -16,6 +17,8 @@ public:
     virtual Reference<Texture> GetDepthAttachment() const override;
 
 private:
+    mutable SWTarget mTarget;
+    Reference<Texture> mColorAttachment;
 };
 
 }
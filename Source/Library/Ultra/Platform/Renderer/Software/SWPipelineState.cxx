@@ -2,14 +2,24 @@
 
 namespace Ultra {
 
-SWPipelineState::SWPipelineState(const PipelineProperties &properties): PipelineState(properties) {}
+SWPipelineState::SWPipelineState(const PipelineProperties &properties): PipelineState(properties) {
+    Apply();
+}
 
-SWPipelineState::~SWPipelineState() {}
+SWPipelineState::~SWPipelineState() {
+    SWRasterizer::Instance().ReleaseBindings(&mProperties);
+}
 
-void SWPipelineState::Apply() {}
+void SWPipelineState::Apply() {
+    mFormat = SWVertexFormat::Create(mProperties.Layout, mProperties.InputRate);
+}
 
-void SWPipelineState::Bind() {}
+void SWPipelineState::Bind() {
+    SWRasterizer::Instance().BindPipeline(&mProperties, &mFormat);
+}
 
-void SWPipelineState::Unbind() {}
+void SWPipelineState::Unbind() {
+    SWRasterizer::Instance().BindPipeline(nullptr, nullptr);
+}
 
 }
@@ -1,6 +1,7 @@
 ﻿export module Ultra.Platform.Renderer.SWPipelineState;
 
 import Ultra.Renderer.PipelineState;
+import Ultra.Platform.Renderer.SWRasterizer;
 
 export namespace Ultra {
 
@@ -12,6 +13,9 @@ public:
     virtual void Apply() override;
     virtual void Bind() override;
     virtual void Unbind() override;
+
+private:
+    SWVertexFormat mFormat;
 };
 
 }
@@ -0,0 +1,862 @@
+﻿module;
+
+#include "Ultra/Core/Platform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #define SW_SIMD_SSE2
+    #include <emmintrin.h>
+#endif
+
+module Ultra.Platform.Renderer.SWRasterizer;
+
+#if defined(APP_PLATFORM_WINDOWS)
+    import <Windows.h>;
+#endif
+
+import Ultra.Core.JobSystem;
+
+namespace Ultra {
+
+// Helpers
+namespace {
+
+constexpr int32_t SubpixelBits = 4;
+constexpr int32_t SubpixelScale = 1 << SubpixelBits;
+constexpr int32_t SubpixelCenter = SubpixelScale / 2;
+constexpr int64_t EdgeLimit = int64_t(1) << 30;     // Edge values are clamped to this range, stepping through a tile stays within 32-bit and keeps the sign
+constexpr float MinimumW = 1e-5f;
+
+constexpr array<glm::vec4, 6> ClipPlanes = {
+    glm::vec4 {  1.0f,  0.0f,  0.0f, 1.0f },    // Left
+    glm::vec4 { -1.0f,  0.0f,  0.0f, 1.0f },    // Right
+    glm::vec4 {  0.0f,  1.0f,  0.0f, 1.0f },    // Bottom
+    glm::vec4 {  0.0f, -1.0f,  0.0f, 1.0f },    // Top
+    glm::vec4 {  0.0f,  0.0f,  1.0f, 1.0f },    // Near
+    glm::vec4 {  0.0f,  0.0f, -1.0f, 1.0f },    // Far
+};
+
+inline float ClipDistance(const glm::vec4 &position, size_t plane) {
+    if (plane == ClipPlanes.size()) return position.w - MinimumW;
+    return glm::dot(ClipPlanes[plane], position);
+}
+
+inline int32_t FloorDivide(int32_t value, int32_t divisor) {
+    return (value >= 0 ? value : value - divisor + 1) / divisor;
+}
+
+inline uint32_t PackColor(const glm::vec4 &color) {
+    auto value = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return uint32_t(value.r) | uint32_t(value.g) << 8 | uint32_t(value.b) << 16 | uint32_t(value.a) << 24;
+}
+
+inline glm::vec4 UnpackColor(uint32_t color) {
+    return glm::vec4(float(color & 0xff), float((color >> 8) & 0xff), float((color >> 16) & 0xff), float(color >> 24)) * (1.0f / 255.0f);
+}
+
+inline glm::vec3 ComputePlane(const array<glm::vec2, 3> &position, float inverseArea, float f0, float f1, float f2) {
+    auto dx = ((f1 - f0) * (position[2].y - position[0].y) - (f2 - f0) * (position[1].y - position[0].y)) * inverseArea;
+    auto dy = ((f2 - f0) * (position[1].x - position[0].x) - (f1 - f0) * (position[2].x - position[0].x)) * inverseArea;
+    return { dx, dy, f0 - dx * position[0].x - dy * position[0].y };
+}
+
+inline float EvaluatePlane(const glm::vec3 &plane, float x, float y) {
+    return plane.x * x + plane.y * y + plane.z;
+}
+
+template<typename T>
+inline T ReadAttribute(const byte *vertex, int32_t offset, const T &fallback) {
+    if (offset < 0) return fallback;
+    T result;
+    std::memcpy(&result, vertex + offset, sizeof(T));
+    return result;
+}
+
+inline int32_t WrapCoordinate(int32_t value, int32_t size, TextureWrap wrap) {
+    switch (wrap) {
+        case TextureWrap::Clamp: {
+            return std::clamp(value, 0, size - 1);
+        }
+        case TextureWrap::MirrorClamp: {
+            if (value < 0) value = -value - 1;
+            return std::min(value, size - 1);
+        }
+        case TextureWrap::MirrorRepeat: {
+            auto period = size * 2;
+            value = ((value % period) + period) % period;
+            return value < size ? value : period - 1 - value;
+        }
+        default: {
+            return ((value % size) + size) % size;
+        }
+    }
+}
+
+}
+
+
+// Image and Target
+glm::vec4 SWImage::Sample(const glm::vec2 &coordinate) const {
+    if (Texels.empty()) return glm::vec4(1.0f);
+    auto width = static_cast<int32_t>(Width);
+    auto height = static_cast<int32_t>(Height);
+    auto texel = [&](int32_t x, int32_t y) {
+        return UnpackColor(Texels[WrapCoordinate(y, height, Wrap) * width + WrapCoordinate(x, width, Wrap)]);
+    };
+
+    switch (Filter) {
+        case TextureFilter::Nearest:
+        case TextureFilter::Point:
+        case TextureFilter::PointMipPoint:
+        case TextureFilter::PointMipLinear: {
+            return texel(static_cast<int32_t>(std::floor(coordinate.x * width)), static_cast<int32_t>(std::floor(coordinate.y * height)));
+        }
+        default: {
+            auto x = coordinate.x * width - 0.5f;
+            auto y = coordinate.y * height - 0.5f;
+            auto x0 = std::floor(x);
+            auto y0 = std::floor(y);
+            auto tx = x - x0;
+            auto ty = y - y0;
+            auto ix = static_cast<int32_t>(x0);
+            auto iy = static_cast<int32_t>(y0);
+            auto top = glm::mix(texel(ix, iy), texel(ix + 1, iy), tx);
+            auto bottom = glm::mix(texel(ix, iy + 1), texel(ix + 1, iy + 1), tx);
+            return glm::mix(top, bottom, ty);
+        }
+    }
+}
+
+void SWTarget::Resize(uint32_t width, uint32_t height) {
+    Width = std::min(width, SWRasterizer::MaxTargetSize);
+    Height = std::min(height, SWRasterizer::MaxTargetSize);
+    Color->Width = Width;
+    Color->Height = Height;
+    Color->Texels.assign(static_cast<size_t>(Width) * Height, 0);
+    Depth.assign(static_cast<size_t>(Width) * Height, 1.0f);
+}
+
+SWVertexFormat SWVertexFormat::Create(const VertexBufferLayout &layout, VertexInputRate rate) {
+    SWVertexFormat format {};
+    format.Instanced = rate == VertexInputRate::Instance;
+    format.Stride = layout.GetStride();
+    for (const auto &element : layout) {
+        auto offset = static_cast<int32_t>(element.Offset);
+        const auto &name = element.Name;
+        auto contains = [&](string_view token) { return name.find(token) != string::npos; };
+
+        // Instances carry a transform instead of a position
+        if (format.Instanced && contains("TransformX")) {
+            format.TransformX = offset;
+        } else if (format.Instanced && contains("TransformY")) {
+            format.TransformY = offset;
+        } else if (format.Instanced && contains("Depth")) {
+            format.Depth = offset;
+        } else if (format.Instanced && contains("TexRect")) {
+            format.TexRect = offset;
+        // The first attribute is always the position (aPosition, aWorldPosition)
+        } else if (!format.Instanced && format.Position < 0) {
+            format.Position = offset;
+        } else if (contains("LocalPosition")) {
+            format.LocalPosition = offset;
+        } else if (contains("Color") && element.Type == ShaderDataType::Float4) {
+            format.Color = offset;
+        } else if (contains("TilingFactor")) {
+            format.TilingFactor = offset;
+        } else if (contains("Index") && element.Type == ShaderDataType::Float) {
+            format.TexIndex = offset;
+        } else if ((contains("TexCoord") || contains("TextureCoordinate")) && element.Type == ShaderDataType::Float2) {
+            format.TexCoord = offset;
+        } else if (contains("Thickness")) {
+            format.Thickness = offset;
+        } else if (contains("Fade")) {
+            format.Fade = offset;
+        }
+    }
+    return format;
+}
+
+
+// Default
+SWRasterizer::SWRasterizer() {
+    mTriangles.reserve(4096);
+}
+
+
+// Commands
+void SWRasterizer::Clear(const glm::vec4 &color) {
+    // Everything drawn so far would be overwritten anyway
+    PrepareBins();
+    for (auto &bin : mBins) bin.clear();
+    mTriangles.clear();
+    mStates.clear();
+    mClearColor = color;
+    mClearPending = true;
+}
+
+void SWRasterizer::Draw(PrimitiveType primitive, size_t count, size_t first, bool depthWrite) {
+    vector<uint32_t> indices(count);
+    std::iota(indices.begin(), indices.end(), static_cast<uint32_t>(first));
+    Submit(primitive, indices.data(), count, 0, depthWrite);
+}
+
+void SWRasterizer::DrawIndexed(PrimitiveType primitive, size_t count, size_t first, int32_t vertexOffset, bool depthWrite) {
+    if (first >= mIndices.size()) return;
+    count = std::min(count, mIndices.size() - first);
+    Submit(primitive, mIndices.data() + first, count, vertexOffset, depthWrite);
+}
+
+void SWRasterizer::DrawInstanced(PrimitiveType primitive, size_t count, size_t instances, size_t first, uint32_t firstInstance, bool depthWrite) {
+    if (!mFormat || !mFormat->Instanced) {
+        // Without per-instance data every instance would be identical, so it is drawn once
+        DrawIndexed(primitive, count, first, 0, depthWrite);
+        return;
+    }
+    if (first >= mIndices.size() || !mFormat->Stride || mFormat->TransformX < 0 || mFormat->TransformY < 0) return;
+    auto available = mVertices.size() / mFormat->Stride;
+    if (firstInstance >= available) return;
+    count = std::min(count, mIndices.size() - first);
+    instances = std::min(instances, available - firstInstance);
+    if (!count || !instances) return;
+
+    // Vertex Shader: The index selects the corner of the unit quad (like gl_VertexIndex), the instance places it
+    struct ExpandedVertex {
+        glm::vec3 Position;
+        glm::vec4 Color;
+        glm::vec2 TexCoord;
+        float TexIndex;
+        float TilingFactor;
+    };
+    static constexpr array<glm::vec2, 4> corners = { glm::vec2 { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+    static_assert(sizeof(ExpandedVertex) == 11 * sizeof(float));
+    static const SWVertexFormat expandedFormat = [] {
+        SWVertexFormat format {};
+        format.Position = 0;
+        format.Color = format.Position + sizeof(glm::vec3);
+        format.TexCoord = format.Color + sizeof(glm::vec4);
+        format.TexIndex = format.TexCoord + sizeof(glm::vec2);
+        format.TilingFactor = format.TexIndex + sizeof(float);
+        format.Stride = sizeof(ExpandedVertex);
+        return format;
+    }();
+
+    const auto &format = *mFormat;
+    const auto *source = mVertices.data() + static_cast<size_t>(firstInstance) * format.Stride;
+    mExpandedVertices.resize(instances * corners.size() * sizeof(ExpandedVertex));
+    auto *expanded = reinterpret_cast<ExpandedVertex *>(mExpandedVertices.data());
+    JobSystem::Instance().ParallelFor(instances, 1024, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            const auto *instance = source + i * format.Stride;
+            auto rowX = ReadAttribute(instance, format.TransformX, glm::vec3(1.0f, 0.0f, 0.0f));
+            auto rowY = ReadAttribute(instance, format.TransformY, glm::vec3(0.0f, 1.0f, 0.0f));
+            auto depth = ReadAttribute(instance, format.Depth, 0.0f);
+            auto color = ReadAttribute(instance, format.Color, glm::vec4(1.0f));
+            auto rect = ReadAttribute(instance, format.TexRect, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+            auto texIndex = ReadAttribute(instance, format.TexIndex, 0.0f);
+            auto tilingFactor = ReadAttribute(instance, format.TilingFactor, 1.0f);
+            array<glm::vec2, 4> texCoords = { glm::vec2 { rect.x, rect.y }, { rect.z, rect.y }, { rect.z, rect.w }, { rect.x, rect.w } };
+
+            for (size_t corner = 0; corner < corners.size(); corner++) {
+                auto local = glm::vec3(corners[corner], 1.0f);
+                expanded[i * corners.size() + corner] = {
+                    { glm::dot(rowX, local), glm::dot(rowY, local), depth },
+                    color, texCoords[corner], texIndex, tilingFactor,
+                };
+            }
+        }
+    });
+
+    mExpandedIndices.resize(instances * count);
+    for (size_t i = 0; i < instances; i++) {
+        auto base = static_cast<uint32_t>(i * corners.size());
+        for (size_t j = 0; j < count; j++) mExpandedIndices[i * count + j] = base + (mIndices[first + j] & 3u);
+    }
+
+    // The expanded vertices run through the regular pipeline, the bindings are restored afterwards
+    auto vertices = mVertices;
+    auto *bound = mFormat;
+    mVertices = { mExpandedVertices.data(), mExpandedVertices.size() };
+    mFormat = &expandedFormat;
+    Submit(primitive, mExpandedIndices.data(), mExpandedIndices.size(), 0, depthWrite);
+    mVertices = vertices;
+    mFormat = bound;
+}
+
+void SWRasterizer::Flush() {
+    if (!mClearPending && mTriangles.empty()) return;
+
+    // Tiles don't overlap, so they can be processed without any synchronization
+    JobSystem::Instance().ParallelFor(mBins.size(), 1, [this](size_t begin, size_t end) {
+        for (auto tile = begin; tile < end; tile++) RasterizeTile(static_cast<uint32_t>(tile));
+    });
+
+    for (auto &bin : mBins) bin.clear();
+    mTriangles.clear();
+    mStates.clear();
+    mClearPending = false;
+}
+
+void SWRasterizer::Present([[maybe_unused]] void *window) {
+    Flush();
+
+#if defined(APP_PLATFORM_WINDOWS)
+    if (!window || !mDefaultTarget.Width || !mDefaultTarget.Height) return;
+
+    // GDI expects BGRA, so red and blue are swapped while copying
+    const auto &texels = mDefaultTarget.Color->Texels;
+    static thread_local vector<uint32_t> pixels;
+    pixels.resize(texels.size());
+    for (size_t i = 0; i < texels.size(); i++) {
+        auto texel = texels[i];
+        pixels[i] = (texel & 0xff00ff00u) | ((texel & 0xffu) << 16) | ((texel >> 16) & 0xffu);
+    }
+
+    BITMAPINFO info {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = static_cast<LONG>(mDefaultTarget.Width);
+    info.bmiHeader.biHeight = -static_cast<LONG>(mDefaultTarget.Height); // Top-down
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    auto handle = reinterpret_cast<HWND>(window);
+    RECT client {};
+    GetClientRect(handle, &client);
+    auto context = GetDC(handle);
+    StretchDIBits(context,
+        0, 0, client.right - client.left, client.bottom - client.top,
+        0, 0, static_cast<int>(mDefaultTarget.Width), static_cast<int>(mDefaultTarget.Height),
+        pixels.data(), &info, DIB_RGB_COLORS, SRCCOPY);
+    ReleaseDC(handle, context);
+#endif
+}
+
+
+// Bindings
+void SWRasterizer::BindTarget(SWTarget *target) {
+    if (!target) target = &mDefaultTarget;
+    if (target == mTarget) return;
+
+    Flush();
+    mTarget = target;
+}
+
+void SWRasterizer::ReleaseBindings(const void *resource) {
+    if (mVertices.data() == resource) mVertices = {};
+    if (mIndices.data() == resource) mIndices = {};
+    if (mPipeline == resource) {
+        mPipeline = nullptr;
+        mFormat = nullptr;
+    }
+    for (auto &uniform : mUniforms) {
+        if (uniform.data() == resource) uniform = {};
+    }
+}
+
+
+// Mutators
+void SWRasterizer::Resize(uint32_t width, uint32_t height) {
+    if (width == mDefaultTarget.Width && height == mDefaultTarget.Height) return;
+
+    Flush();
+    mDefaultTarget.Resize(width, height);
+}
+
+void SWRasterizer::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    // Without a context or swapchain, the first viewport defines the size of the default target
+    if (mTarget == &mDefaultTarget && !mDefaultTarget.Width && !mDefaultTarget.Height) {
+        Resize(x + width, y + height);
+    }
+    mViewport = { x, y, width, height };
+}
+
+
+// Methods
+void SWRasterizer::Submit(PrimitiveType primitive, const uint32_t *indices, size_t count, int32_t vertexOffset, bool depthWrite) {
+    if (!mPipeline || !mFormat || mFormat->Position < 0 || !mFormat->Stride || mVertices.empty() || !count) return;
+    if (!mTarget->Width || !mTarget->Height) return;
+    PrepareBins();
+
+    // Vertex Stage: Every vertex in the referenced range is transformed once, the work is split across the workers.
+    // Batches are streamed into a ring and drawn with a base vertex, so the range rarely starts at zero.
+    const auto &format = *mFormat;
+    const auto *vertices = mVertices.data();
+    auto vertexCount = static_cast<int64_t>(mVertices.size() / format.Stride);
+    auto lowest = std::numeric_limits<int64_t>::max();
+    int64_t highest = -1;
+    for (size_t i = 0; i < count; i++) {
+        auto index = static_cast<int64_t>(indices[i]) + vertexOffset;
+        lowest = std::min(lowest, index);
+        highest = std::max(highest, index);
+    }
+    lowest = std::max<int64_t>(lowest, 0);
+    highest = std::min(highest, vertexCount - 1);
+    if (highest < lowest) return;
+    auto first = static_cast<size_t>(lowest);
+    auto used = static_cast<size_t>(highest - lowest + 1);
+
+    auto transform = GetTransform();
+    mTransformed.resize(used);
+    JobSystem::Instance().ParallelFor(used, 1024, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            const auto *vertex = vertices + (first + i) * format.Stride;
+            auto position = ReadAttribute(vertex, format.Position, glm::vec3(0.0f));
+            auto color = ReadAttribute(vertex, format.Color, glm::vec4(1.0f));
+            auto texCoord = ReadAttribute(vertex, format.TexCoord, glm::vec2(0.0f));
+            auto local = ReadAttribute(vertex, format.LocalPosition, glm::vec2(0.0f));
+
+            auto &result = mTransformed[i];
+            result.Position = transform * glm::vec4(position, 1.0f);
+            result.Attributes = { color.r, color.g, color.b, color.a, texCoord.x, texCoord.y, local.x, local.y };
+        }
+    });
+
+    // Primitive Stage: Clip, cull, set up and bin the primitives in submission order
+    DrawState state {};
+    state.Program = mProgram.Program;
+    state.Blend = mPipeline->BlendMode;
+    state.DepthTest = mPipeline->DepthTest;
+    state.DepthWrite = mPipeline->DepthWritable && depthWrite;
+    state.Textures = mTextures;
+    mStates.push_back(std::move(state));
+    auto triangles = mTriangles.size();
+
+    auto fetch = [&](size_t i) -> const ClipVertex * {
+        auto index = static_cast<int64_t>(indices[i]) + vertexOffset;
+        if (index < lowest || index > highest) return nullptr;
+        return &mTransformed[static_cast<size_t>(index - lowest)];
+    };
+    auto flat = [&](size_t i) -> FlatAttributes {
+        const auto *vertex = vertices + (static_cast<int64_t>(indices[i]) + vertexOffset) * format.Stride;
+        return {
+            ReadAttribute(vertex, format.TexIndex, 0.0f),
+            ReadAttribute(vertex, format.TilingFactor, 1.0f),
+            ReadAttribute(vertex, format.Thickness, 1.0f),
+            ReadAttribute(vertex, format.Fade, 0.005f),
+        };
+    };
+
+    if (primitive == PrimitiveType::Line) {
+        for (size_t i = 0; i + 1 < count; i += 2) {
+            auto *a = fetch(i);
+            auto *b = fetch(i + 1);
+            if (a && b) SubmitLine(*a, *b, flat(i));
+        }
+    } else {
+        auto wireframe = mPolygonMode == PolygonMode::Wireframe || mPipeline->Wireframe;
+        for (size_t i = 0; i + 2 < count; i += 3) {
+            auto *a = fetch(i);
+            auto *b = fetch(i + 1);
+            auto *c = fetch(i + 2);
+            if (!a || !b || !c) continue;
+            if (wireframe) {
+                auto attributes = flat(i);
+                SubmitLine(*a, *b, attributes);
+                SubmitLine(*b, *c, attributes);
+                SubmitLine(*c, *a, attributes);
+            } else {
+                SubmitTriangle(*a, *b, *c, flat(i));
+            }
+        }
+    }
+
+    if (mTriangles.size() == triangles) mStates.pop_back();
+}
+
+void SWRasterizer::SubmitLine(const ClipVertex &a, const ClipVertex &b, const FlatAttributes &flat) {
+    // Clip the segment parametrically against the view volume
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+    for (size_t plane = 0; plane <= ClipPlanes.size(); plane++) {
+        auto da = ClipDistance(a.Position, plane);
+        auto db = ClipDistance(b.Position, plane);
+        if (da < 0.0f && db < 0.0f) return;
+        if (da < 0.0f) t0 = std::max(t0, da / (da - db));
+        if (db < 0.0f) t1 = std::min(t1, da / (da - db));
+        if (t0 > t1) return;
+    }
+    auto lerp = [&](float t) {
+        ClipVertex result {};
+        result.Position = glm::mix(a.Position, b.Position, t);
+        for (size_t i = 0; i < VaryingCount; i++) result.Attributes[i] = a.Attributes[i] + (b.Attributes[i] - a.Attributes[i]) * t;
+        return result;
+    };
+    auto start = Project(lerp(t0));
+    auto end = Project(lerp(t1));
+
+    // Expand the line into a screen aligned quad with the configured thickness
+    glm::vec2 direction = glm::vec2(end.Position) - glm::vec2(start.Position);
+    auto length = glm::length(direction);
+    direction = length > 1e-6f ? direction / length : glm::vec2(1.0f, 0.0f);
+    auto offset = glm::vec2(-direction.y, direction.x) * (std::min(mLineThickness, 64.0f) * 0.5f);
+
+    auto corner = [&](const ScreenVertex &vertex, float sign) {
+        auto result = vertex;
+        result.Position.x += offset.x * sign;
+        result.Position.y += offset.y * sign;
+        return result;
+    };
+    auto v0 = corner(start, -1.0f);
+    auto v1 = corner(end, -1.0f);
+    auto v2 = corner(end, 1.0f);
+    auto v3 = corner(start, 1.0f);
+    Setup(v0, v1, v2, flat);
+    Setup(v0, v2, v3, flat);
+}
+
+void SWRasterizer::SubmitTriangle(const ClipVertex &a, const ClipVertex &b, const ClipVertex &c, const FlatAttributes &flat) {
+    constexpr size_t MaxPolygon = 3 + ClipPlanes.size() + 1;
+    array<ClipVertex, MaxPolygon> polygon { a, b, c };
+    size_t size = 3;
+
+    // Trivial rejection and acceptance, clipping is only needed for triangles crossing a plane
+    bool crossing = false;
+    for (size_t plane = 0; plane <= ClipPlanes.size(); plane++) {
+        auto outside = 0;
+        for (size_t i = 0; i < 3; i++) outside += ClipDistance(polygon[i].Position, plane) < 0.0f;
+        if (outside == 3) return;
+        crossing |= outside > 0;
+    }
+
+    if (crossing) {
+        // Sutherland-Hodgman in homogeneous clip space
+        for (size_t plane = 0; plane <= ClipPlanes.size() && size; plane++) {
+            array<ClipVertex, MaxPolygon> result {};
+            size_t count = 0;
+            for (size_t i = 0; i < size; i++) {
+                const auto &current = polygon[i];
+                const auto &next = polygon[(i + 1) % size];
+                auto dc = ClipDistance(current.Position, plane);
+                auto dn = ClipDistance(next.Position, plane);
+                if (dc >= 0.0f) result[count++] = current;
+                if ((dc >= 0.0f) != (dn >= 0.0f) && count < MaxPolygon) {
+                    auto t = dc / (dc - dn);
+                    auto &vertex = result[count++];
+                    vertex.Position = glm::mix(current.Position, next.Position, t);
+                    for (size_t j = 0; j < VaryingCount; j++) vertex.Attributes[j] = current.Attributes[j] + (next.Attributes[j] - current.Attributes[j]) * t;
+                }
+            }
+            polygon = result;
+            size = count;
+        }
+        if (size < 3) return;
+    }
+
+    array<ScreenVertex, MaxPolygon> projected {};
+    for (size_t i = 0; i < size; i++) projected[i] = Project(polygon[i]);
+
+    // Face Culling: The renderer uses clockwise front faces, in the top-down screen space they have a positive area
+    if (mPipeline->CullMode != CullMode::None) {
+        float area = 0.0f;
+        for (size_t i = 0; i < size; i++) {
+            const auto &p = projected[i].Position;
+            const auto &q = projected[(i + 1) % size].Position;
+            area += p.x * q.y - q.x * p.y;
+        }
+        switch (mPipeline->CullMode) {
+            case CullMode::Back:            { if (area < 0.0f) return; break; }
+            case CullMode::Front:           { if (area > 0.0f) return; break; }
+            case CullMode::BackAndFront:    { return; }
+            default:                        { break; }
+        }
+    }
+
+    for (size_t i = 1; i + 1 < size; i++) Setup(projected[0], projected[i], projected[i + 1], flat);
+}
+
+void SWRasterizer::Setup(const ScreenVertex &a, const ScreenVertex &b, const ScreenVertex &c, const FlatAttributes &flat) {
+    // Snap to the subpixel grid, so that shared edges produce identical edge functions
+    array<const ScreenVertex *, 3> vertices { &a, &b, &c };
+    array<int32_t, 3> x {};
+    array<int32_t, 3> y {};
+    for (size_t i = 0; i < 3; i++) {
+        x[i] = static_cast<int32_t>(std::lround(vertices[i]->Position.x * SubpixelScale));
+        y[i] = static_cast<int32_t>(std::lround(vertices[i]->Position.y * SubpixelScale));
+    }
+    auto area = static_cast<int64_t>(x[1] - x[0]) * (y[2] - y[0]) - static_cast<int64_t>(y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0) return;
+    if (area < 0) {
+        std::swap(vertices[1], vertices[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        area = -area;
+    }
+
+    // Bounds of the covered pixel centers, clamped to the viewport
+    auto viewport = GetViewport();
+    glm::ivec4 bounds {
+        FloorDivide(std::min({ x[0], x[1], x[2] }) - SubpixelCenter + SubpixelScale - 1, SubpixelScale),
+        FloorDivide(std::min({ y[0], y[1], y[2] }) - SubpixelCenter + SubpixelScale - 1, SubpixelScale),
+        FloorDivide(std::max({ x[0], x[1], x[2] }) - SubpixelCenter, SubpixelScale),
+        FloorDivide(std::max({ y[0], y[1], y[2] }) - SubpixelCenter, SubpixelScale),
+    };
+    bounds.x = std::max(bounds.x, viewport.x);
+    bounds.y = std::max(bounds.y, viewport.y);
+    bounds.z = std::min(bounds.z, viewport.x + viewport.z - 1);
+    bounds.w = std::min(bounds.w, viewport.y + viewport.w - 1);
+    if (mScissorEnabled) {
+        auto scissor = ToTargetRect(mScissor);
+        bounds.x = std::max(bounds.x, scissor.x);
+        bounds.y = std::max(bounds.y, scissor.y);
+        bounds.z = std::min(bounds.z, scissor.x + scissor.z - 1);
+        bounds.w = std::min(bounds.w, scissor.y + scissor.w - 1);
+    }
+    if (bounds.x > bounds.z || bounds.y > bounds.w) return;
+
+    Triangle triangle {};
+    triangle.Bounds = bounds;
+    triangle.Flat = flat;
+    triangle.State = static_cast<uint32_t>(mStates.size() - 1);
+    for (size_t i = 0; i < 3; i++) {
+        auto j = (i + 1) % 3;
+        auto edgeA = y[i] - y[j];
+        auto edgeB = x[j] - x[i];
+        auto edgeC = static_cast<int64_t>(x[i]) * y[j] - static_cast<int64_t>(y[i]) * x[j];
+        // Top-Left Rule: Pixel centers exactly on an edge only belong to the triangle if it is a top or left edge
+        auto topLeft = edgeA > 0 || (edgeA == 0 && edgeB > 0);
+        triangle.A[i] = edgeA;
+        triangle.B[i] = edgeB;
+        triangle.C[i] = topLeft ? edgeC : edgeC - 1;
+    }
+
+    // Interpolation planes for depth, 1/w and the attributes divided by w
+    array<glm::vec2, 3> positions {};
+    for (size_t i = 0; i < 3; i++) positions[i] = { float(x[i]) / SubpixelScale, float(y[i]) / SubpixelScale };
+    auto inverseArea = float(SubpixelScale * SubpixelScale) / float(area);
+    const auto &p0 = vertices[0]->Position;
+    const auto &p1 = vertices[1]->Position;
+    const auto &p2 = vertices[2]->Position;
+    triangle.Depth = ComputePlane(positions, inverseArea, p0.z, p1.z, p2.z);
+    triangle.InverseW = ComputePlane(positions, inverseArea, p0.w, p1.w, p2.w);
+    for (size_t i = 0; i < VaryingCount; i++) {
+        triangle.Attributes[i] = ComputePlane(positions, inverseArea, vertices[0]->Attributes[i], vertices[1]->Attributes[i], vertices[2]->Attributes[i]);
+    }
+
+    // Binning: Tiles where one of the edges excludes all four corners are skipped
+    auto index = static_cast<uint32_t>(mTriangles.size());
+    auto tileSize = static_cast<int32_t>(TileSize);
+    for (auto ty = bounds.y / tileSize; ty <= bounds.w / tileSize; ty++) {
+        for (auto tx = bounds.x / tileSize; tx <= bounds.z / tileSize; tx++) {
+            int64_t x0 = static_cast<int64_t>(std::max(tx * tileSize, bounds.x)) * SubpixelScale + SubpixelCenter;
+            int64_t y0 = static_cast<int64_t>(std::max(ty * tileSize, bounds.y)) * SubpixelScale + SubpixelCenter;
+            int64_t x1 = static_cast<int64_t>(std::min(tx * tileSize + tileSize - 1, bounds.z)) * SubpixelScale + SubpixelCenter;
+            int64_t y1 = static_cast<int64_t>(std::min(ty * tileSize + tileSize - 1, bounds.w)) * SubpixelScale + SubpixelCenter;
+
+            bool overlaps = true;
+            for (size_t e = 0; e < 3 && overlaps; e++) {
+                auto px = triangle.A[e] >= 0 ? x1 : x0;
+                auto py = triangle.B[e] >= 0 ? y1 : y0;
+                overlaps = triangle.A[e] * px + triangle.B[e] * py + triangle.C[e] >= 0;
+            }
+            if (overlaps) mBins[static_cast<size_t>(ty) * mTilesX + tx].push_back(index);
+        }
+    }
+    mTriangles.push_back(triangle);
+}
+
+SWRasterizer::ScreenVertex SWRasterizer::Project(const ClipVertex &vertex) const {
+    auto viewport = glm::vec4(GetViewport());
+    auto inverseW = 1.0f / vertex.Position.w;
+    auto ndc = glm::vec3(vertex.Position) * inverseW;
+
+    ScreenVertex result {};
+    result.Position = {
+        viewport.x + (ndc.x + 1.0f) * 0.5f * viewport.z,
+        viewport.y + (1.0f - ndc.y) * 0.5f * viewport.w,
+        ndc.z * 0.5f + 0.5f,
+        inverseW,
+    };
+    for (size_t i = 0; i < VaryingCount; i++) result.Attributes[i] = vertex.Attributes[i] * inverseW;
+    return result;
+}
+
+void SWRasterizer::PrepareBins() {
+    auto tilesX = (mTarget->Width + TileSize - 1) / TileSize;
+    auto tilesY = (mTarget->Height + TileSize - 1) / TileSize;
+    if (tilesX == mTilesX && tilesY == mTilesY) return;
+
+    mTilesX = tilesX;
+    mTilesY = tilesY;
+    mBins.assign(static_cast<size_t>(tilesX) * tilesY, {});
+}
+
+void SWRasterizer::RasterizeTile(uint32_t tile) {
+    auto &target = *mTarget;
+    auto width = static_cast<int32_t>(target.Width);
+    auto tileX = static_cast<int32_t>((tile % mTilesX) * TileSize);
+    auto tileY = static_cast<int32_t>((tile / mTilesX) * TileSize);
+    auto tileRight = std::min(tileX + static_cast<int32_t>(TileSize), width) - 1;
+    auto tileBottom = std::min(tileY + static_cast<int32_t>(TileSize), static_cast<int32_t>(target.Height)) - 1;
+    auto *colors = target.Color->Texels.data();
+    auto *depths = target.Depth.data();
+
+    if (mClearPending) {
+        auto color = PackColor(mClearColor);
+        for (auto y = tileY; y <= tileBottom; y++) {
+            auto offset = static_cast<size_t>(y) * width;
+            std::fill(colors + offset + tileX, colors + offset + tileRight + 1, color);
+            std::fill(depths + offset + tileX, depths + offset + tileRight + 1, 1.0f);
+        }
+    }
+
+    for (auto index : mBins[tile]) {
+        const auto &triangle = mTriangles[index];
+        const auto &state = mStates[triangle.State];
+        auto minX = std::max(triangle.Bounds.x, tileX);
+        auto minY = std::max(triangle.Bounds.y, tileY);
+        auto maxX = std::min(triangle.Bounds.z, tileRight);
+        auto maxY = std::min(triangle.Bounds.w, tileBottom);
+        if (minX > maxX || minY > maxY) continue;
+
+        // Edge values at the first pixel center, the clamping keeps the sign for the whole tile
+        array<int32_t, 3> row {};
+        array<int32_t, 3> stepX {};
+        array<int32_t, 3> stepY {};
+        auto px = static_cast<int64_t>(minX) * SubpixelScale + SubpixelCenter;
+        auto py = static_cast<int64_t>(minY) * SubpixelScale + SubpixelCenter;
+        for (size_t e = 0; e < 3; e++) {
+            row[e] = static_cast<int32_t>(std::clamp(triangle.A[e] * px + triangle.B[e] * py + triangle.C[e], -EdgeLimit, EdgeLimit));
+            stepX[e] = triangle.A[e] * SubpixelScale;
+            stepY[e] = triangle.B[e] * SubpixelScale;
+        }
+
+        // Orthographic projections (2D and UI) have a constant w, so the division per pixel can be skipped
+        auto affine = triangle.InverseW.x == 0.0f && triangle.InverseW.y == 0.0f;
+        auto inverseW = 1.0f / triangle.InverseW.z;
+
+    #if defined(SW_SIMD_SSE2)
+        __m128i laneOffsets[3];
+        for (size_t e = 0; e < 3; e++) laneOffsets[e] = _mm_setr_epi32(0, stepX[e], stepX[e] * 2, stepX[e] * 3);
+        auto depthOffsets = _mm_setr_ps(0.0f, triangle.Depth.x, triangle.Depth.x * 2.0f, triangle.Depth.x * 3.0f);
+    #endif
+
+        for (auto y = minY; y <= maxY; y++) {
+            auto offset = static_cast<size_t>(y) * width;
+            auto edges = row;
+            auto centerY = y + 0.5f;
+
+            for (auto x = minX; x <= maxX; x += 4) {
+                auto remaining = maxX - x + 1;
+                uint32_t lanes = remaining >= 4 ? 0xfu : (1u << remaining) - 1u;
+                auto depthBase = EvaluatePlane(triangle.Depth, x + 0.5f, centerY);
+                alignas(16) array<float, 4> depth {};
+                alignas(16) array<float, 4> stored { 1.0f, 1.0f, 1.0f, 1.0f };
+                if (state.DepthTest) for (int32_t i = 0; i < std::min(remaining, 4); i++) stored[i] = depths[offset + x + i];
+
+                // Coverage and depth test for four pixels at once
+            #if defined(SW_SIMD_SSE2)
+                auto w0 = _mm_add_epi32(_mm_set1_epi32(edges[0]), laneOffsets[0]);
+                auto w1 = _mm_add_epi32(_mm_set1_epi32(edges[1]), laneOffsets[1]);
+                auto w2 = _mm_add_epi32(_mm_set1_epi32(edges[2]), laneOffsets[2]);
+                auto negative = _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_or_si128(w0, w1), w2)));
+                uint32_t mask = ~static_cast<uint32_t>(negative) & lanes;
+
+                auto z = _mm_add_ps(_mm_set1_ps(depthBase), depthOffsets);
+                _mm_store_ps(depth.data(), z);
+                if (mask && state.DepthTest) mask &= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(z, _mm_load_ps(stored.data()))));
+            #else
+                uint32_t mask = 0;
+                for (uint32_t i = 0; i < 4; i++) {
+                    auto inside = (edges[0] + stepX[0] * int32_t(i)) >= 0 && (edges[1] + stepX[1] * int32_t(i)) >= 0 && (edges[2] + stepX[2] * int32_t(i)) >= 0;
+                    depth[i] = depthBase + triangle.Depth.x * i;
+                    if (inside && (!state.DepthTest || depth[i] <= stored[i])) mask |= 1u << i;
+                }
+                mask &= lanes;
+            #endif
+                for (size_t e = 0; e < 3; e++) edges[e] += stepX[e] * 4;
+                if (!mask) continue;
+
+                // Shading and blending per covered pixel
+                for (uint32_t i = 0; i < 4; i++) {
+                    if (!(mask & (1u << i))) continue;
+                    auto centerX = x + i + 0.5f;
+                    auto w = affine ? inverseW : 1.0f / EvaluatePlane(triangle.InverseW, centerX, centerY);
+                    auto attribute = [&](size_t k) { return EvaluatePlane(triangle.Attributes[k], centerX, centerY) * w; };
+                    glm::vec4 color { attribute(0), attribute(1), attribute(2), attribute(3) };
+
+                    switch (state.Program) {
+                        case SWProgram::Texture: {
+                            auto slot = static_cast<uint32_t>(std::max(std::lround(triangle.Flat[0]), 0l));
+                            const auto *texture = slot < MaxTextureSlots ? state.Textures[slot].get() : nullptr;
+                            if (texture) color *= texture->Sample(glm::vec2(attribute(4), attribute(5)) * triangle.Flat[1]);
+                            break;
+                        }
+                        case SWProgram::Circle: {
+                            auto thickness = triangle.Flat[2];
+                            auto fade = std::max(triangle.Flat[3], 1e-6f);
+                            auto distance = 1.0f - glm::length(glm::vec2(attribute(6), attribute(7)));
+                            auto circle = glm::smoothstep(0.0f, fade, distance) * glm::smoothstep(thickness + fade, thickness, distance);
+                            if (circle == 0.0f) continue;
+                            color.a *= circle;
+                            break;
+                        }
+                        default: {
+                            break;
+                        }
+                    }
+
+                    auto pixel = offset + x + i;
+                    if (state.DepthTest && state.DepthWrite) depths[pixel] = depth[i];
+                    switch (state.Blend) {
+                        case BlendMode::Additive: { color += UnpackColor(colors[pixel]); break; }
+                        case BlendMode::Alpha:    { color = color * color.a + UnpackColor(colors[pixel]) * (1.0f - color.a); break; }
+                        case BlendMode::Multiply: { color += UnpackColor(colors[pixel]) * (1.0f - color.a); break; }
+                        default:                  { break; }
+                    }
+                    colors[pixel] = PackColor(color);
+                }
+            }
+            for (size_t e = 0; e < 3; e++) row[e] += stepY[e];
+        }
+    }
+}
+
+glm::mat4 SWRasterizer::GetTransform() const {
+    auto read = [this](uint32_t binding, size_t offset, glm::mat4 &matrix) {
+        const auto &uniform = mUniforms[binding];
+        if (uniform.size() < offset + sizeof(glm::mat4)) return false;
+        std::memcpy(&matrix, uniform.data() + offset, sizeof(glm::mat4));
+        return true;
+    };
+
+    glm::mat4 result(1.0f);
+    glm::mat4 other(1.0f);
+    switch (mProgram.Transform) {
+        case SWTransform::Camera: {
+            read(1, 0, result);
+            break;
+        }
+        case SWTransform::CameraEntity: {
+            // EntityData starts with a vec4 color, followed by the transform
+            read(1, 0, result);
+            if (read(4, sizeof(glm::vec4), other)) result *= other;
+            break;
+        }
+        case SWTransform::ProjectionView: {
+            read(0, 0, result);
+            if (read(0, sizeof(glm::mat4), other)) result *= other;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    return result;
+}
+
+glm::ivec4 SWRasterizer::GetViewport() const {
+    if (!mViewport.z || !mViewport.w) return { 0, 0, static_cast<int32_t>(mTarget->Width), static_cast<int32_t>(mTarget->Height) };
+    return ToTargetRect(mViewport);
+}
+
+glm::ivec4 SWRasterizer::ToTargetRect(const glm::uvec4 &rect) const {
+    // The origin is bottom-left like in OpenGL, the result is top-down and clamped to the target
+    auto width = static_cast<int32_t>(mTarget->Width);
+    auto height = static_cast<int32_t>(mTarget->Height);
+    auto x = std::min(static_cast<int32_t>(rect.x), width);
+    auto y = std::clamp(height - static_cast<int32_t>(rect.y + rect.w), 0, height);
+    auto right = std::min(static_cast<int32_t>(rect.x + rect.z), width);
+    auto bottom = std::clamp(height - static_cast<int32_t>(rect.y), 0, height);
+    return { x, y, right - x, bottom - y };
+}
+
+}
@@ -0,0 +1,216 @@
+﻿export module Ultra.Platform.Renderer.SWRasterizer;
+
+import Ultra.Core;
+import Ultra.Logger;
+import Ultra.Math;
+import Ultra.Renderer.PipelineState;
+import Ultra.Renderer.RenderDevice;
+import Ultra.Renderer.Texture;
+
+export namespace Ultra {
+
+///
+/// @brief Image with RGBA8 texels (red in the lowest byte), used for textures and color targets.
+///
+struct SWImage {
+    uint32_t Width {};
+    uint32_t Height {};
+    TextureFilter Filter = TextureFilter::Linear;
+    TextureWrap Wrap = TextureWrap::Repeat;
+    vector<uint32_t> Texels;
+
+    glm::vec4 Sample(const glm::vec2 &coordinate) const;
+};
+
+///
+/// @brief Color and depth surface, which the rasterizer splits into tiles.
+///
+struct SWTarget {
+    void Resize(uint32_t width, uint32_t height);
+
+    uint32_t Width {};
+    uint32_t Height {};
+    Reference<SWImage> Color = CreateReference<SWImage>();
+    vector<float> Depth;
+};
+
+///
+/// @brief The software backend can't execute GLSL, so the shaders are mapped onto these fixed-function programs.
+///
+enum class SWProgram {
+    Color,      // Interpolated vertex color
+    Texture,    // Texture slot (aTexIndex) sampled with the tiled coordinate and multiplied with the vertex color
+    Circle,     // Sprite circle with thickness and fade, fragments outside are discarded
+};
+
+enum class SWTransform {
+    None,               // Position is already in clip space
+    Camera,             // uCamera.ViewProjection (binding 1)
+    CameraEntity,       // uCamera.ViewProjection * uEntity.Transform (binding 1 and 4)
+    ProjectionView,     // uProjection * uView (binding 0)
+};
+
+struct SWShaderProgram {
+    SWProgram Program = SWProgram::Color;
+    SWTransform Transform = SWTransform::None;
+};
+
+///
+/// @brief Byte offsets of the attributes the fixed-function programs understand, resolved once from the vertex layout.
+///
+struct SWVertexFormat {
+    static SWVertexFormat Create(const VertexBufferLayout &layout, VertexInputRate rate = VertexInputRate::Vertex);
+
+    bool Instanced = false;
+    int32_t Position = -1;
+    int32_t Color = -1;
+    int32_t TexCoord = -1;
+    int32_t TexIndex = -1;
+    int32_t TilingFactor = -1;
+    int32_t LocalPosition = -1;
+    int32_t Thickness = -1;
+    int32_t Fade = -1;
+    // Instanced quads: affine transform rows (aTransformX, aTransformY), depth and texture rectangle
+    int32_t TransformX = -1;
+    int32_t TransformY = -1;
+    int32_t Depth = -1;
+    int32_t TexRect = -1;
+    uint32_t Stride {};
+};
+
+
+///
+/// @brief Multithreaded tile-based rasterizer behind the Software backend.
+/// Draws are transformed, clipped and binned into 64x64 tiles on submission, 'Flush' rasterizes all tiles in parallel on the job system.
+/// Each tile processes its triangles in submission order, so the result is deterministic and independent of the worker count.
+///
+/// @note Edge functions and the depth test are evaluated for four pixels at once (SSE2 where available, scalar otherwise).
+///
+class SWRasterizer {
+    SWRasterizer();
+
+public:
+    static constexpr uint32_t MaxTextureSlots = 32;
+    static constexpr uint32_t MaxUniformBindings = 16;
+    static constexpr uint32_t TileSize = 64;
+    static constexpr uint32_t MaxTargetSize = 8192;
+
+    ~SWRasterizer() = default;
+
+    // Get the global instance
+    static SWRasterizer &Instance() {
+        static SWRasterizer instance;
+        return instance;
+    }
+
+    // Commands
+    void Clear(const glm::vec4 &color);
+    void Draw(PrimitiveType primitive, size_t count, size_t first = 0, bool depthWrite = true);
+    void DrawIndexed(PrimitiveType primitive, size_t count, size_t first = 0, int32_t vertexOffset = 0, bool depthWrite = true);
+    void DrawInstanced(PrimitiveType primitive, size_t count, size_t instances, size_t first = 0, uint32_t firstInstance = 0, bool depthWrite = true);
+    void Flush();
+    void Present(void *window);
+
+    // Bindings
+    void BindIndexBuffer(const uint32_t *data, size_t size) { mIndices = { data, size / sizeof(uint32_t) }; }
+    void BindPipeline(const PipelineProperties *properties, const SWVertexFormat *format) { mPipeline = properties; mFormat = format; }
+    void BindProgram(const SWShaderProgram &program) { mProgram = program; }
+    void BindTarget(SWTarget *target);
+    void BindTexture(uint32_t slot, const Reference<SWImage> &image) { if (slot < MaxTextureSlots) mTextures[slot] = image; }
+    void BindUniformBuffer(uint32_t binding, const byte *data, size_t size) { if (binding < MaxUniformBindings) mUniforms[binding] = { data, size }; }
+    void BindVertexBuffer(const byte *data, size_t size) { mVertices = { data, size }; }
+    void ReleaseBindings(const void *resource);
+
+    // Accessors
+    SWTarget &GetDefaultTarget() { return mDefaultTarget; }
+    SWTarget &GetTarget() { return *mTarget; }
+
+    // Mutators
+    void Resize(uint32_t width, uint32_t height);
+    void SetLineThickness(float value) { mLineThickness = std::max(value, 1.0f); }
+    void SetPolygonMode(PolygonMode mode) { mPolygonMode = mode; }
+    void SetScissor(bool enabled, uint32_t x = 0, uint32_t y = 0, uint32_t width = 0, uint32_t height = 0) { mScissorEnabled = enabled; mScissor = { x, y, width, height }; }
+    void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+private:
+    // Types
+    static constexpr size_t VaryingCount = 8;   // Color (4), TexCoord (2), LocalPosition (2)
+    using Varyings = array<float, VaryingCount>;
+    using FlatAttributes = array<float, 4>;     // TexIndex, TilingFactor, Thickness, Fade
+
+    struct ClipVertex {
+        glm::vec4 Position {};
+        Varyings Attributes {};
+    };
+
+    struct ScreenVertex {
+        glm::vec4 Position {};  // Pixel coordinates, depth in [0, 1] and 1/w
+        Varyings Attributes {}; // Divided by w for perspective correct interpolation
+    };
+
+    struct DrawState {
+        SWProgram Program {};
+        BlendMode Blend {};
+        bool DepthTest {};
+        bool DepthWrite {};
+        array<Reference<SWImage>, MaxTextureSlots> Textures {};
+    };
+
+    struct Triangle {
+        // Edge functions in subpixel units 'A * x + B * y + C', the top-left fill rule is part of 'C'
+        array<int32_t, 3> A {};
+        array<int32_t, 3> B {};
+        array<int64_t, 3> C {};
+        glm::ivec4 Bounds {};
+        // Planes over pixel centers 'x * dx + y * dy + c'
+        glm::vec3 Depth {};
+        glm::vec3 InverseW {};
+        array<glm::vec3, VaryingCount> Attributes {};
+        FlatAttributes Flat {};
+        uint32_t State {};
+    };
+
+    // Methods
+    void Submit(PrimitiveType primitive, const uint32_t *indices, size_t count, int32_t vertexOffset, bool depthWrite);
+    void SubmitLine(const ClipVertex &a, const ClipVertex &b, const FlatAttributes &flat);
+    void SubmitTriangle(const ClipVertex &a, const ClipVertex &b, const ClipVertex &c, const FlatAttributes &flat);
+    void Setup(const ScreenVertex &a, const ScreenVertex &b, const ScreenVertex &c, const FlatAttributes &flat);
+    ScreenVertex Project(const ClipVertex &vertex) const;
+    void PrepareBins();
+    void RasterizeTile(uint32_t tile);
+    glm::mat4 GetTransform() const;
+    glm::ivec4 GetViewport() const;
+    glm::ivec4 ToTargetRect(const glm::uvec4 &rect) const;
+
+    // Properties
+    SWTarget mDefaultTarget;
+    SWTarget *mTarget = &mDefaultTarget;
+    glm::uvec4 mViewport {};
+    glm::uvec4 mScissor {};
+    bool mScissorEnabled = false;
+    float mLineThickness = 1.0f;
+    PolygonMode mPolygonMode = PolygonMode::Solid;
+
+    // Bindings
+    std::span<const uint32_t> mIndices;
+    std::span<const byte> mVertices;
+    array<std::span<const byte>, MaxUniformBindings> mUniforms {};
+    array<Reference<SWImage>, MaxTextureSlots> mTextures {};
+    const PipelineProperties *mPipeline = nullptr;
+    const SWVertexFormat *mFormat = nullptr;
+    SWShaderProgram mProgram {};
+
+    // Pending Work
+    bool mClearPending = false;
+    glm::vec4 mClearColor {};
+    uint32_t mTilesX {};
+    uint32_t mTilesY {};
+    vector<DrawState> mStates;
+    vector<Triangle> mTriangles;
+    vector<vector<uint32_t>> mBins;
+    vector<ClipVertex> mTransformed;
+    vector<byte> mExpandedVertices;
+    vector<uint32_t> mExpandedIndices;
+};
+
+}
@@ -1,9 +1,7 @@
 ﻿module Ultra.Platform.Renderer.SWRenderDevice;
 
 import Ultra.Renderer;
-
-#pragma warning(push)
-#pragma warning(disable: 4100)
+import Ultra.Platform.Renderer.SWRasterizer;
 
 namespace Ultra {
 
@@ -12,18 +10,38 @@ SWRenderDevice::SWRenderDevice() {}
 SWRenderDevice::~SWRenderDevice() {}
 
 
-void SWRenderDevice::Load() {};
+void SWRenderDevice::Load() {
+    // Information
+    auto &capabilities = RenderDevice::GetCapabilities();
+    capabilities.Vendor = "Ultra";
+    capabilities.Model = "Software Rasterizer";
+    capabilities.Version = "1.0";
+    capabilities.SLVersion = "Fixed-Function";
 
-void SWRenderDevice::BeginFrame() {};
+    // Limits
+    capabilities.MaxAnisotropy = 1.0f;
+    capabilities.MaxSamples = 1;
+    capabilities.MaxTextureUnits = static_cast<int>(SWRasterizer::MaxTextureSlots);
+    capabilities.UniformBufferAlignment = 16;
+    capabilities.Log();
+};
 
-void SWRenderDevice::EndFrame() {};
+void SWRenderDevice::BeginFrame() {};
 
-void SWRenderDevice::Dispose() {}
+void SWRenderDevice::EndFrame() {
+    SWRasterizer::Instance().Flush();
+};
 
-void SWRenderDevice::SetLineThickness(float value) {}
+void SWRenderDevice::Dispose() {
+    SWRasterizer::Instance().Flush();
+}
 
-void SWRenderDevice::SetPolygonMode(PolygonMode mode) {}
+void SWRenderDevice::SetLineThickness(float value) {
+    SWRasterizer::Instance().SetLineThickness(value);
+}
 
+void SWRenderDevice::SetPolygonMode(PolygonMode mode) {
+    SWRasterizer::Instance().SetPolygonMode(mode);
 }
 
-#pragma warning(pop)
+}
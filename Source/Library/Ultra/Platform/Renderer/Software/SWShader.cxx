@@ -5,70 +5,103 @@
 
 namespace Ultra {
 
-SWShader::SWShader(const string &source, const string &entryPoint, const ShaderType type): Shader(source, entryPoint, type) {}
+SWShader::SWShader(const string &source, const string &entryPoint, const ShaderType type): Shader(source, entryPoint, type) {
+    auto shaderCode = source;
+    auto shaders = Convert(shaderCode);
+    Compile(shaders);
+}
 
 SWShader::~SWShader() {}
 
 
-void SWShader::Compile(ShaderList shaders) {}
+void SWShader::Compile(ShaderList shaders) {
+    // GLSL can't be executed on the CPU, so the stages are mapped onto the fixed-function programs of the rasterizer
+    const auto &vertex = shaders.contains((size_t)ShaderType::Vertex) ? shaders[(size_t)ShaderType::Vertex] : mSource;
+    const auto &fragment = shaders.contains((size_t)ShaderType::Fragment) ? shaders[(size_t)ShaderType::Fragment] : mSource;
+    auto contains = [](const string &code, string_view token) { return code.find(token) != string::npos; };
+
+    if (contains(vertex, "uEntity.Transform")) {
+        mProgram.Transform = SWTransform::CameraEntity;
+    } else if (contains(vertex, "uCamera.ViewProjection")) {
+        mProgram.Transform = SWTransform::Camera;
+    } else if (contains(vertex, "uProjection")) {
+        mProgram.Transform = SWTransform::ProjectionView;
+    } else {
+        mProgram.Transform = SWTransform::None;
+    }
+
+    if (contains(fragment, "LocalPosition") && contains(fragment, "smoothstep")) {
+        mProgram.Program = SWProgram::Circle;
+    } else if (contains(fragment, "texture(")) {
+        mProgram.Program = SWProgram::Texture;
+    } else {
+        mProgram.Program = SWProgram::Color;
+    }
+    mShaders = std::move(shaders);
+}
 
-void SWShader::Bind() const {}
+void SWShader::Bind() const {
+    SWRasterizer::Instance().BindProgram(mProgram);
+}
 
-void SWShader::Unbind() const {}
+void SWShader::Unbind() const {
+    SWRasterizer::Instance().BindProgram({});
+}
 
 
 int32_t SWShader::FindUniformLocation(const string &name) const {
-    return 0;
+    // There are no uniform locations, the data reaches the rasterizer through uniform buffers
+    return -1;
 }
 
 
-void SWShader::UpdateUniformBuffer(const string &name, const void *data, size_t size) {}
+void SWShader::UpdateUniformBuffer(UniformHandle uniform, const void *data, size_t size) {}
 
-void SWShader::UpdateUniform(const string &name, const Bool &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Bool &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Bool2 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Bool2 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Bool3 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Bool3 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Bool4 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Bool4 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Double &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Double &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Double2 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Double2 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Double3 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Double3 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Double4 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Double4 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Float &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Float &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Float2 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Float2 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Float3 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Float3 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Float4 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Float4 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Int &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Int &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Int2 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Int2 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Int3 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Int3 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Int4 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Int4 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const UInt &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const UInt &data) {}
 
-void SWShader::UpdateUniform(const string &name, const UInt2 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const UInt2 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const UInt3 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const UInt3 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const UInt4 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const UInt4 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Matrix2 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Matrix2 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Matrix3 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Matrix3 &data) {}
 
-void SWShader::UpdateUniform(const string &name, const Matrix4 &data) {}
+void SWShader::UpdateUniform(UniformHandle uniform, const Matrix4 &data) {}
 
 }
 
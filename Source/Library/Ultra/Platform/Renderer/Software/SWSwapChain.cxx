@@ -1,22 +1,34 @@
 ﻿module Ultra.Platform.Renderer.SWSwapchain;
 
-#pragma warning(push)
-#pragma warning(disable: 4100)
+import Ultra.Platform.Renderer.SWRasterizer;
+import Ultra.Platform.Renderer.SWTexture;
 
 namespace Ultra {
 
-SWSwapchain::SWSwapchain(void *windowHandle, uint32_t width, uint32_t height): Swapchain(windowHandle, width, height) {}
+SWSwapchain::SWSwapchain(void *windowHandle, uint32_t width, uint32_t height): Swapchain(windowHandle, width, height) {
+    Resize(width, height);
+}
 
 SWSwapchain::~SWSwapchain() {}
 
 
-void SWSwapchain::Present() {}
+void SWSwapchain::Present() {
+    SWRasterizer::Instance().Present(mWindowHandle);
+}
 
-void SWSwapchain::Resize(uint32_t width, uint32_t height) {}
+void SWSwapchain::Resize(uint32_t width, uint32_t height) {
+    mWidth = static_cast<int>(width);
+    mHeight = static_cast<int>(height);
+    SWRasterizer::Instance().Resize(width, height);
+    mCurrentTexture = nullptr;
+}
 
 
 Reference<Texture> SWSwapchain::GetCurrentTexture() {
-    return nullptr;
+    // The swapchain has a single image, which is the default target of the rasterizer
+    auto &target = SWRasterizer::Instance().GetDefaultTarget();
+    if (!mCurrentTexture) mCurrentTexture = CreateReference<SWTexture>(TextureProperties { target.Width, target.Height, TextureFormat::RGBA8 }, target.Color);
+    return mCurrentTexture;
 }
 
 uint32_t SWSwapchain::GetCurrentImageIndex() {
@@ -24,5 +36,3 @@ uint32_t SWSwapchain::GetCurrentImageIndex() {
 }
 
 }
-
-#pragma warning(pop)
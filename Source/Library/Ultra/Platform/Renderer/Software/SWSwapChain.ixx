@@ -13,6 +13,9 @@ public:
     virtual void Resize(uint32_t width, uint32_t height) override;
     virtual Reference<Texture> GetCurrentTexture() override;
     virtual uint32_t GetCurrentImageIndex() override;
+
+private:
+    Reference<Texture> mCurrentTexture;
 };
 
 }
@@ -1,21 +1,105 @@
 ﻿module Ultra.Platform.Renderer.SWTexture;
 
-#pragma warning(push)
-#pragma warning(disable: 4100)
+#pragma warning(push, 0)
+// The implementation is compiled with the OpenGL texture
+#define STB_IMAGE_STATIC
+import <stb/stb_image.h>;
+#pragma warning(pop)
+
+import Ultra.System.FileSystem;
 
 namespace Ultra {
 
-SWTexture::SWTexture(const TextureProperties &properties, const void *data, size_t size): Texture(properties, data, size) {}
+SWTexture::SWTexture(const TextureProperties &properties, const void *data, size_t size): Texture(properties, data, size) {
+    mTextureID = sTextureIDs++;
+    Load(data);
+}
+
+SWTexture::SWTexture(const TextureProperties &properties, const string &path): Texture(properties, nullptr, 0) {
+    mTextureID = sTextureIDs++;
+    if (!File::Exists(path)) {
+        LogError("The specified directory/file '{}' doesn't exist!", path);
+        Load(nullptr);
+        return;
+    }
+
+    int width {};
+    int height {};
+    int channels {};
+    auto *data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (!data) {
+        LogError("An error occurred while loading image '{}'!", path);
+        Load(nullptr);
+        return;
+    }
+
+    mProperties.Width = static_cast<uint32_t>(width);
+    mProperties.Height = static_cast<uint32_t>(height);
+    mProperties.Format = TextureFormat::RGBA8;
+    Load(data);
+    stbi_image_free(data);
+    LogTrace("The image '{}' was loaded successfully.", path);
+}
 
-SWTexture::SWTexture(const TextureProperties &properties, const string &path): Texture(properties, nullptr, 0) {}
+SWTexture::SWTexture(const TextureProperties &properties, const Reference<SWImage> &image): Texture(properties, nullptr, 0), mImage(image) {
+    mTextureID = sTextureIDs++;
+}
 
 SWTexture::~SWTexture() {}
 
 
-void SWTexture::Bind(uint32_t slot) const {}
+void SWTexture::Bind(uint32_t slot) const {
+    SWRasterizer::Instance().BindTexture(slot, mImage);
+}
+
+void SWTexture::Unbind(uint32_t slot) const {
+    SWRasterizer::Instance().BindTexture(slot, nullptr);
+}
 
-void SWTexture::Unbind(uint32_t slot) const {}
 
+void SWTexture::Load(const void *data) {
+    // Everything is converted to RGBA8, the size argument isn't reliable (glyphs pass the size of a pointer), so the dimensions are used
+    auto &image = *mImage;
+    image.Width = mProperties.Width;
+    image.Height = mProperties.Height;
+    image.Filter = mProperties.SamplerFilter;
+    image.Wrap = mProperties.SamplerWrap;
+    image.Texels.assign(static_cast<size_t>(image.Width) * image.Height, 0xffffffffu);
+    if (!data) return;
+
+    auto pack = [](float r, float g, float b, float a) {
+        auto convert = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+        return convert(r) | convert(g) << 8 | convert(b) << 16 | convert(a) << 24;
+    };
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    const auto *floats = static_cast<const float *>(data);
+    for (size_t i = 0; i < image.Texels.size(); i++) {
+        auto &texel = image.Texels[i];
+        switch (mProperties.Format) {
+            case TextureFormat::RGBA8: {
+                std::memcpy(&texel, bytes + i * 4, sizeof(uint32_t));
+                break;
+            }
+            case TextureFormat::RGB8: {
+                texel = bytes[i * 3] | bytes[i * 3 + 1] << 8 | bytes[i * 3 + 2] << 16 | 0xff000000u;
+                break;
+            }
+            case TextureFormat::R8: {
+                texel = bytes[i] | 0xff000000u;
+                break;
+            }
+            case TextureFormat::RGBA16F:
+            case TextureFormat::RGBA32F: {
+                // The data is always passed as 32-bit floats (like GLFormatDataType expects)
+                texel = pack(floats[i * 4], floats[i * 4 + 1], floats[i * 4 + 2], floats[i * 4 + 3]);
+                break;
+            }
+            default: {
+                LogWarning("SWTexture: The texture format isn't supported by the software renderer, a white texture is used instead!");
+                return;
+            }
+        }
+    }
 }
 
-#pragma warning(pop)
+}
@@ -1,6 +1,7 @@
 ﻿export module Ultra.Platform.Renderer.SWTexture;
 
 import Ultra.Renderer.Texture;
+import Ultra.Platform.Renderer.SWRasterizer;
 
 export namespace Ultra {
 
@@ -8,12 +9,21 @@ class SWTexture: public Texture {
 public:
     SWTexture(const TextureProperties &properties, const void *data, size_t size);
     SWTexture(const TextureProperties &properties, const string &path);
+    SWTexture(const TextureProperties &properties, const Reference<SWImage> &image);
     virtual ~SWTexture();
 
     virtual void Bind(uint32_t slot) const override;
     virtual void Unbind(uint32_t slot) const override;
 
+    // Accessors
+    const Reference<SWImage> &GetImage() const { return mImage; }
+
+private:
+    void Load(const void *data);
+
 private:
+    Reference<SWImage> mImage = CreateReference<SWImage>();
+    static inline std::atomic<RendererID> sTextureIDs = 1;
 };
 
 }
@@ -21,20 +21,10 @@ VKShader::~VKShader() {}
 
 
 void VKShader::Compile(ShaderList shaders) {
-    for (auto &[stage, code] : shaders) {
-        vector<uint32_t> shader {};
-
-        auto cache = "./Data/Cache/Shaders/" + mShaderName + "." + ShaderTypeToString((ShaderType)stage) + ".spirv";
-        if (File::Exists(cache)) {
-            shader = File::LoadAsBinary(cache);
-        } else {
-            shader = ShaderCompiler::Compile(mShaderName, (ShaderType)stage, code);
-
-            // Cache Shader
-            if (!shader.empty()) {
-                File::Write(cache, shader);
-            }
-        }
+    auto binaries = ShaderCompiler::CompileStages(mShaderName, shaders);
+    Reflect(binaries);
+    for (auto &[stage, shader] : binaries) {
+        if (shader.empty()) continue;
 
         //vk::ShaderModuleCreateInfo createInfo{};
         //createInfo.flags = vk::ShaderModuleCreateFlags(),
@@ -56,53 +46,53 @@ int32_t VKShader::FindUniformLocation(const string &name) const {
 }
 
 
-void VKShader::UpdateUniformBuffer(const string &name, const void *data, size_t size) {}
+void VKShader::UpdateUniformBuffer(UniformHandle uniform, const void *data, size_t size) {}
 
-void VKShader::UpdateUniform(const string &name, const Bool &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Bool &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Bool2 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Bool2 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Bool3 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Bool3 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Bool4 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Bool4 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Double &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Double &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Double2 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Double2 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Double3 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Double3 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Double4 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Double4 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Float &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Float &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Float2 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Float2 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Float3 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Float3 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Float4 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Float4 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Int &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Int &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Int2 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Int2 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Int3 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Int3 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Int4 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Int4 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const UInt &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const UInt &data) {}
 
-void VKShader::UpdateUniform(const string &name, const UInt2 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const UInt2 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const UInt3 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const UInt3 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const UInt4 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const UInt4 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Matrix2 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Matrix2 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Matrix3 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Matrix3 &data) {}
 
-void VKShader::UpdateUniform(const string &name, const Matrix4 &data) {}
+void VKShader::UpdateUniform(UniformHandle uniform, const Matrix4 &data) {}
 
 }
 
@@ -32,6 +32,17 @@ void WinEventListener::Update() {
 	}
 }
 
+void WinEventListener::Wait() {
+	// Message queues are bound to threads, so the waiting thread is remembered for wake-ups from outside.
+	mThreadId = GetCurrentThreadId();
+	WaitMessage();
+	Update();
+}
+
+void WinEventListener::Wake() {
+	if (auto thread = mThreadId.load()) PostThreadMessage(thread, WM_NULL, 0, 0);
+}
+
 intptr_t WinEventListener::Register(void *event) {
 	// Properties
 	LRESULT result = 1;
@@ -18,9 +18,15 @@ public:
     // Events
     virtual bool Callback(void *event) override;
     virtual void Update() override;
+    virtual void Wait() override;
+    virtual void Wake() override;
 
 private:
     intptr_t Register(void *event);
+
+private:
+    // Properties
+    atomic<uint32_t> mThreadId {};
 };
 
 }
@@ -3,6 +3,7 @@
 import Ultra.Graphics.Context;
 import Ultra.Platform.Renderer.DXBuffer;
 import Ultra.Platform.Renderer.GLBuffer;
+import Ultra.Platform.Renderer.SWBuffer;
 import Ultra.Platform.Renderer.VKBuffer;
 
 namespace Ultra {
@@ -11,6 +12,7 @@ Scope<Buffer> Buffer::Create(BufferType type, const void *data, size_t size, Buf
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateScope<DXBuffer>(type, data, size, usage); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLBuffer>(type, data, size, usage); }
+        case GraphicsAPI::Software: { return CreateScope<SWBuffer>(type, data, size, usage); }
         case GraphicsAPI::Vulkan:   { return CreateScope<VKBuffer>(type, data, size, usage); }
 
         default: {
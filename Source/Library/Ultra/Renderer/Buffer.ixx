@@ -22,7 +22,7 @@ enum class BufferType {
 enum class BufferUsage {
     Dynamic,
     Static,
-    Stream,
+    Stream,     // Persistently mapped, written through 'Map' and guarded by frame fences (see StreamBuffer)
 };
 
 ///
@@ -77,6 +77,8 @@ struct VertexBufferElement {
         }
     }
 
+    bool operator==(const VertexBufferElement &other) const = default;
+
     string Name;
     ShaderDataType Type;
     uint32_t Size;
@@ -99,6 +101,8 @@ public:
     [[nodiscard]] auto begin() const { return mElements.begin(); }
     [[nodiscard]] auto end() const { return mElements.end(); }
 
+    bool operator==(const VertexBufferLayout &other) const = default;
+
 private:
     void CalculateOffsetAndStride() {
         mStride = 0;
@@ -122,6 +126,8 @@ private:
 /// @example  auto indexBuffer = Buffer::Create(BufferType::Index, indices, sizeof(indices));
 /// @example  auto uniformBuffer = Buffer::Create(BufferType::Uniform, data, sizeof(data));
 ///
+/// @note Backends without mapping support return a nullptr from 'Map', the fences are optional as well.
+///
 class Buffer {
 protected:
     Buffer(BufferType type, const void *data, size_t size, BufferUsage usage): mType(type), mData(data), mSize(size), mUsage(usage) {}
@@ -137,6 +143,29 @@ public:
     virtual void Unbind() const = 0;
     virtual void UpdateData(const void *data, size_t size) = 0;
 
+    // Streaming
+    static constexpr uint32_t FramesInFlight = 3;
+
+    virtual void BindRange([[maybe_unused]] uint32_t binding, [[maybe_unused]] size_t offset, [[maybe_unused]] size_t size) const {}
+    virtual void *Map([[maybe_unused]] size_t offset, [[maybe_unused]] size_t size) { return nullptr; }
+    virtual void Unmap() {}
+
+    ///
+    /// @brief Marks the end of the commands, which read the data written during the frame.
+    ///
+    virtual void Fence([[maybe_unused]] uint32_t frame) {}
+    ///
+    /// @brief Blocks until the commands of the frame were executed, so its data can be overwritten.
+    ///
+    virtual void Wait([[maybe_unused]] uint32_t frame) {}
+    ///
+    /// @brief Checks without blocking, whether the commands of the frame were executed.
+    ///
+    virtual bool IsFinished([[maybe_unused]] uint32_t frame) const { return true; }
+
+    // Accessors
+    size_t GetSize() const { return mSize; }
+
 protected:
     RendererID mBufferID;
     BufferType mType;
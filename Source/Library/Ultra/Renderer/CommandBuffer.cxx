@@ -3,6 +3,7 @@
 import Ultra.Graphics.Context;
 import Ultra.Platform.Renderer.DXCommandBuffer;
 import Ultra.Platform.Renderer.GLCommandBuffer;
+import Ultra.Platform.Renderer.SWCommandBuffer;
 import Ultra.Platform.Renderer.VKCommandBuffer;
 
 namespace Ultra {
@@ -11,6 +12,7 @@ Scope<CommandBuffer> CommandBuffer::Create() {
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateScope<DXCommandBuffer>(); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLCommandBuffer>(); }
+        case GraphicsAPI::Software: { return CreateScope<SWCommandBuffer>(); }
         case GraphicsAPI::Vulkan:   { return CreateScope<VKCommandBuffer>(); }
 
         default: {
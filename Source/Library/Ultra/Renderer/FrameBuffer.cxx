@@ -3,6 +3,7 @@
 import Ultra.Graphics.Context;
 import Ultra.Platform.Renderer.DXFramebuffer;
 import Ultra.Platform.Renderer.GLFramebuffer;
+import Ultra.Platform.Renderer.SWFramebuffer;
 import Ultra.Platform.Renderer.VKFramebuffer;
 
 namespace Ultra {
@@ -11,6 +12,7 @@ Scope<Framebuffer> Framebuffer::Create(uint32_t width, uint32_t height, TextureF
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateScope<DXFramebuffer>(width, height, format); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLFramebuffer>(width, height, format); }
+        case GraphicsAPI::Software: { return CreateScope<SWFramebuffer>(width, height, format); }
         case GraphicsAPI::Vulkan:   { return CreateScope<VKFramebuffer>(width, height, format); }
 
         default: {
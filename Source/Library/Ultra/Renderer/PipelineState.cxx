@@ -3,14 +3,51 @@
 import Ultra.Graphics.Context;
 import Ultra.Platform.Renderer.DXPipelineState;
 import Ultra.Platform.Renderer.GLPipelineState;
+import Ultra.Platform.Renderer.SWPipelineState;
 import Ultra.Platform.Renderer.VKPipelineState;
 
 namespace Ultra {
 
+// Helpers
+namespace {
+
+size_t HashCombine(size_t seed, size_t value) {
+    return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+}
+
+size_t HashProperties(const PipelineProperties &properties) {
+    auto hash = std::hash<int>()(static_cast<int>(properties.BlendMode));
+    hash = HashCombine(hash, static_cast<size_t>(properties.CullMode));
+    hash = HashCombine(hash, static_cast<size_t>(properties.InputRate));
+    hash = HashCombine(hash, static_cast<size_t>((properties.DepthTest << 2) | (properties.DepthWritable << 1) | properties.Wireframe));
+    hash = HashCombine(hash, std::hash<Shader *>()(properties.Shader.get()));
+    for (const auto &element : properties.Layout) {
+        hash = HashCombine(hash, std::hash<string>()(element.Name));
+        hash = HashCombine(hash, static_cast<size_t>(element.Type));
+        hash = HashCombine(hash, (static_cast<size_t>(element.Offset) << 1) | static_cast<size_t>(element.Normalized));
+    }
+    return hash;
+}
+
+struct PipelineCache {
+    mutex Mutex;
+    unordered_map<size_t, vector<ReferenceView<PipelineState>>> Entries;
+    PipelineCacheStatistics Statistics;
+};
+
+PipelineCache &GetPipelineCache() {
+    static PipelineCache cache;
+    return cache;
+}
+
+}
+
+
 Scope<PipelineState> PipelineState::Create(const PipelineProperties &properties) {
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateScope<DXPipelineState>(properties); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLPipelineState>(properties); }
+        case GraphicsAPI::Software: { return CreateScope<SWPipelineState>(properties); }
         case GraphicsAPI::Vulkan:   { return CreateScope<VKPipelineState>(properties); }
 
         default: {
@@ -24,4 +61,36 @@ Scope<PipelineState> PipelineState::Create(const PipelineProperties &properties)
     }
 }
 
+Reference<PipelineState> PipelineState::Acquire(const PipelineProperties &properties) {
+    auto &cache = GetPipelineCache();
+    std::lock_guard<mutex> lock(cache.Mutex);
+
+    // Equal hashes are confirmed with the properties, expired entries of the bucket are dropped on the way
+    auto &bucket = cache.Entries[HashProperties(properties)];
+    std::erase_if(bucket, [](const ReferenceView<PipelineState> &entry) { return entry.expired(); });
+    for (const auto &entry : bucket) {
+        auto pipeline = entry.lock();
+        if (pipeline && pipeline->GetProperties() == properties) {
+            cache.Statistics.Hits++;
+            return pipeline;
+        }
+    }
+
+    Reference<PipelineState> pipeline = Create(properties);
+    if (!pipeline) return nullptr;
+    bucket.push_back(pipeline);
+    cache.Statistics.Misses++;
+    return pipeline;
+}
+
+PipelineCacheStatistics PipelineState::GetCacheStatistics() {
+    auto &cache = GetPipelineCache();
+    std::lock_guard<mutex> lock(cache.Mutex);
+    auto statistics = cache.Statistics;
+    for (const auto &[hash, bucket] : cache.Entries) {
+        statistics.Pipelines += static_cast<uint32_t>(std::ranges::count_if(bucket, [](const auto &entry) { return !entry.expired(); }));
+    }
+    return statistics;
+}
+
 }
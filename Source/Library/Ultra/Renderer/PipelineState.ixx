@@ -27,15 +27,35 @@ enum class BlendMode {
     Multiply,   // PreMultiplyAlpha
 };
 
+///
+/// @brief Per-instance layouts advance once per instance, the vertex shader expands the geometry from the vertex index.
+///
+enum class VertexInputRate {
+    Vertex,
+    Instance,
+};
+
 struct PipelineProperties {
     BlendMode BlendMode = BlendMode::Disabled;
     CullMode CullMode = CullMode::None;
     bool DepthTest = false;
     bool DepthWritable = true;
     bool Wireframe = false;
+    VertexInputRate InputRate = VertexInputRate::Vertex;
 
     VertexBufferLayout Layout;
     Reference<Shader> Shader;
+
+    // Shaders are compared by identity, two instances of the same source are still different programs
+    bool operator==(const PipelineProperties &other) const = default;
+};
+
+struct PipelineCacheStatistics {
+    uint32_t Hits = 0;
+    uint32_t Misses = 0;
+    uint32_t Pipelines = 0;     // Pipelines, which are still alive
+
+    float GetHitRate() const { return Hits + Misses ? static_cast<float>(Hits) / static_cast<float>(Hits + Misses) : 0.0f; }
 };
 
 /// 
@@ -44,6 +64,9 @@ struct PipelineProperties {
 /// @example: How-To
 /// auto pipeline = PipelineState::Create(CullMode::Back, BlendMode::Alpha)
 /// pipeline->Apply
+///
+/// // Objects with the same properties share one pipeline (and VAO or Vulkan pipeline)
+/// auto shared = PipelineState::Acquire(properties);
 /// 
 class PipelineState {
 protected:
@@ -54,10 +77,20 @@ public:
 
     static Scope<PipelineState> Create(const PipelineProperties &properties);
 
+    ///
+    /// @brief Returns the cached pipeline for equal properties or creates it, the cache only holds weak references,
+    /// so a pipeline is released with its last user.
+    ///
+    static Reference<PipelineState> Acquire(const PipelineProperties &properties);
+    static PipelineCacheStatistics GetCacheStatistics();
+
     virtual void Apply() = 0;
     virtual void Bind() = 0;
     virtual void Unbind() = 0;
 
+    // Accessors
+    const PipelineProperties &GetProperties() const { return mProperties; }
+
 protected:
     PipelineProperties mProperties;
     RendererID mPipelineID;
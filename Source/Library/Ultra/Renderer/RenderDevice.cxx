@@ -3,6 +3,7 @@
 import Ultra.Graphics.Context;
 import Ultra.Platform.Renderer.DXRenderDevice;
 import Ultra.Platform.Renderer.GLRenderDevice;
+import Ultra.Platform.Renderer.SWRenderDevice;
 import Ultra.Platform.Renderer.VKRenderDevice;
 
 namespace Ultra {
@@ -11,6 +12,7 @@ Scope<RenderDevice> RenderDevice::Create() {
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateScope<DXRenderDevice>(); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLRenderDevice>(); }
+        case GraphicsAPI::Software: { return CreateScope<SWRenderDevice>(); }
         case GraphicsAPI::Vulkan:   { return CreateScope<VKRenderDevice>(); }
 
         default: {
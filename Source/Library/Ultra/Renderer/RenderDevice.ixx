@@ -28,6 +28,7 @@ struct RendererCapabilities {
     float MaxAnisotropy = 0.0f;
     int MaxSamples = 0;
     int MaxTextureUnits = 0;
+    int UniformBufferAlignment = 256;
 
     void Log() {
         LogInfo("[Renderer] Vendor:  '{}'", Vendor);
@@ -37,6 +38,7 @@ struct RendererCapabilities {
         LogTrace("[Renderer] Max Anisotropy: '{}'", MaxAnisotropy);
         LogTrace("[Renderer] Max Samples:     '{}'", MaxSamples);
         LogTrace("[Renderer] Max TextureUnits: '{}'", MaxTextureUnits);
+        LogTrace("[Renderer] Uniform Buffer Alignment: '{}'", UniformBufferAlignment);
 
     }
     void ShowExtensions() {
@@ -48,6 +50,18 @@ struct RendererCapabilities {
 
 };
 
+///
+/// @brief Per frame counters of the renderer, which are reset at the start of every frame.
+///
+struct RendererStatistics {
+    uint32_t VisibleMeshes = 0;
+    uint32_t CulledMeshes = 0;
+    uint32_t IssuedStateCalls = 0;     // State changes, which reached the driver
+    uint32_t SkippedStateCalls = 0;    // Redundant state changes, which were dropped by the backend
+
+    void Reset() { *this = {}; }
+};
+
 
 /// 
 /// @brief Agnostic RenderDevice
@@ -70,6 +84,10 @@ public:
         static RendererCapabilities capabilities;
         return capabilities;
     }
+    static RendererStatistics &GetStatistics() {
+        static RendererStatistics statistics;
+        return statistics;
+    }
 
     virtual void SetLineThickness(float value = 1.0f) = 0;
     virtual void SetPolygonMode(PolygonMode mode = PolygonMode::Solid) = 0;
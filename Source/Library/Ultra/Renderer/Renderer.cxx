@@ -6,9 +6,11 @@ import Ultra.Math;
 import Ultra.Graphics.Context;
 import Ultra.Platform.DXRenderer;
 import Ultra.Platform.GLRenderer;
+import Ultra.Platform.SWRenderer;
 import Ultra.Platform.VKRenderer;
 import Ultra.Platform.Renderer.DXRenderDevice;
 import Ultra.Platform.Renderer.GLRenderDevice;
+import Ultra.Platform.Renderer.SWRenderDevice;
 import Ultra.Platform.Renderer.VKRenderDevice;
 
 namespace Ultra {
@@ -29,6 +31,11 @@ Scope<Renderer> Renderer::Create() {
             device = CreateScope<GLRenderDevice>();
             break;
         }
+        case GraphicsAPI::Software: {
+            renderer = CreateScope<SWRenderer>();
+            device = CreateScope<SWRenderDevice>();
+            break;
+        }
         case GraphicsAPI::Vulkan: {
             renderer = CreateScope<VKRenderer>();
             device = CreateScope<VKRenderDevice>();
@@ -59,9 +66,12 @@ void Renderer::RenderFrame() {
     //auto renderState = RenderState::Create();
     // Begin recording commands
     //commandBuffer->Begin();
+    Renderer2D::NextFrame();                            // Fence the streamed data of the last frame
     mCommandBuffer->Clear(0.1f, 0.1f, 0.1f, 1.0f);;     // Clear the framebuffer
     //commandBuffer->BindRenderState(renderState);      // Set up the render state
     Renderer2D::ResetStatistics();
+    RenderDevice::GetStatistics().Reset();
+    Shader::ReloadChanged();
 
     //Renderer::EndScene();
     //commandBuffer->End();                             // End recording commands
@@ -2,31 +2,108 @@
 
 module Ultra.Renderer2D;
 
+import Ultra.Core.Allocator;
+import Ultra.Core.JobSystem;
 import Ultra.Renderer.Buffer;
 import Ultra.Renderer.PipelineState;
 import Ultra.Renderer.Shader;
+import Ultra.Renderer.StreamBuffer;
 import Ultra.Renderer.Texture;
 
 namespace Ultra {
 
 Scope<CommandBuffer> Renderer2D::sCommandBuffer = nullptr;
 
+// Sort Keys
+///
+/// @brief Draws are recorded as packets and sorted by their key before they are merged into batches.
+///   Opaque:      | Layer (8) | 0 | Unused (13) | Pipeline (2) | Texture (16) | Depth (24) front-to-back |
+///   Translucent: | Layer (8) | 1 | Depth (24) back-to-front | Unused (13) | Pipeline (2) | Texture (16) |
+/// Opaque draws are grouped by state and rely on the depth test for the order, translucent draws are blended, so they need the order.
+/// Equal keys keep their submission order, opaque draws are rendered before the translucent draws of their layer.
+///
+namespace SortKey {
+
+constexpr uint64_t LayerShift = 56;
+constexpr uint64_t TranslucentBit = 1ull << 55;
+constexpr uint64_t TranslucentDepthShift = 31;
+constexpr uint64_t OpaqueStateShift = 24;
+constexpr uint64_t DepthMask = 0xffffff;
+constexpr uint64_t PipelineShift = 16;
+constexpr uint64_t PipelineMask = 0x3;
+constexpr uint64_t TextureMask = 0xffff;
+
+inline uint64_t Encode(uint8_t layer, bool translucent, DrawPipeline pipeline, uint16_t texture, uint32_t depth) {
+    auto key = static_cast<uint64_t>(layer) << LayerShift;
+    auto state = (static_cast<uint64_t>(pipeline) << PipelineShift) | texture;
+    if (translucent) {
+        key |= TranslucentBit;
+        key |= (DepthMask - (depth & DepthMask)) << TranslucentDepthShift;
+        key |= state;
+    } else {
+        key |= state << OpaqueStateShift;
+        key |= depth & DepthMask;
+    }
+    return key;
+}
+
+inline bool IsTranslucent(uint64_t key) {
+    return key & TranslucentBit;
+}
+
+inline uint64_t GetState(uint64_t key) {
+    return IsTranslucent(key) ? key : key >> OpaqueStateShift;
+}
+
+inline DrawPipeline GetPipeline(uint64_t key) {
+    return static_cast<DrawPipeline>((GetState(key) >> PipelineShift) & PipelineMask);
+}
+
+inline uint16_t GetTexture(uint64_t key) {
+    return static_cast<uint16_t>(GetState(key) & TextureMask);
+}
+
+inline uint64_t SetTexture(uint64_t key, uint16_t texture) {
+    auto shift = IsTranslucent(key) ? 0 : OpaqueStateShift;
+    return (key & ~(TextureMask << shift)) | (static_cast<uint64_t>(texture) << shift);
+}
+
+}
+
+// The corners of the unit quad, which are transformed into circles, quads and rectangles
+static const array<glm::vec4, 4> QuadVertexPositions = {
+    glm::vec4 { -0.5f, -0.5f, 0.0f, 1.0f },
+    glm::vec4 {  0.5f, -0.5f, 0.0f, 1.0f },
+    glm::vec4 {  0.5f,  0.5f, 0.0f, 1.0f },
+    glm::vec4 { -0.5f,  0.5f, 0.0f, 1.0f },
+};
+
 struct RendererData {
     // General
     bool DepthTest = true;
     Renderer2D::Statistics Stats;
 
+    // Queue
+    DrawList2D List;                // Draws of the renderer itself, submitted lists are appended to it
+    vector<DrawList2D> DrawLists;   // Pooled lists of 'DrawParallel', they keep their capacity between frames
+    vector<uint16_t> TextureRemap;
+    vector<DrawPacket> SortBuffer;
+
+    // Streaming
+    static constexpr size_t VertexStreamSize = 16 * 1024 * 1024;    // Holds the batches of several frames, so the ring rarely waits for the GPU
+    static constexpr size_t UniformStreamSize = 64 * 1024;
+    Scope<StreamBuffer> VertexStream;
+    Scope<StreamBuffer> UniformStream;
+
     // Circles
     static constexpr size_t MaxCircles = 2000;
     static constexpr size_t MaxCircleVertices = MaxCircles * 4;
     static constexpr size_t MaxCircleIndices = MaxCircles * 6;
 
-    vector<CircleComponent> CircleVertexBufferData;
-    array<glm::vec4, 4> CircleVertexPositions;
+    vector<CircleComponent> CircleBatchData;
 
-    Reference<PipelineState> CirclePipeline;
+    array<Reference<PipelineState>, 2> CirclePipelines;    // Opaque, Translucent
     Reference<Shader> CircleShader;
-    Reference<Buffer> CircleVertexBuffer;
     Reference<Buffer> CircleIndexBuffer;
 
     // Lines
@@ -34,12 +111,10 @@ struct RendererData {
     static constexpr size_t MaxLineVertices = MaxLines * 4;
     static constexpr size_t MaxLineIndices = MaxLines * 6;
 
-    vector<LineComponent> LineVertexBufferData;
-    array<glm::vec4, 4> LineVertexPositions;
+    vector<LineComponent> LineBatchData;
 
-    Reference<PipelineState> LinePipeline;
+    array<Reference<PipelineState>, 2> LinePipelines;      // Opaque, Translucent
     Reference<Shader> LineShader;
-    Reference<Buffer> LineVertexBuffer;
     Reference<Buffer> LineIndexBuffer;
 
     // Quads
@@ -47,18 +122,25 @@ struct RendererData {
     static constexpr uint32_t MaxQuadVertices = MaxQuads * 4;
     static constexpr uint32_t MaxQuadIndices = MaxQuads * 6;
 
-    vector<QuadComponent> QuadVertexBufferData;
-    array<glm::vec4, 4> QuadVertexPositions;
+    vector<QuadComponent> QuadBatchData;
 
-    Reference<PipelineState> QuadPipeline;
-    Reference<Buffer> QVertexBuffer;
+    array<Reference<PipelineState>, 2> QuadPipelines;      // Opaque, Translucent
     Reference<Buffer> QIndexBuffer;
 
+    // Quad Instances
+    vector<QuadInstance> QuadInstanceBatchData;
+
+    array<Reference<PipelineState>, 2> QuadInstancePipelines;  // Opaque, Translucent
+    Reference<Shader> QuadInstanceShader;
+
     // Textures
-    static constexpr uint32_t MaxTextureSlots = 16; // ToDo: RenderDevice::GetCapabilities().MaxTextureUnits
+    static constexpr uint32_t MaxTextureSlots = 32; // Size of the sampler array in the shaders, the device may support less
+    uint32_t TextureSlotCount = 16;
 
     uint32_t TextureSlotIndex = 1; // 0 = White
     array<Reference<Texture>, MaxTextureSlots> TextureSlots;
+    array<uint16_t, MaxTextureSlots> TextureSlotSources {};
+    vector<int8_t> FrameTextureSlots;   // Slot of every frame texture (the textures of the renderer list) in the current batch (-1 = none), so lookups don't search the slots
 
     Reference<Shader> TextureShader;
     Reference<Texture> WhiteTexture;
@@ -76,11 +158,70 @@ struct RendererData {
         float Far = {};
     };
     CameraData CameraBuffer;
-    Reference<Buffer> CameraUniformBuffer;
 };
 
 static RendererData sData;
 
+// Helpers
+// All lists share the pool of their texture lookup, it is created with the first list, so it also outlives the lists of the renderer
+static PoolResource &GetTextureLookupPool() {
+    static PoolResource pool(64);
+    return pool;
+}
+
+// Opaque draws write and test the depth, translucent draws are blended and only test it
+static array<Reference<PipelineState>, 2> CreatePipelines(PipelineProperties properties) {
+    properties.DepthTest = true;
+    auto opaque = PipelineState::Create(properties);
+    properties.BlendMode = BlendMode::Alpha;
+    properties.DepthWritable = false;
+    return { opaque, PipelineState::Create(properties) };
+}
+
+// LSD radix sort over the key bytes, it is stable, so equal keys keep their submission order
+static void SortPackets(vector<DrawPacket> &packets, vector<DrawPacket> &buffer) {
+    array<array<uint32_t, 256>, sizeof(uint64_t)> histograms {};
+    for (const auto &packet : packets) {
+        for (size_t pass = 0; pass < sizeof(uint64_t); pass++) histograms[pass][(packet.Key >> (pass * 8)) & 0xff]++;
+    }
+
+    buffer.resize(packets.size());
+    for (size_t pass = 0; pass < sizeof(uint64_t); pass++) {
+        // Bytes which are equal for all keys (unused layers, etc.) don't need a pass
+        auto &histogram = histograms[pass];
+        auto shift = pass * 8;
+        if (histogram[(packets.front().Key >> shift) & 0xff] == packets.size()) continue;
+
+        uint32_t offset = 0;
+        for (auto &count : histogram) {
+            auto current = count;
+            count = offset;
+            offset += current;
+        }
+        for (const auto &packet : packets) buffer[histogram[(packet.Key >> shift) & 0xff]++] = packet;
+        packets.swap(buffer);
+    }
+}
+
+// Reserves a texture slot for the current batch, fails if all slots are occupied
+static bool AcquireTextureSlot(uint16_t texture, float &slot) {
+    auto &current = sData.FrameTextureSlots[texture];
+    if (current < 0) {
+        if (sData.TextureSlotIndex >= sData.TextureSlotCount) return false;
+        current = static_cast<int8_t>(sData.TextureSlotIndex);
+        sData.TextureSlotSources[sData.TextureSlotIndex] = texture;
+        sData.TextureSlotIndex++;
+    }
+    slot = static_cast<float>(current);
+    return true;
+}
+
+// Releases the slots of the previous batch
+static void ResetTextureSlots() {
+    for (uint32_t i = 1; i < sData.TextureSlotIndex; i++) sData.FrameTextureSlots[sData.TextureSlotSources[i]] = -1;
+    sData.TextureSlotIndex = 1;
+}
+
 // Default
 void Renderer2D::Load() {
     // Circles
@@ -94,15 +235,10 @@ void Renderer2D::Load() {
             { ShaderDataType::Float,  "aThickness"     },
             { ShaderDataType::Float,  "aFade"          },
         };
-        sData.CirclePipeline = PipelineState::Create(pipelineProperties);
+        sData.CirclePipelines = CreatePipelines(pipelineProperties);
 
-        sData.CircleVertexBufferData.reserve(sData.MaxCircleVertices);
-        sData.CircleVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
-        sData.CircleVertexPositions[1] = { 0.5f, -0.5f, 0.0f, 1.0f };
-        sData.CircleVertexPositions[2] = { 0.5f,  0.5f, 0.0f, 1.0f };
-        sData.CircleVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
-
-        sData.CircleVertexBuffer = Buffer::Create(BufferType::Vertex, nullptr, sData.MaxCircleVertices * sizeof(CircleComponent));
+        sData.List.mCircleVertices.reserve(sData.MaxCircleVertices);
+        sData.CircleBatchData.reserve(sData.MaxCircleVertices);
 
         uint32_t offset = 0;
         uint32_t *circleIndicies = new uint32_t[sData.MaxCircleIndices];
@@ -130,15 +266,10 @@ void Renderer2D::Load() {
             { ShaderDataType::Float3, "aPosition" },
             { ShaderDataType::Float4, "aColor" }
         };
-        sData.LinePipeline = PipelineState::Create(pipelineProperties);
-
-        sData.LineVertexBufferData.reserve(sData.MaxLineVertices);
-        sData.LineVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
-        sData.LineVertexPositions[1] = { 0.5f, -0.5f, 0.0f, 1.0f };
-        sData.LineVertexPositions[2] = { 0.5f,  0.5f, 0.0f, 1.0f };
-        sData.LineVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
+        sData.LinePipelines = CreatePipelines(pipelineProperties);
 
-        sData.LineVertexBuffer = Buffer::Create(BufferType::Vertex, nullptr, sData.MaxLineVertices * sizeof(LineComponent));
+        sData.List.mLineVertices.reserve(sData.MaxLineVertices);
+        sData.LineBatchData.reserve(sData.MaxLineVertices);
 
         uint32_t *lineIndices = new uint32_t[sData.MaxLineIndices];
         for (uint32_t i = 0; i < sData.MaxLineIndices; i++) {
@@ -159,15 +290,10 @@ void Renderer2D::Load() {
             { ShaderDataType::Float, "aTexIndex" },
             { ShaderDataType::Float, "aTilingFactor" },
         };
-        sData.QuadPipeline = PipelineState::Create(pipelineProperties);
+        sData.QuadPipelines = CreatePipelines(pipelineProperties);
 
-        sData.QuadVertexBufferData.reserve(sData.MaxQuadVertices);
-
-        sData.QVertexBuffer = Buffer::Create(BufferType::Vertex, nullptr, sData.MaxQuadVertices * sizeof(QuadComponent));
-        sData.QuadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
-        sData.QuadVertexPositions[1] = { 0.5f, -0.5f, 0.0f, 1.0f };
-        sData.QuadVertexPositions[2] = { 0.5f,  0.5f, 0.0f, 1.0f };
-        sData.QuadVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
+        sData.List.mQuadVertices.reserve(sData.MaxQuadVertices);
+        sData.QuadBatchData.reserve(sData.MaxQuadVertices);
 
         uint32_t offset = 0;
         uint32_t *quadIndicies = new uint32_t[sData.MaxQuadIndices];
@@ -186,6 +312,25 @@ void Renderer2D::Load() {
         delete[] quadIndicies;
     }
 
+    // Quad Instances
+    {
+        PipelineProperties pipelineProperties;
+        pipelineProperties.InputRate = VertexInputRate::Instance;
+        pipelineProperties.Layout = {
+            { ShaderDataType::Float3, "aTransformX" },
+            { ShaderDataType::Float3, "aTransformY" },
+            { ShaderDataType::Float, "aDepth" },
+            { ShaderDataType::Float4, "aColor" },
+            { ShaderDataType::Float4, "aTexRect" },
+            { ShaderDataType::Float, "aTexIndex" },
+            { ShaderDataType::Float, "aTilingFactor" },
+        };
+        sData.QuadInstancePipelines = CreatePipelines(pipelineProperties);
+
+        sData.List.mQuadInstances.reserve(sData.MaxQuads);
+        sData.QuadInstanceBatchData.reserve(sData.MaxQuads);
+    }
+
     // Textures
     {
         uint32_t whiteTextureData = 0xffffffff;
@@ -198,11 +343,26 @@ void Renderer2D::Load() {
         sData.TextureShader->Bind();
         sData.TextureShader->UpdateUniformBuffer("uTextures", (void *)samplers, sData.MaxTextureSlots);
 
-        // Set all texture slots to 0
+        sData.QuadInstanceShader = Shader::Create("./Assets/Shaders/Sprites/Quad.glsl");
+        sData.QuadInstanceShader->Bind();
+        sData.QuadInstanceShader->UpdateUniformBuffer("uTextures", (void *)samplers, sData.MaxTextureSlots);
+
+        // The batch capacity follows the device, but can't exceed the sampler array of the shaders
+        auto units = RenderDevice::GetCapabilities().MaxTextureUnits;
+        sData.TextureSlotCount = units > 0 ? std::min(static_cast<uint32_t>(units), RendererData::MaxTextureSlots) : 16u;
+
+        // Set all texture slots to 0, the white texture is always the first texture of every list
         sData.TextureSlots[0] = sData.WhiteTexture;
+        sData.List.mImmediate = true;
+        sData.List.mPackets.reserve(sData.MaxQuads);
+        NextBatch();
+    }
 
-        sData.CameraUniformBuffer = Buffer::Create(BufferType::Uniform, nullptr, sizeof(RendererData::CameraData));
-        sData.CameraUniformBuffer->Bind(0);
+    // Streaming
+    {
+        // Every batch and camera is written into the next free range, instead of overwriting buffers, which the GPU may still read
+        sData.VertexStream = CreateScope<StreamBuffer>(BufferType::Vertex, RendererData::VertexStreamSize);
+        sData.UniformStream = CreateScope<StreamBuffer>(BufferType::Uniform, RendererData::UniformStreamSize);
     }
 
 
@@ -210,22 +370,26 @@ void Renderer2D::Load() {
 }
 
 void Renderer2D::Dispose() {
-    sData.CircleVertexBufferData.clear();
-    sData.CirclePipeline.reset();
-    sData.CircleVertexBuffer.reset();
+    sData.List = {};
+    sData.DrawLists.clear();
+
+    sData.CirclePipelines = {};
     sData.CircleIndexBuffer.reset();
 
-    sData.LineVertexBufferData.clear();
-    sData.LinePipeline.reset();
-    sData.LineVertexBuffer.reset();
+    sData.LinePipelines = {};
     sData.LineIndexBuffer.reset();
     sData.LineShader.reset();
 
-    sData.QuadVertexBufferData.clear();
-    sData.QuadPipeline.reset();
-    sData.QVertexBuffer.reset();
+    sData.QuadPipelines = {};
     sData.QIndexBuffer.reset();
 
+    sData.QuadInstancePipelines = {};
+    sData.QuadInstanceShader.reset();
+
+    sData.FrameTextureSlots.clear();
+    sData.VertexStream.reset();
+    sData.UniformStream.reset();
+
     sData.TextureShader.reset();
     sData.WhiteTexture.reset();
     for (auto &texture : sData.TextureSlots) {
@@ -238,9 +402,9 @@ void Renderer2D::StartScene(const Camera &camera) {
     sData.DepthTest = true;
 
     sData.CameraBuffer.ViewProjection = camera.GetProjection();
-    sData.CameraUniformBuffer->Bind(1);
-    sData.CameraUniformBuffer->UpdateData(&sData.CameraBuffer, sizeof(RendererData::CameraData));
+    UploadCamera();
 
+    sData.List.Begin();
     NextBatch();
 }
 
@@ -248,9 +412,9 @@ void Renderer2D::StartScene(const DesignerCamera &camera) {
     sData.DepthTest = true;
 
     sData.CameraBuffer.ViewProjection = camera.GetViewProjection();
-    sData.CameraUniformBuffer->Bind(1);
-    sData.CameraUniformBuffer->UpdateData(&sData.CameraBuffer, sizeof(RendererData::CameraData));
+    UploadCamera();
 
+    sData.List.Begin();
     NextBatch();
 }
 
@@ -258,9 +422,9 @@ void Renderer2D::StartScene(const PerspectiveCamera &camera) {
     sData.DepthTest = true;
 
     sData.CameraBuffer.ViewProjection = camera.GetViewProjectionMatrix();
-    sData.CameraUniformBuffer->Bind(1);
-    sData.CameraUniformBuffer->UpdateData(&sData.CameraBuffer, sizeof(RendererData::CameraData));
+    UploadCamera();
 
+    sData.List.Begin();
     NextBatch();
 }
 
@@ -268,280 +432,581 @@ void Renderer2D::StartScene(const OrthographicCamera &camera) {
     sData.DepthTest = true;
 
     sData.CameraBuffer.ViewProjection = camera.GetViewProjectionMatrix();
-    sData.CameraUniformBuffer->Bind(1);
-    sData.CameraUniformBuffer->UpdateData(&sData.CameraBuffer, sizeof(RendererData::CameraData));
+    UploadCamera();
 
+    sData.List.Begin();
     NextBatch();
 }
 
 void Renderer2D::FinishScene() {
-    // Is the buffer empty?
-    if (sData.CircleVertexBufferData.size() && sData.QuadVertexBufferData.size() && sData.LineVertexBufferData.size() == 0) return;
-    Flush();
+    // Is the queue empty?
+    if (!sData.List.IsEmpty()) Flush();
+}
+
+void Renderer2D::NextFrame() {
+    // The data of all scenes of the last frame is fenced, so that the streams don't overwrite it while the GPU reads it
+    if (!sData.VertexStream) return;
+    sData.VertexStream->NextFrame();
+    sData.UniformStream->NextFrame();
 }
 
 void Renderer2D::Flush() {
-    if (sData.CircleVertexBufferData.size()) {
-        auto dataSize = sizeof_vector(sData.CircleVertexBufferData);
-        sData.CircleVertexBuffer->UpdateData(sData.CircleVertexBufferData.data(), dataSize);
+    auto &list = sData.List;
+    if (list.IsEmpty()) return;
+    SortPackets(list.mPackets, sData.SortBuffer);
+    sData.Stats.CircleCount += list.mCircleCount;
+    sData.Stats.LineCount += list.mLineCount;
+    sData.Stats.QuadCount += list.mQuadCount;
+    sData.Stats.Triangles += list.mQuadCount * 2;
+
+    // Only the white texture starts with a slot
+    sData.FrameTextureSlots.assign(list.mTextures.size(), -1);
+    sData.FrameTextureSlots[0] = 0;
+    sData.TextureSlotIndex = 1;
 
-        sData.CircleShader->Bind();
-        //sData.CircleShader->UpdateUniform("uViewProjection", sData.ViewProjectionMatrix);
+    // Merge the sorted packets into the minimal number of batches, a batch ends when the pipeline or the blending changes, the vertex buffer is full or the texture slots are exhausted
+    const auto &packets = list.mPackets;
+    std::optional<std::pair<DrawPipeline, bool>> boundPipeline;
+    array<Texture *, RendererData::MaxTextureSlots> boundTextures {};
+    auto bindTextures = [&]() {
+        for (uint32_t i = 0; i < sData.TextureSlotIndex; i++) {
+            // Slots keep their textures across batches, only changed slots are rebound
+            auto &texture = list.mTextures[sData.TextureSlotSources[i]];
+            sData.TextureSlots[i] = texture;
+            if (boundTextures[i] == texture.get()) continue;
+            boundTextures[i] = texture.get();
+            texture->Bind(i);
+            sData.Stats.StateChanges++;
+        }
+    };
+    size_t begin = 0;
+    while (begin < packets.size()) {
+        auto pipeline = SortKey::GetPipeline(packets[begin].Key);
+        auto translucent = SortKey::IsTranslucent(packets[begin].Key);
+        auto sameState = [&](uint64_t key) { return SortKey::GetPipeline(key) == pipeline && SortKey::IsTranslucent(key) == translucent; };
+        size_t capacity {};
+        switch (pipeline) {
+            case DrawPipeline::Circle:          { capacity = RendererData::MaxCircles; break; }
+            case DrawPipeline::Line:            { capacity = RendererData::MaxLines; break; }
+            case DrawPipeline::Quad:            { capacity = RendererData::MaxQuads; break; }
+            case DrawPipeline::QuadInstance:    { capacity = RendererData::MaxQuads; break; }
+        }
+
+        ResetTextureSlots();
+        sData.QuadBatchData.clear();
+        sData.QuadInstanceBatchData.clear();
+        sData.CircleBatchData.clear();
+        sData.LineBatchData.clear();
+        auto end = begin;
+        for (; end < packets.size() && end - begin < capacity; end++) {
+            const auto &packet = packets[end];
+            if (!sameState(packet.Key)) break;
+
+            if (pipeline == DrawPipeline::Circle) {
+                auto first = list.mCircleVertices.begin() + packet.Index * 4;
+                sData.CircleBatchData.insert(sData.CircleBatchData.end(), first, first + 4);
+            } else if (pipeline == DrawPipeline::Line) {
+                auto first = list.mLineVertices.begin() + packet.Index * 2;
+                sData.LineBatchData.insert(sData.LineBatchData.end(), first, first + 2);
+            } else {
+                float slot {};
+                if (!AcquireTextureSlot(SortKey::GetTexture(packet.Key), slot)) break;
+                if (pipeline == DrawPipeline::QuadInstance) {
+                    auto &instance = sData.QuadInstanceBatchData.emplace_back(list.mQuadInstances[packet.Index]);
+                    instance.TextureIndex = slot;
+                    continue;
+                }
+                for (size_t i = 0; i < 4; i++) {
+                    auto &vertex = sData.QuadBatchData.emplace_back(list.mQuadVertices[packet.Index * 4 + i]);
+                    vertex.TextureIndex = slot;
+                }
+            }
+        }
+        if (end < packets.size() && sameState(packets[end].Key)) {
+            sData.Stats.BatchBreaks++;
+            if (end - begin < capacity) sData.Stats.TextureBreaks++;
+        }
+        if (boundPipeline != std::pair(pipeline, translucent)) {
+            boundPipeline = { pipeline, translucent };
+            sData.Stats.StateChanges++;
+        }
 
-        sData.CircleVertexBuffer->Bind();
-        sData.CirclePipeline->Bind();
-        sData.QIndexBuffer->Bind();
-        sCommandBuffer->DrawIndexed(sData.QuadVertexBufferData.size() * 6u, PrimitiveType::Circle, sData.DepthTest);
+        // The command buffer sets the depth mask of the draw, translucent draws must not hide the draws behind them
+        auto depthWrite = sData.DepthTest && !translucent;
+        switch (pipeline) {
+            case DrawPipeline::Circle: {
+                auto allocation = sData.VertexStream->Write(sData.CircleBatchData.data(), sizeof_vector(sData.CircleBatchData), sizeof(CircleComponent));
+
+                sData.CircleShader->Bind();
+                sData.VertexStream->Bind();
+                sData.CirclePipelines[translucent]->Bind();
+                sData.CircleIndexBuffer->Bind();
+                sCommandBuffer->DrawIndexed((end - begin) * 6u, PrimitiveType::Circle, depthWrite, static_cast<int32_t>(allocation.Offset / sizeof(CircleComponent)));
+                break;
+            }
+            case DrawPipeline::Line: {
+                auto allocation = sData.VertexStream->Write(sData.LineBatchData.data(), sizeof_vector(sData.LineBatchData), sizeof(LineComponent));
+
+                sData.VertexStream->Bind();
+                sData.LineShader->Bind();
+                sData.LinePipelines[translucent]->Bind();
+                sData.LineIndexBuffer->Bind();
+                sCommandBuffer->DrawIndexed((end - begin) * 2u, PrimitiveType::Line, depthWrite, static_cast<int32_t>(allocation.Offset / sizeof(LineComponent)));
+                break;
+            }
+            case DrawPipeline::Quad: {
+                auto allocation = sData.VertexStream->Write(sData.QuadBatchData.data(), sizeof_vector(sData.QuadBatchData), sizeof(QuadComponent));
+
+                sData.TextureShader->Bind();
+                bindTextures();
+
+                sData.VertexStream->Bind();
+                sData.QuadPipelines[translucent]->Bind();
+                sData.QIndexBuffer->Bind();
+                sCommandBuffer->DrawIndexed((end - begin) * 6u, PrimitiveType::Triangle, depthWrite, static_cast<int32_t>(allocation.Offset / sizeof(QuadComponent)));
+                break;
+            }
+            case DrawPipeline::QuadInstance: {
+                auto allocation = sData.VertexStream->Write(sData.QuadInstanceBatchData.data(), sizeof_vector(sData.QuadInstanceBatchData), sizeof(QuadInstance));
+
+                sData.QuadInstanceShader->Bind();
+                bindTextures();
+
+                // The first six indices describe a single quad, which is repeated for every instance
+                sData.VertexStream->Bind();
+                sData.QuadInstancePipelines[translucent]->Bind();
+                sData.QIndexBuffer->Bind();
+                sCommandBuffer->DrawIndexed(6u, static_cast<uint32_t>(end - begin), 0, 0, static_cast<uint32_t>(allocation.Offset / sizeof(QuadInstance)));
+                break;
+            }
+        }
         sData.Stats.DrawCalls++;
+        begin = end;
     }
 
-    if (sData.LineVertexBufferData.size()) {
-        auto dataSize = sizeof_vector(sData.LineVertexBufferData);
-        sData.LineVertexBuffer->UpdateData(sData.LineVertexBufferData.data(), dataSize);
+    NextBatch();
+}
 
-        sData.LineVertexBuffer->Bind();
-        sData.LineShader->Bind();
-        sData.LinePipeline->Bind();
-        sData.LineIndexBuffer->Bind();
-        sCommandBuffer->DrawIndexed(sData.LineVertexBufferData.size(), PrimitiveType::Line, sData.DepthTest);
-        sData.Stats.DrawCalls++;
-    }
+void Renderer2D::SetInstancing(bool enabled) {
+    sData.List.mInstancing = enabled;
+}
 
-    if (sData.QuadVertexBufferData.size()) {
-        auto dataSize = sizeof_vector(sData.QuadVertexBufferData);
-        sData.QVertexBuffer->UpdateData(sData.QuadVertexBufferData.data(), dataSize);
+void Renderer2D::SetLayer(uint8_t layer) {
+    sData.List.SetLayer(layer);
+}
 
-        sData.TextureShader->Bind();
-        //sData.TextureShader->UpdateUniform("uViewProjection", sData.ViewProjectionMatrix);
+void Renderer2D::Submit(const DrawList2D &list) {
+    if (list.IsEmpty()) return;
+    auto &target = sData.List;
+
+    // The textures of both lists have to fit into the sort key
+    if (target.mTextures.size() + list.mTextures.size() > SortKey::TextureMask + 1) Flush();
+    auto &remap = sData.TextureRemap;
+    remap.resize(list.mTextures.size());
+    remap[0] = 0;
+    for (size_t i = 1; i < list.mTextures.size(); i++) remap[i] = target.GetTexture(list.mTextures[i]);
+
+    // The vertex data is appended behind the existing data of each pipeline, so the packet indices are offset
+    array<uint32_t, 4> offsets = {
+        static_cast<uint32_t>(target.mCircleVertices.size() / 4),
+        static_cast<uint32_t>(target.mLineVertices.size() / 2),
+        static_cast<uint32_t>(target.mQuadVertices.size() / 4),
+        static_cast<uint32_t>(target.mQuadInstances.size()),
+    };
+    target.mCircleVertices.insert(target.mCircleVertices.end(), list.mCircleVertices.begin(), list.mCircleVertices.end());
+    target.mLineVertices.insert(target.mLineVertices.end(), list.mLineVertices.begin(), list.mLineVertices.end());
+    target.mQuadVertices.insert(target.mQuadVertices.end(), list.mQuadVertices.begin(), list.mQuadVertices.end());
+    target.mQuadInstances.insert(target.mQuadInstances.end(), list.mQuadInstances.begin(), list.mQuadInstances.end());
+
+    // Packets with equal keys keep the submission order (the sort is stable), so the result doesn't depend on the threads
+    target.mPackets.reserve(target.mPackets.size() + list.mPackets.size());
+    for (const auto &packet : list.mPackets) {
+        auto key = SortKey::SetTexture(packet.Key, remap[SortKey::GetTexture(packet.Key)]);
+        target.mPackets.push_back({ key, packet.Index + offsets[static_cast<size_t>(SortKey::GetPipeline(packet.Key))] });
+    }
 
-        for (uint32_t i = 0; i < sData.TextureSlotIndex; i++) {
-            sData.TextureSlots[i]->Bind(i);
+    target.mCircleCount += list.mCircleCount;
+    target.mLineCount += list.mLineCount;
+    target.mQuadCount += list.mQuadCount;
+}
+
+void Renderer2D::DrawParallel(size_t count, size_t grain, const function<void(DrawList2D &list, size_t begin, size_t end)> &function) {
+    if (!count) return;
+    grain = std::max(grain, size_t(1));
+    auto chunks = (count + grain - 1) / grain;
+    if (sData.DrawLists.size() < chunks) sData.DrawLists.resize(chunks);
+
+    // The chunk (not the thread) decides the list, so the merge order is always the same
+    JobSystem::Instance().ParallelFor(chunks, 1, [&](size_t first, size_t last) {
+        for (auto chunk = first; chunk < last; chunk++) {
+            auto &list = sData.DrawLists[chunk];
+            list.Begin();
+            function(list, chunk * grain, std::min(count, (chunk + 1) * grain));
         }
+    });
+    for (size_t chunk = 0; chunk < chunks; chunk++) Submit(sData.DrawLists[chunk]);
+}
 
-        sData.QVertexBuffer->Bind();
-        sData.QuadPipeline->Bind();
-        sData.QIndexBuffer->Bind();
-        sCommandBuffer->DrawIndexed({ sData.QuadVertexBufferData.size() * 6 }, PrimitiveType::Triangle, sData.DepthTest);
-        sData.Stats.DrawCalls++;
-    }
+void Renderer2D::UploadCamera() {
+    auto alignment = static_cast<size_t>(std::max(RenderDevice::GetCapabilities().UniformBufferAlignment, 16));
+    auto allocation = sData.UniformStream->Write(&sData.CameraBuffer, sizeof(RendererData::CameraData), alignment);
+    sData.UniformStream->Bind(1, allocation);
 }
 
 void Renderer2D::NextBatch() {
-    sData.CircleVertexBufferData.clear();
-    sData.LineVertexBufferData.clear();
-    sData.QuadVertexBufferData.clear();
-
+    sData.List.Clear();
+    sData.FrameTextureSlots.clear();
     sData.TextureSlotIndex = 1;
 }
 
-void Renderer2D::FlushAndReset(PrimitiveType primitive) {
-    switch (primitive) {
-        case PrimitiveType::Circle: {
-            Flush();
-            sData.CircleVertexBufferData.clear();
-            break;
-        }
 
-        case PrimitiveType::Line: {
-            Flush();
-            sData.LineVertexBufferData.clear();
-            break;
-        }
+// Primitives
+void Renderer2D::DrawCircle(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color, float thickness, float fade) {
+    sData.List.DrawCircle(position, size, color, thickness, fade);
+}
+
+void Renderer2D::DrawCircle(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color, float thickness, float fade) {
+    sData.List.DrawCircle(position, size, color, thickness, fade);
+}
 
-        case PrimitiveType::Triangle: {
-            Flush();
-            sData.QuadVertexBufferData.clear();
+void Renderer2D::DrawCircle(const glm::mat4 &transform, const glm::vec4 &color, float thickness, float fade) {
+    sData.List.DrawCircle(transform, color, thickness, fade);
+}
 
-            sData.TextureSlotIndex = 1;
-            break;
-        }
 
-        default: {
-            break;
-        }
-    }
+void Renderer2D::DrawLine(const glm::vec2 &start, const glm::vec2 &end, const glm::vec4 &color) {
+    sData.List.DrawLine(start, end, color);
 }
 
+void Renderer2D::DrawLine(const glm::vec3 &start, const glm::vec3 &end, const glm::vec4 &color) {
+    sData.List.DrawLine(start, end, color);
+}
 
-// Primitives
-void Renderer2D::DrawCircle(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color, float thickness, float fade) {
-    DrawCircle({ position.x, position.y, 0.0f }, size, color, thickness, fade);
+
+void Renderer2D::DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color) {
+    sData.List.DrawQuad(position, size, color);
 }
 
-void Renderer2D::DrawCircle(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color, float thickness, float fade) {
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
-    DrawCircle(transform, color, thickness, fade);
+void Renderer2D::DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color) {
+    sData.List.DrawQuad(position, size, color);
 }
 
-void Renderer2D::DrawCircle(const glm::mat4 &transform, const glm::vec4 &color, float thickness, float fade) {
-    if (sData.CircleVertexBufferData.size() * 6 >= RendererData::MaxCircleIndices) FlushAndReset();
+void Renderer2D::DrawQuad(const glm::mat4 &transform, const glm::vec4 &color) {
+    sData.List.DrawQuad(transform, color);
+}
 
-    for (size_t i = 0; i < sData.CircleVertexPositions.size(); i++) {
-        sData.CircleVertexBufferData.emplace_back((transform * sData.CircleVertexPositions[i]), (sData.CircleVertexPositions[i] * 2.0f), color, thickness, fade);
-    }
+void Renderer2D::DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawQuad(position, size, texture, tilingFactor, color);
+}
 
-    sData.Stats.CircleCount++;
+void Renderer2D::DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawQuad(position, size, texture, tilingFactor, color);
 }
 
+void Renderer2D::DrawQuad(const glm::mat4 &transform, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawQuad(transform, texture, tilingFactor, color);
+}
 
-void Renderer2D::DrawLine(const glm::vec2 &start, const glm::vec2 &end, const glm::vec4 &color) {
-    DrawLine({ start.x, start.y, 0.0f }, { end.x, end.y, 0.0f }, color);
+void Renderer2D::DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawQuad(position, size, region, tilingFactor, color);
 }
 
-void Renderer2D::DrawLine(const glm::vec3 &start, const glm::vec3 &end, const glm::vec4 &color) {
-    if (sData.LineVertexBufferData.size() >= RendererData::MaxLineIndices) FlushAndReset(PrimitiveType::Line);
+void Renderer2D::DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawQuad(position, size, region, tilingFactor, color);
+}
+
+void Renderer2D::DrawQuad(const glm::mat4 &transform, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawQuad(transform, region, tilingFactor, color);
+}
 
-    sData.LineVertexBufferData.emplace_back(start, color);
-    sData.LineVertexBufferData.emplace_back(end, color);
 
-    sData.Stats.LineCount++;
+void Renderer2D::DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color) {
+    sData.List.DrawRotatedQuad(position, size, rotation, color);
 }
 
+void Renderer2D::DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color) {
+    sData.List.DrawRotatedQuad(position, size, rotation, color);
+}
 
-void Renderer2D::DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color) {
-    DrawQuad({ position.x, position.y, 0.0f }, size, color);
+void Renderer2D::DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const glm::vec4 &color) {
+    sData.List.DrawRotatedQuad(transform, rotation, color);
 }
 
-void Renderer2D::DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color) {
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+void Renderer2D::DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawRotatedQuad(position, size, rotation, texture, tilingFactor, color);
+}
 
-    DrawQuad(transform, color);
+void Renderer2D::DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawRotatedQuad(position, size, rotation, texture, tilingFactor, color);
 }
 
-void Renderer2D::DrawQuad(const glm::mat4 &transform, const glm::vec4 &color) {
-    const float textureIndex = 0.0f; // White Texture
-    glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
-    const float tilingFactor = 1.0f;
+void Renderer2D::DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawRotatedQuad(transform, rotation, texture, tilingFactor, color);
+}
 
-    if (sData.QuadVertexBufferData.size() * 6 >= RendererData::MaxQuadIndices) FlushAndReset();
+void Renderer2D::DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawRotatedQuad(position, size, rotation, region, tilingFactor, color);
+}
 
-    for (size_t i = 0; i < sData.QuadVertexPositions.size(); i++) {
-        sData.QuadVertexBufferData.emplace_back((transform * sData.QuadVertexPositions[i]), color, textureCoords[i], textureIndex, tilingFactor);
-    }
+void Renderer2D::DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    sData.List.DrawRotatedQuad(position, size, rotation, region, tilingFactor, color);
+}
 
-    sData.Stats.Triangles += 2;
-    sData.Stats.QuadCount++;
+
+void Renderer2D::DrawRect(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color) {
+    sData.List.DrawRect(position, size, color);
 }
 
-void Renderer2D::DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
-    DrawQuad({ position.x, position.y, 0.0f }, size, texture, tilingFactor, color);
+void Renderer2D::DrawRect(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color) {
+    sData.List.DrawRect(position, size, color);
+}
+
+void Renderer2D::DrawRect(const glm::mat4 &transform, const glm::vec4 &color) {
+    sData.List.DrawRect(transform, color);
 }
 
-void Renderer2D::DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
 
-    DrawQuad(transform, texture, tilingFactor, color);
+// Statistics
+void Renderer2D::ResetStatistics() {
+    memset(&sData.Stats, 0, sizeof(Statistics));
 }
 
-void Renderer2D::DrawQuad(const glm::mat4 &transform, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
-    glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+Renderer2D::Statistics Renderer2D::GetStatistics() {
+    return sData.Stats;
+}
+
+
+// Draw List
+DrawList2D::DrawList2D(): mTextureLookup(&GetTextureLookupPool()) {
+}
 
-    if (sData.QuadVertexBufferData.size() * 6 >= RendererData::MaxQuadIndices) FlushAndReset();
+void DrawList2D::Begin() {
+    mViewProjection = sData.CameraBuffer.ViewProjection;
+    mLayer = sData.List.mLayer;
+    mInstancing = sData.List.mInstancing;
+    Clear();
+}
+
+void DrawList2D::Clear() {
+    mPackets.clear();
+    mCircleVertices.clear();
+    mLineVertices.clear();
+    mQuadVertices.clear();
+    mQuadInstances.clear();
+    mCircleCount = 0;
+    mLineCount = 0;
+    mQuadCount = 0;
+
+    // The white texture is always the first texture
+    mTextures.clear();
+    mTextureLookup.clear();
+    mLastTexture = nullptr;
+    mLastTextureIndex = 0;
+    if (sData.WhiteTexture) {
+        mTextures.push_back(sData.WhiteTexture);
+        mTextureLookup.emplace(sData.WhiteTexture->GetRendererID(), 0);
+    }
+}
 
-    float textureIndex = 0.0f;
-    for (uint32_t i = 1; i < sData.TextureSlotIndex; i++) {
-        if (*sData.TextureSlots[i].get() == *texture.get()) {
-            textureIndex = (float)i;
-            break;
+void DrawList2D::SetLayer(uint8_t layer) {
+    mLayer = layer;
+}
+
+uint16_t DrawList2D::GetTexture(const Reference<Texture> &texture) {
+    if (!texture) return 0;
+
+    // Sprites are usually drawn in runs with the same texture (or atlas page), so the last one is cached
+    if (texture.get() == mLastTexture) return mLastTextureIndex;
+    uint16_t index {};
+    if (auto it = mTextureLookup.find(texture->GetRendererID()); it != mTextureLookup.end()) {
+        index = it->second;
+    } else {
+        // The key has room for 65536 textures per flush, more textures require an intermediate flush
+        if (mTextures.size() > SortKey::TextureMask) {
+            if (!mImmediate) {
+                LogWarning("[Renderer2D] The draw list exceeded {} textures, the white texture is used instead!", SortKey::TextureMask + 1);
+                return 0;
+            }
+            Renderer2D::Flush();
         }
+        index = static_cast<uint16_t>(mTextures.size());
+        mTextures.push_back(texture);
+        mTextureLookup.emplace(texture->GetRendererID(), index);
     }
+    mLastTexture = texture.get();
+    mLastTextureIndex = index;
+    return index;
+}
 
-    if (textureIndex == 0.0f) {
-        if (sData.TextureSlotIndex >= RendererData::MaxTextureSlots) FlushAndReset();
+uint32_t DrawList2D::GetDepth(const glm::vec3 &position) const {
+    // Only the z and w rows of the projection are needed
+    const auto &matrix = mViewProjection;
+    auto z = matrix[0].z * position.x + matrix[1].z * position.y + matrix[2].z * position.z + matrix[3].z;
+    auto w = matrix[0].w * position.x + matrix[1].w * position.y + matrix[2].w * position.z + matrix[3].w;
+    auto depth = w > 0.0f ? z / w * 0.5f + 0.5f : 1.0f;
+    return static_cast<uint32_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(SortKey::DepthMask));
+}
 
-        textureIndex = (float)sData.TextureSlotIndex;
-        sData.TextureSlots[sData.TextureSlotIndex] = texture;
-        sData.TextureSlotIndex++;
+void DrawList2D::Record(DrawPipeline pipeline, uint32_t index, const glm::vec3 &position, const glm::vec4 &color, uint16_t texture) {
+    // Circles fade out at their edges, textures with an alpha channel may have transparent texels
+    auto translucent = color.a < 1.0f || pipeline == DrawPipeline::Circle;
+    if (texture && Helpers::GetTextureFormatComponents(mTextures[texture]->GetProperties().Format) == 4) translucent = true;
+    mPackets.push_back({ SortKey::Encode(mLayer, translucent, pipeline, texture, GetDepth(position)), index });
+}
+
+void DrawList2D::SubmitQuad(const glm::mat4 &transform, const glm::vec4 &color, uint16_t texture, float tilingFactor, const glm::vec4 &rect) {
+    // Transforms without perspective and a flat depth fit into the 2x3 affine instance
+    auto flat = transform[0].z == 0.0f && transform[1].z == 0.0f && transform[0].w == 0.0f && transform[1].w == 0.0f && transform[3].w == 1.0f;
+    if (mInstancing && flat) {
+        SubmitQuadInstance({ transform[0].x, transform[1].x, transform[3].x }, { transform[0].y, transform[1].y, transform[3].y }, transform[3].z, color, texture, tilingFactor, rect);
+        return;
+    }
+
+    const glm::vec2 textureCoords[] = { { rect.x, rect.y }, { rect.z, rect.y }, { rect.z, rect.w }, { rect.x, rect.w } };
+
+    auto index = static_cast<uint32_t>(mQuadVertices.size() / 4);
+    for (size_t i = 0; i < QuadVertexPositions.size(); i++) {
+        mQuadVertices.emplace_back((transform * QuadVertexPositions[i]), color, textureCoords[i], static_cast<float>(texture), tilingFactor);
     }
+    Record(DrawPipeline::Quad, index, transform[3], color, texture);
+    mQuadCount++;
+}
 
-    for (size_t i = 0; i < sData.QuadVertexPositions.size(); i++) {
-        sData.QuadVertexBufferData.emplace_back((transform * sData.QuadVertexPositions[i]), color, textureCoords[i], textureIndex, tilingFactor);
+void DrawList2D::SubmitQuad(const glm::vec3 &position, const glm::vec2 &size, float rotation, const glm::vec4 &color, uint16_t texture, float tilingFactor, const glm::vec4 &rect) {
+    if (!mInstancing) {
+        auto transform = glm::translate(glm::mat4(1.0f), position)
+            * glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })
+            * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+        SubmitQuad(transform, color, texture, tilingFactor, rect);
+        return;
     }
 
-    sData.Stats.Triangles += 2;
-    sData.Stats.QuadCount++;
+    // Same as translate * rotate * scale, without building the matrix
+    auto cosine = rotation != 0.0f ? std::cos(rotation) : 1.0f;
+    auto sine = rotation != 0.0f ? std::sin(rotation) : 0.0f;
+    SubmitQuadInstance({ cosine * size.x, -sine * size.y, position.x }, { sine * size.x, cosine * size.y, position.y }, position.z, color, texture, tilingFactor, rect);
 }
 
+void DrawList2D::SubmitQuadInstance(const glm::vec3 &transformX, const glm::vec3 &transformY, float depth, const glm::vec4 &color, uint16_t texture, float tilingFactor, const glm::vec4 &rect) {
+    auto index = static_cast<uint32_t>(mQuadInstances.size());
+    mQuadInstances.push_back({ transformX, transformY, depth, color, rect, static_cast<float>(texture), tilingFactor });
+    Record(DrawPipeline::QuadInstance, index, { transformX.z, transformY.z, depth }, color, texture);
+    mQuadCount++;
+}
 
-void Renderer2D::DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color) {
-    DrawRotatedQuad({ position.x, position.y, 0.0f }, size, rotation, color);
+
+// Primitives
+void DrawList2D::DrawCircle(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color, float thickness, float fade) {
+    DrawCircle({ position.x, position.y, 0.0f }, size, color, thickness, fade);
 }
 
-void Renderer2D::DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color) {
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
-        * glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })
-        * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+void DrawList2D::DrawCircle(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color, float thickness, float fade) {
+    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+    DrawCircle(transform, color, thickness, fade);
+}
 
-    DrawRotatedQuad(transform, rotation, color);
+void DrawList2D::DrawCircle(const glm::mat4 &transform, const glm::vec4 &color, float thickness, float fade) {
+    auto index = static_cast<uint32_t>(mCircleVertices.size() / 4);
+    for (size_t i = 0; i < QuadVertexPositions.size(); i++) {
+        mCircleVertices.emplace_back((transform * QuadVertexPositions[i]), (QuadVertexPositions[i] * 2.0f), color, thickness, fade);
+    }
+    Record(DrawPipeline::Circle, index, transform[3], color);
+    mCircleCount++;
 }
 
-void Renderer2D::DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const glm::vec4 &color) {
-    // ToDo: rotation missing
-    if (rotation > 0) {}
-    const float textureIndex = 0.0f; // White Texture
-    glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
-    const float tilingFactor = 1.0f;
 
-    if (sData.QuadVertexBufferData.size() * 6 >= RendererData::MaxQuadIndices) FlushAndReset();
+void DrawList2D::DrawLine(const glm::vec2 &start, const glm::vec2 &end, const glm::vec4 &color) {
+    DrawLine({ start.x, start.y, 0.0f }, { end.x, end.y, 0.0f }, color);
+}
+
+void DrawList2D::DrawLine(const glm::vec3 &start, const glm::vec3 &end, const glm::vec4 &color) {
+    auto index = static_cast<uint32_t>(mLineVertices.size() / 2);
+    mLineVertices.emplace_back(start, color);
+    mLineVertices.emplace_back(end, color);
+    Record(DrawPipeline::Line, index, (start + end) * 0.5f, color);
+    mLineCount++;
+}
 
-    for (size_t i = 0; i < sData.QuadVertexPositions.size(); i++) {
-        sData.QuadVertexBufferData.emplace_back((transform * sData.QuadVertexPositions[i]), color, textureCoords[i], textureIndex, tilingFactor);
-    }
 
-    sData.Stats.Triangles += 2;
-    sData.Stats.QuadCount++;
+void DrawList2D::DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color) {
+    DrawQuad({ position.x, position.y, 0.0f }, size, color);
 }
 
-void Renderer2D::DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
-    DrawRotatedQuad({ position.x, position.y, 0.0f }, size, rotation, texture, tilingFactor, color);
+void DrawList2D::DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color) {
+    SubmitQuad(position, size, 0.0f, color);
 }
 
-void Renderer2D::DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
-        * glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })
-        * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+void DrawList2D::DrawQuad(const glm::mat4 &transform, const glm::vec4 &color) {
+    SubmitQuad(transform, color);
+}
 
-    DrawRotatedQuad(transform, rotation, texture, tilingFactor, color);
+void DrawList2D::DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    DrawQuad({ position.x, position.y, 0.0f }, size, texture, tilingFactor, color);
 }
 
-void Renderer2D::DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
-    // ToDo: rotation missing
-    if (rotation > 0) {}
-    glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+void DrawList2D::DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    SubmitQuad(position, size, 0.0f, color, GetTexture(texture), tilingFactor);
+}
 
-    if (sData.QuadVertexBufferData.size() * 6 >= RendererData::MaxQuadIndices) FlushAndReset();
+void DrawList2D::DrawQuad(const glm::mat4 &transform, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    SubmitQuad(transform, color, GetTexture(texture), tilingFactor);
+}
 
-    float textureIndex = 0.0f;
-    for (uint32_t i = 1; i < sData.TextureSlotIndex; i++) {
-        if (*sData.TextureSlots[i].get() == *texture.get()) {
-            textureIndex = (float)i;
-            break;
-        }
-    }
+void DrawList2D::DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    DrawQuad({ position.x, position.y, 0.0f }, size, region, tilingFactor, color);
+}
 
-    if (textureIndex == 0.0f) {
-        if (sData.TextureSlotIndex >= RendererData::MaxTextureSlots) FlushAndReset();
+void DrawList2D::DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    SubmitQuad(position, size, 0.0f, color, GetTexture(region.Texture), tilingFactor, region.Rect);
+}
 
-        textureIndex = (float)sData.TextureSlotIndex;
-        sData.TextureSlots[sData.TextureSlotIndex] = texture;
-        sData.TextureSlotIndex++;
-    }
+void DrawList2D::DrawQuad(const glm::mat4 &transform, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    SubmitQuad(transform, color, GetTexture(region.Texture), tilingFactor, region.Rect);
+}
 
 
-    for (size_t i = 0; i < sData.QuadVertexPositions.size(); i++) {
-        sData.QuadVertexBufferData.emplace_back((transform * sData.QuadVertexPositions[i]), color, textureCoords[i], textureIndex, tilingFactor);
-    }
+void DrawList2D::DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color) {
+    DrawRotatedQuad({ position.x, position.y, 0.0f }, size, rotation, color);
+}
+
+void DrawList2D::DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color) {
+    SubmitQuad(position, size, rotation, color);
+}
 
-    sData.Stats.Triangles += 2;
-    sData.Stats.QuadCount++;
+void DrawList2D::DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const glm::vec4 &color) {
+    // ToDo: rotation missing
+    if (rotation > 0) {}
+    SubmitQuad(transform, color);
 }
 
+void DrawList2D::DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    DrawRotatedQuad({ position.x, position.y, 0.0f }, size, rotation, texture, tilingFactor, color);
+}
 
-void Renderer2D::DrawRect(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color) {
+void DrawList2D::DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    SubmitQuad(position, size, rotation, color, GetTexture(texture), tilingFactor);
+}
+
+void DrawList2D::DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const Reference<Texture> &texture, const float tilingFactor, const glm::vec4 &color) {
+    // ToDo: rotation missing
+    if (rotation > 0) {}
+    SubmitQuad(transform, color, GetTexture(texture), tilingFactor);
+}
+
+void DrawList2D::DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    DrawRotatedQuad({ position.x, position.y, 0.0f }, size, rotation, region, tilingFactor, color);
+}
+
+void DrawList2D::DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const TextureRegion &region, const float tilingFactor, const glm::vec4 &color) {
+    SubmitQuad(position, size, rotation, color, GetTexture(region.Texture), tilingFactor, region.Rect);
+}
+
+
+void DrawList2D::DrawRect(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color) {
     DrawRect({ position.x, position.y, 0.0f }, size, color);
 }
 
-void Renderer2D::DrawRect(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color) {
+void DrawList2D::DrawRect(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color) {
     glm::vec3 p0 = glm::vec3(position.x - size.x * 0.5f, position.y - size.y * 0.5f, position.z);
     glm::vec3 p1 = glm::vec3(position.x + size.x * 0.5f, position.y - size.y * 0.5f, position.z);
     glm::vec3 p2 = glm::vec3(position.x + size.x * 0.5f, position.y + size.y * 0.5f, position.z);
@@ -553,9 +1018,9 @@ void Renderer2D::DrawRect(const glm::vec3 &position, const glm::vec2 &size, cons
     DrawLine(p3, p0, color);
 }
 
-void Renderer2D::DrawRect(const glm::mat4 &transform, const glm::vec4 &color) {
+void DrawList2D::DrawRect(const glm::mat4 &transform, const glm::vec4 &color) {
     glm::vec3 lineVertices[4];
-    for (size_t i = 0; i < 4; i++) lineVertices[i] = transform * sData.QuadVertexPositions[i];
+    for (size_t i = 0; i < 4; i++) lineVertices[i] = transform * QuadVertexPositions[i];
 
     DrawLine(lineVertices[0], lineVertices[1], color);
     DrawLine(lineVertices[1], lineVertices[2], color);
@@ -563,14 +1028,4 @@ void Renderer2D::DrawRect(const glm::mat4 &transform, const glm::vec4 &color) {
     DrawLine(lineVertices[3], lineVertices[0], color);
 }
 
-
-// Statistics
-void Renderer2D::ResetStatistics() {
-    memset(&sData.Stats, 0, sizeof(Statistics));
-}
-
-Renderer2D::Statistics Renderer2D::GetStatistics() {
-    return sData.Stats;
-}
-
 }
@@ -10,6 +10,7 @@ import Ultra.Renderer.OrthographicCamera;
 import Ultra.Renderer.CommandBuffer;
 import Ultra.Renderer.RenderDevice;
 import Ultra.Renderer.Texture;
+import Ultra.Renderer.TextureAtlas;
 
 namespace Ultra {
 
@@ -35,10 +36,126 @@ struct QuadComponent {
     float TilingFactor;
 };
 
+// The vertex shader expands the corners, so a quad only needs a transform (2x3 affine rows and depth) instead of four vertices
+struct QuadInstance {
+    glm::vec3 TransformX;
+    glm::vec3 TransformY;
+    float Depth;
+    glm::vec4 Color;
+    glm::vec4 TextureRect;
+    float TextureIndex;
+    float TilingFactor;
+};
+
+// Sort Keys
+enum class DrawPipeline: uint8_t {
+    Circle,
+    Line,
+    Quad,
+    QuadInstance,
+};
+
+// Every draw is recorded as a packet, the key decides the order and the index points into the vertex data of its pipeline
+struct DrawPacket {
+    uint64_t Key;
+    uint32_t Index;
+};
+
 }
 
 export namespace Ultra {
 
+///
+/// @brief Records draws independently of the renderer, so that jobs can fill several lists in parallel.
+/// Every list has its own vertex data and texture table, which are merged into the renderer queue on submission.
+///
+/// @example: How-To
+/// Renderer2D::DrawParallel(tiles.size(), 1024, [&](DrawList2D &list, size_t begin, size_t end) {
+///     for (auto i = begin; i < end; i++) list.DrawQuad(tiles[i].Position, { 1.0f, 1.0f }, tiles[i].Region);
+/// });
+///
+/// @note A list must only be used by one thread at a time, the lists are merged in submission order, so the result is deterministic.
+///
+class DrawList2D {
+    friend class Renderer2D;
+
+public:
+    DrawList2D();
+    ~DrawList2D() = default;
+
+    // Methods
+    ///
+    /// @brief Clears the list and takes the camera, layer and instancing state of the current scene.
+    ///
+    void Begin();
+    void Clear();
+    void SetLayer(uint8_t layer);
+
+    // Primitives
+    void DrawCircle(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color = glm::vec4(1.0f), float thickness = 1.0f, float fade = 0.005f);
+    void DrawCircle(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color = glm::vec4(1.0f), float thickness = 1.0f, float fade = 0.005f);
+    void DrawCircle(const glm::mat4 &transform, const glm::vec4 &color = glm::vec4(1.0f), float thickness = 1.0f, float fade = 0.005f);
+
+    void DrawLine(const glm::vec2 &start, const glm::vec2 &end, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawLine(const glm::vec3 &start, const glm::vec3 &end, const glm::vec4 &color = glm::vec4(1.0f));
+
+    void DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawQuad(const glm::mat4 &transform, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawQuad(const glm::mat4 &transform, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawQuad(const glm::mat4 &transform, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+
+    void DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+
+    void DrawRect(const glm::vec2 &position, const glm::vec2 &size = glm::vec2(1.0f), const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRect(const glm::vec3 &position, const glm::vec2 &size = glm::vec2(1.0f), const glm::vec4 &color = glm::vec4(1.0f));
+    void DrawRect(const glm::mat4 &transform, const glm::vec4 &color = glm::vec4(1.0f));
+
+    // Accessors
+    bool IsEmpty() const { return mPackets.empty(); }
+
+private:
+    uint16_t GetTexture(const Reference<Texture> &texture);
+    uint32_t GetDepth(const glm::vec3 &position) const;
+    void Record(DrawPipeline pipeline, uint32_t index, const glm::vec3 &position, const glm::vec4 &color, uint16_t texture = 0);
+    void SubmitQuad(const glm::mat4 &transform, const glm::vec4 &color, uint16_t texture = 0, float tilingFactor = 1.0f, const glm::vec4 &rect = { 0.0f, 0.0f, 1.0f, 1.0f });
+    void SubmitQuad(const glm::vec3 &position, const glm::vec2 &size, float rotation, const glm::vec4 &color, uint16_t texture = 0, float tilingFactor = 1.0f, const glm::vec4 &rect = { 0.0f, 0.0f, 1.0f, 1.0f });
+    void SubmitQuadInstance(const glm::vec3 &transformX, const glm::vec3 &transformY, float depth, const glm::vec4 &color, uint16_t texture, float tilingFactor, const glm::vec4 &rect);
+
+private:
+    // Properties
+    glm::mat4 mViewProjection { 1.0f };
+    uint8_t mLayer {};
+    bool mInstancing = true;
+    bool mImmediate = false;    // The renderer list flushes when the texture table is full, job lists can't
+
+    vector<DrawPacket> mPackets;
+    vector<CircleComponent> mCircleVertices;
+    vector<LineComponent> mLineVertices;
+    vector<QuadComponent> mQuadVertices;    // The texture index refers to 'mTextures' until the batch assigns the slots
+    vector<QuadInstance> mQuadInstances;    // The texture index refers to 'mTextures' until the batch assigns the slots
+
+    vector<Reference<Texture>> mTextures;   // 0 = White
+    std::pmr::unordered_map<RendererID, uint16_t> mTextureLookup;   // The nodes come from a pool, which recycles them after every clear
+    const Texture *mLastTexture = nullptr;
+    uint16_t mLastTextureIndex = 0;
+
+    uint32_t mCircleCount {};
+    uint32_t mLineCount {};
+    uint32_t mQuadCount {};
+};
+
 class Renderer2D {
 public:
     Renderer2D() = default;
@@ -54,6 +171,32 @@ public:
     static void FinishScene();
     static void Flush();
 
+    ///
+    /// @brief Marks the frame boundary for the streamed vertex and uniform data, it is called by the renderer once per frame.
+    ///
+    static void NextFrame();
+
+    ///
+    /// @brief Draws of a lower layer are rendered before draws of a higher layer (reset with every scene).
+    /// @note Opaque draws are resolved by the depth test, so the layers only order the translucent draws reliably.
+    ///
+    static void SetLayer(uint8_t layer);
+
+    ///
+    /// @brief Quads with a flat (2D affine) transform are uploaded as instances, others fall back to vertices (enabled by default).
+    ///
+    static void SetInstancing(bool enabled);
+
+    ///
+    /// @brief Appends a list, which was recorded by a job, its textures are remapped to the frame textures.
+    ///
+    static void Submit(const DrawList2D &list);
+
+    ///
+    /// @brief Splits [0, count) into chunks of 'grain' elements, which are recorded in parallel into pooled lists and submitted in chunk order.
+    ///
+    static void DrawParallel(size_t count, size_t grain, const function<void(DrawList2D &list, size_t begin, size_t end)> &function);
+
     // Primitives
     static void DrawCircle(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color = glm::vec4(1.0f), float thickness = 1.0f, float fade = 0.005f);
     static void DrawCircle(const glm::vec3 &position, const glm::vec2 &size, const glm::vec4 &color = glm::vec4(1.0f), float thickness = 1.0f, float fade = 0.005f);
@@ -68,6 +211,9 @@ public:
     static void DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
     static void DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
     static void DrawQuad(const glm::mat4 &transform, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    static void DrawQuad(const glm::vec2 &position, const glm::vec2 &size, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    static void DrawQuad(const glm::vec3 &position, const glm::vec2 &size, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    static void DrawQuad(const glm::mat4 &transform, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
 
     static void DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color = glm::vec4(1.0f));
     static void DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const glm::vec4 &color = glm::vec4(1.0f));
@@ -75,6 +221,8 @@ public:
     static void DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
     static void DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
     static void DrawRotatedQuad(const glm::mat4 &transform, const float rotation, const Reference<Texture> &texture, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    static void DrawRotatedQuad(const glm::vec2 &position, const glm::vec2 &size, const float rotation, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
+    static void DrawRotatedQuad(const glm::vec3 &position, const glm::vec2 &size, const float rotation, const TextureRegion &region, const float tilingFactor = 1.0f, const glm::vec4 &color = glm::vec4(1.0f));
 
     static void DrawRect(const glm::vec2 &position, const glm::vec2 &size = glm::vec2(1.0f), const glm::vec4 &color = glm::vec4(1.0f));
     static void DrawRect(const glm::vec3 &position, const glm::vec2 &size = glm::vec2(1.0f), const glm::vec4 &color = glm::vec4(1.0f));
@@ -87,6 +235,9 @@ public:
         uint32_t CircleCount = 0;
         uint32_t LineCount = 0;
         uint32_t QuadCount = 0;
+        uint32_t StateChanges = 0;  // Pipeline switches and texture slot rebinds
+        uint32_t BatchBreaks = 0;   // Batches split without a pipeline switch (buffer capacity or texture slots)
+        uint32_t TextureBreaks = 0; // Batches split because all texture slots were occupied (atlases keep this low)
 
         uint32_t GetTotalVertexCount() { return (CircleCount + QuadCount) * 4 + LineCount * 2; }
         uint32_t GetTotalIndexCount() { return (CircleCount + QuadCount) * 6 + LineCount * 2; }
@@ -96,7 +247,7 @@ public:
 
 private:
     static void NextBatch();
-    static void FlushAndReset(PrimitiveType primitive = PrimitiveType::Triangle);
+    static void UploadCamera();
 
     static Scope<CommandBuffer> sCommandBuffer;
 };
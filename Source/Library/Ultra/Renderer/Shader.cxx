@@ -1,14 +1,214 @@
 ﻿module Ultra.Renderer.Shader;
 
+import Ultra.Core.Future;
 import Ultra.System.FileSystem;
 
 import Ultra.Graphics.Context;
 import Ultra.Platform.Renderer.DXShader;
 import Ultra.Platform.Renderer.GLShader;
+import Ultra.Platform.Renderer.SWShader;
 import Ultra.Platform.Renderer.VKShader;
+import Ultra.Renderer.ShaderCompiler;
 
 namespace Ultra {
 
+// Helpers
+namespace {
+
+constexpr auto ReloadInterval = std::chrono::milliseconds(250);
+constexpr auto ShaderIncludeDirectory = "Assets/Shaders/Defaults/";
+
+///
+/// @brief The living shaders, a finished reload checks it, as the shader could have been destroyed meanwhile.
+///
+struct ShaderRegistry {
+    mutex Mutex;
+    std::unordered_set<Shader *> Shaders;
+
+    static ShaderRegistry &Instance() {
+        static ShaderRegistry instance;
+        return instance;
+    }
+};
+
+struct ReloadResult {
+    unordered_map<size_t, string> Shaders;
+    vector<string> Includes;
+    bool Compiled = false;
+};
+
+std::filesystem::file_time_type GetWriteTime(const string &path) {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type {} : time;
+}
+
+string_view Trim(string_view text) {
+    auto begin = text.find_first_not_of(" \t");
+    if (begin == string_view::npos) return {};
+    auto end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+///
+/// @brief Returns the arguments of a directive (e.g. '#include <File>' → '<File>'), if the line contains it.
+///
+std::optional<string_view> GetDirective(string_view line, string_view directive) {
+    line = Trim(line);
+    if (line.empty() || line.front() != '#') return {};
+    line = Trim(line.substr(1));
+    if (!line.starts_with(directive)) return {};
+    line.remove_prefix(directive.size());
+    if (!line.empty() && line.front() != ' ' && line.front() != '\t') return {};
+    return Trim(line);
+}
+
+template<typename F>
+void ForEachLine(string_view text, F &&function) {
+    while (!text.empty()) {
+        auto end = text.find('\n');
+        auto line = text.substr(0, end);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        function(line);
+        if (end == string_view::npos) break;
+        text.remove_prefix(end + 1);
+    }
+}
+
+string GetLineDirective(uint32_t line, const string &file) {
+    return std::format("#line {} \"{}\"\n", line, file);
+}
+
+///
+/// @brief Removes non-ascii characters (e.g. the byte order mark), which glslang doesn't accept.
+///
+string Sanitize(string source) {
+    source.erase(std::remove_if(source.begin(), source.end(), [](char c) { return static_cast<unsigned char>(c) >= 128; }), source.end());
+    return source;
+}
+
+///
+/// @brief Included file, which is shared by all shaders and only read again, after it was modified.
+///
+struct IncludeFile {
+    std::filesystem::file_time_type Time;
+    string Source;
+    bool Once = false;  // Marked with '#pragma once' or wrapped in an include guard
+};
+
+class IncludeCache {
+public:
+    static IncludeCache &Instance() {
+        static IncludeCache instance;
+        return instance;
+    }
+
+    Reference<const IncludeFile> Load(const string &path) {
+        // The time is taken before the file is read, so that a write meanwhile invalidates the entry
+        auto time = GetWriteTime(path);
+        {
+            std::lock_guard<mutex> lock(mMutex);
+            auto cached = mFiles.find(path);
+            if (cached != mFiles.end() && cached->second->Time == time) return cached->second;
+        }
+        if (!File::Exists(path)) return nullptr;
+
+        auto file = CreateReference<IncludeFile>();
+        file->Time = time;
+        file->Source = Sanitize(File::LoadAsString(path));
+        Analyze(*file);
+
+        std::lock_guard<mutex> lock(mMutex);
+        mFiles[path] = file;
+        return file;
+    }
+
+private:
+    static void Analyze(IncludeFile &file) {
+        // An include guard is detected, if the first directives are '#ifndef X' and '#define X' and the last one is '#endif'
+        vector<std::pair<string_view, string_view>> directives;
+        ForEachLine(file.Source, [&](string_view line) {
+            auto trimmed = Trim(line);
+            if (trimmed.empty() || trimmed.front() != '#') return;
+            trimmed = Trim(trimmed.substr(1));
+            auto split = trimmed.find_first_of(" \t");
+            auto name = trimmed.substr(0, split);
+            directives.push_back({ name, split == string_view::npos ? string_view {} : Trim(trimmed.substr(split)) });
+        });
+        if (directives.size() >= 3 && directives[0].first == "ifndef" && directives[1].first == "define" && directives[0].second == directives[1].second && directives.back().first == "endif") {
+            file.Once = true;
+        }
+
+        // The pragma is removed, the line stays empty, so that the line numbers don't shift
+        for (size_t position = 0; position < file.Source.size();) {
+            auto end = file.Source.find('\n', position);
+            if (end == string::npos) end = file.Source.size();
+            auto line = string_view(file.Source).substr(position, end - position);
+            if (auto pragma = GetDirective(line, "pragma"); pragma && pragma->starts_with("once")) {
+                file.Source.erase(position, line.size());
+                file.Once = true;
+                end = position;
+            }
+            position = end + 1;
+        }
+    }
+
+private:
+    mutex mMutex;
+    unordered_map<string, Reference<const IncludeFile>> mFiles;
+};
+
+}
+
+///
+/// @brief State of a single preprocessor pass, which splits the stages and expands the includes at the same time.
+///
+struct Shader::PreprocessState {
+    unordered_map<size_t, string> Stages;
+    string *Output = nullptr;
+    vector<string> *Includes = nullptr;
+    std::unordered_set<string> Once;    // Files, which mustn't be included again into the current stage
+    vector<string> Stack;               // Files, which are currently expanded (to detect recursive includes)
+    size_t Type = 0;
+    uint32_t Line = 1;
+    bool Header = false;
+    bool Typed = false;
+
+    void BeginStage(size_t type, uint32_t line) {
+        Type = type;
+        Output = &Stages[type];
+        Output->clear();
+        Once.clear();
+        Line = line;
+        Header = false;
+    }
+
+    void FinishStage(const string &name) {
+        // Stages without '#version' get the header at the top
+        if (Header) return;
+        Output->insert(0, GetHeader() + GetLineDirective(Line, name));
+        Header = true;
+    }
+
+    string GetHeader() const {
+        // The extension allows file names in '#line', so that the compiler errors point at the included files
+        string header = "#extension GL_GOOGLE_cpp_style_line_directive : enable\n";
+        if (!Typed) return header;
+        switch ((ShaderType)Type) {
+            case ShaderType::Compute:       { return header + "#define COMPUTE_SHADER\n"; }
+            case ShaderType::Fragment:      { return header + "#define PIXEL_SHADER\n"; }
+            case ShaderType::Geometry:      { return header + "#define GEOMETRY_SHADER\n"; }
+            case ShaderType::TessControl:   { return header + "#define TESSELLATION_CONTROL_SHADER\n"; }
+            case ShaderType::TessEvaluation:{ return header + "#define TESSELLATION_EVALUATION_SHADER\n"; }
+            case ShaderType::Vertex:        { return header + "#define VERTEX_SHADER\n"; }
+            default: {
+                LogWarning("The shader type couldn't be detected or wasn't specified!");
+                return header;
+            }
+        }
+    }
+};
+
 Scope<Shader> Shader::Create(const string &source, ShaderType type) {
     return Shader::Create(source, "main", type);
 }
@@ -17,6 +217,7 @@ Scope<Shader> Shader::Create(const string &source, const string &entryPoint, con
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateScope<DXShader>(source, entryPoint, type); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLShader>(source, entryPoint, type); }
+        case GraphicsAPI::Software: { return CreateScope<SWShader>(source, entryPoint, type); }
         case GraphicsAPI::Vulkan:   { return CreateScope<VKShader>(source, entryPoint, type); }
 
         default: {
@@ -30,121 +231,211 @@ Scope<Shader> Shader::Create(const string &source, const string &entryPoint, con
     }
 }
 
+Shader::Shader(const string &source, const string &entryPoint, const ShaderType type): mSource(source), mEntryPoint(entryPoint), mType(type) {
+    auto &registry = ShaderRegistry::Instance();
+    std::lock_guard<mutex> lock(registry.Mutex);
+    registry.Shaders.insert(this);
+}
+
+Shader::~Shader() {
+    auto &registry = ShaderRegistry::Instance();
+    std::lock_guard<mutex> lock(registry.Mutex);
+    registry.Shaders.erase(this);
+}
 
-void Shader::Preprocess(string &source, const string &directory) {
-    std::regex includeRegex(R""(#include\s+[<"]([^">]+)[">])"");
-    std::smatch match;
 
-    // Process includes
-    while (std::regex_search(source, match, includeRegex)) {
-        auto includeDirective = match[0].str();
-        auto includeFile = match[1].str();
-        string includeFilePath;
+UniformHandle Shader::GetUniform(const string &name) const {
+    auto cached = mUniformCache.find(name);
+    if (cached != mUniformCache.end()) return { cached->second };
 
-        // Check if include file is a default shader
-        if (includeDirective.find('<') != std::string::npos) {
-            includeFilePath = "Assets/Shaders/Defaults/" + includeFile;
-        } else {
-            includeFilePath = directory + "/" + includeFile;
-        }
+    // Explicit locations are known from the reflection, the backend is only asked for the rest
+    auto *resource = mReflection.Find(name);
+    auto location = resource && resource->Location >= 0 ? resource->Location : FindUniformLocation(name);
+    mUniformCache.emplace(name, location);
+    return { location };
+}
 
-        if (!Directory::ValidatePath(includeFilePath)) {
-            LogError("Include file not found: {}", includeFilePath);
-            return;
-        }
 
-        auto includeSource = File::LoadAsString(includeFilePath);
-        Preprocess(includeSource, File::GetPath(includeFilePath));  // Recursive include processing
+void Shader::ReloadChanged() {
+    static auto last = std::chrono::steady_clock::now();
+    auto now = std::chrono::steady_clock::now();
+    if (now - last < ReloadInterval) return;
+    last = now;
 
-        // Remove non-ascii characters
-        includeSource.erase(std::remove_if(includeSource.begin(), includeSource.end(), [](char c) { return static_cast<unsigned char>(c) >= 128; }), includeSource.end());
-        
-        // Replace include directive with include source
-        source.replace(match.position(), includeDirective.length(), includeSource);
+    vector<Shader *> changed;
+    {
+        auto &registry = ShaderRegistry::Instance();
+        std::lock_guard<mutex> lock(registry.Mutex);
+        for (auto *shader : registry.Shaders) {
+            if (!shader->mReloading && shader->HasChanged()) changed.push_back(shader);
+        }
     }
+    for (auto *shader : changed) shader->Reload();
 }
 
+
 Shader::ShaderList Shader::Convert(string &source) {
     // Check if source is file path and load the code
-    auto directory = File::GetPath(source);
+    string path;
     if (Directory::ValidatePath(source)) {
+        path = source;
         mShaderName = File::GetName(source);
         source = File::LoadAsString(source);
     }
 
-    // Process includes
-    Preprocess(source, directory);
-
-    // Detect newline format (Linux, Windows, Mac)
-    auto eolConversion = '\n';
-    auto eolSize = 1u;
-    auto cr = source.find_first_of('\r');
-    auto lf = source.find_first_of('\n');
-    if (cr != string::npos) {
-        eolConversion = '\r';
-        if (lf != string::npos) eolSize = 2u;
+    vector<string> includes;
+    auto shaders = Parse(source, path, mType, includes);
+    if (!path.empty()) Watch(path, includes);
+    return shaders;
+}
+
+Shader::ShaderList Shader::Parse(const string &source, const string &path, ShaderType type, vector<string> &includes) {
+    PreprocessState state;
+    state.Includes = &includes;
+    state.BeginStage((size_t)type, 1);
+
+    auto name = path.empty() ? string("inline") : std::filesystem::path(path).generic_string();
+    Preprocess(Sanitize(source), name, File::GetPath(path), state, 0);
+    state.FinishStage(name);
+
+    // ... without a '#type' the source is returned as it is, but a warning is raised, if the type wasn't specified
+    if (!state.Typed && type == ShaderType::Linked) {
+        LogWarning("The shader type couldn't be detected and wasn't specified!");
     }
+    return std::move(state.Stages);
+}
 
-    // Detect type and split source ...
-    ShaderList shaders;
-    string_view elements = source;
-    string_view token = "#type ";
-    for (auto element : std::views::split(elements, token)) {
-        // Skip the first element and empty elements (since they don't contain a "#type" definition)
-        if (element.begin() == elements.begin() || element.empty()) continue;
-
-        // Extract the shader type
-        auto typeEnd = std::ranges::find(element, eolConversion);
-        auto typeLength = std::ranges::distance(element.begin(), typeEnd);
-        string_view type(&*element.begin(), typeLength);
-
-        // Extract the shader code
-        auto codeStart = typeEnd + eolSize;
-        auto codeLength = std::ranges::distance(codeStart, element.end());
-        string code(&*codeStart, codeLength);
-
-        // Determine shader type and prepend appropriate define directive
-        auto shaderType = (ShaderType)ShaderTypeFromString(string(type));
-        string defineDirective;
-        switch (shaderType) {
-            case ShaderType::Compute:       { defineDirective = "#define COMPUTE_SHADER\n"; break; }
-            case ShaderType::Fragment:      { defineDirective = "#define PIXEL_SHADER\n"; break; }
-            case ShaderType::Geometry:      { defineDirective = "#define GEOMETRY_SHADER\n"; break; }
-            case ShaderType::TessControl:   { defineDirective = "#define TESSELLATION_CONTROL_SHADER\n"; break; }
-            case ShaderType::TessEvaluation:{ defineDirective = "#define TESSELLATION_EVALUATION_SHADER\n"; break; }
-            case ShaderType::Vertex:        { defineDirective = "#define VERTEX_SHADER\n"; break; }
-            default: {
-                LogWarning("The shader type couldn't be detected or wasn't specified!");
-                break;
+void Shader::Preprocess(const string &source, const string &name, const string &directory, PreprocessState &state, uint32_t depth) {
+    uint32_t number = 0;
+    ForEachLine(source, [&](string_view line) {
+        number++;
+
+        // Stages are split at '#type', the stage define is injected after '#version' (only in the shader itself)
+        if (depth == 0) {
+            if (auto type = GetDirective(line, "type")) {
+                state.FinishStage(name);
+                if (!state.Typed) {
+                    state.Stages.clear();
+                    state.Typed = true;
+                }
+                state.BeginStage(ShaderTypeFromString(string(Trim(*type))), number + 1);
+                return;
+            }
+            if (GetDirective(line, "version") && !state.Header) {
+                state.Output->append(line).append("\n");
+                state.Output->append(state.GetHeader());
+                state.Output->append(GetLineDirective(number + 1, name));
+                state.Header = true;
+                return;
             }
         }
 
-        // Find the position of the #version directive
-        auto versionPos = code.find("#version");
-        if (versionPos != string::npos) {
-            // Find the end of the #version directive line
-            auto versionEnd = code.find('\n', versionPos);
-            if (versionEnd != string::npos) {
-                // Insert the define directive after the #version directive
-                code.insert(versionEnd + 1, defineDirective);
-            }
-        } else {
-            // If there's no #version directive, prepend the define directive to the code
-            code = defineDirective + code;
+        auto include = GetDirective(line, "include");
+        if (!include) {
+            state.Output->append(line).append("\n");
+            return;
         }
 
-        // Store the shader code in the map
-        shaders[ShaderTypeFromString(string(type))] = code;
-    }
+        // The line stays in place (empty), so that the line numbers don't shift
+        auto target = Trim(*include);
+        state.Output->append("\n");
+        if (target.size() < 2 || !((target.front() == '<' && target.back() == '>') || (target.front() == '"' && target.back() == '"'))) {
+            LogError("{}({}): Invalid include directive '{}'!", name, number, line);
+            return;
+        }
+        auto file = string(target.substr(1, target.size() - 2));
+        auto path = target.front() == '<' ? ShaderIncludeDirectory + file : (directory.empty() ? file : directory + "/" + file);
+        path = std::filesystem::path(path).lexically_normal().generic_string();
+
+        auto included = IncludeCache::Instance().Load(path);
+        if (!included) {
+            LogError("{}({}): Include file not found: {}", name, number, path);
+            return;
+        }
+        if (std::ranges::find(*state.Includes, path) == state.Includes->end()) state.Includes->push_back(path);
+        if (state.Once.contains(path)) return;
+        if (included->Once) state.Once.insert(path);
+        if (std::ranges::find(state.Stack, path) != state.Stack.end()) {
+            LogError("{}({}): The include of '{}' is recursive!", name, number, path);
+            return;
+        }
+
+        state.Stack.push_back(path);
+        state.Output->append(GetLineDirective(1, path));
+        Preprocess(included->Source, path, File::GetPath(path), state, depth + 1);
+        state.Output->append(GetLineDirective(number + 1, name));
+        state.Stack.pop_back();
+    });
+}
+
+
+bool Shader::HasChanged() const {
+    return std::ranges::any_of(mDependencies, [](const Dependency &dependency) {
+        return GetWriteTime(dependency.Path) != dependency.Time;
+    });
+}
+
+void Shader::Reload() {
+    // The times are taken before the files are read, so that a write during the reload triggers another one
+    mReloading = true;
+    for (auto &dependency : mDependencies) dependency.Time = GetWriteTime(dependency.Path);
+    LogInfo("[Shader] Reloading '{}' ...", mShaderName);
+
+    auto path = mDependencies.front().Path;
+    Async([path, type = mType, name = mShaderName] {
+        ReloadResult result;
+        result.Shaders = Parse(File::LoadAsString(path), path, type, result.Includes);
+
+        // The binaries land in the cache, so the swap on the main thread only has to load and link them
+        auto binaries = ShaderCompiler::CompileStages(name, result.Shaders);
+        result.Compiled = std::ranges::all_of(result.Shaders, [&](const auto &stage) {
+            return binaries.contains(stage.first) && !binaries[stage.first].empty();
+        });
+        return result;
+    }).OnComplete([this, path](const Future<ReloadResult> &future) {
+        {
+            auto &registry = ShaderRegistry::Instance();
+            std::lock_guard<mutex> lock(registry.Mutex);
+            if (!registry.Shaders.contains(this)) return;
+        }
+        mReloading = false;
+        if (future.GetException()) {
+            LogError("[Shader] Reloading '{}' failed, the previous program stays active!", mShaderName);
+            return;
+        }
 
-    // ... otherwise, return the source as it is, but raise a warning, if the type wasn't specified
-    if (shaders.empty()) {
-        if (mType == ShaderType::Linked) {
-            LogWarning("The shader type couldn't be detected and wasn't specified!");
+        const auto &result = future.Get();
+        auto times = std::move(mDependencies);
+        Watch(path, result.Includes);
+        for (auto &dependency : mDependencies) {
+            auto match = std::ranges::find(times, dependency.Path, &Dependency::Path);
+            if (match != times.end()) dependency.Time = match->Time;
+        }
+
+        if (!result.Compiled) {
+            LogError("[Shader] Reloading '{}' failed, the previous program stays active!", mShaderName);
+            return;
         }
-        shaders[(size_t)(mType)] = source;
+        Compile(result.Shaders);
+        LogInfo("[Shader] Reloaded '{}'", mShaderName);
+    }, Launch::MainThread);
+}
+
+void Shader::Reflect(const unordered_map<size_t, vector<uint32_t>> &binaries) {
+    mReflection.Clear();
+    mUniformCache.clear();
+    for (const auto &[stage, binary] : binaries) {
+        if (!binary.empty()) mReflection.Reflect(binary, stage);
+    }
+}
+
+void Shader::Watch(const string &path, const vector<string> &includes) {
+    mDependencies.clear();
+    mDependencies.push_back({ path, GetWriteTime(path) });
+    for (const auto &include : includes) {
+        if (std::ranges::find(mDependencies, include, &Dependency::Path) != mDependencies.end()) continue;
+        mDependencies.push_back({ include, GetWriteTime(include) });
     }
-    return shaders;
 }
 
 }
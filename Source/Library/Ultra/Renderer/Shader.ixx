@@ -4,6 +4,8 @@ export import Ultra.Core;
 export import Ultra.Logger;
 export import Ultra.Math;
 
+export import Ultra.Renderer.ShaderReflection;
+
 import Ultra.Renderer.Texture;
 import Ultra.Renderer.Data;
 
@@ -178,6 +180,16 @@ string ShaderTypeToString(ShaderType type) {
 }
 
 
+///
+/// @brief Resolved uniform location, obtained once per name, so that the updates skip the string lookup.
+///
+struct UniformHandle {
+    int32_t Location = -1;
+
+    explicit operator bool() const { return Location >= 0; }
+};
+
+
 /// 
 /// @brief Agnostic Shader
 ///
@@ -188,15 +200,28 @@ string ShaderTypeToString(ShaderType type) {
 /// @example: Linked
 /// auto linkedShaders = Shader::Create("example.glsl");
 ///
+/// @example: Uniforms
+/// auto color = shader->GetUniform("uColor");  // Resolved once, the locations come from the SPIR-V reflection
+/// shader->UpdateUniform(color, Float4 { 1.0f, 0.0f, 0.0f, 1.0f });
+/// shader->UpdateUniform("uColor", Float4 { 1.0f, 0.0f, 0.0f, 1.0f }); // Slow path through the name cache
+///
+/// @note Shaders loaded from a file are reloaded, when the file or one of its includes changes. The stages are compiled
+/// on a worker and the program is swapped at the start of the next frame, if the compilation fails the old one stays.
+///
 class Shader {
 protected:
     using ShaderList = unordered_map<size_t, string>;
 
-    Shader(const string &source, const string &entryPoint, const ShaderType type): mSource(source), mEntryPoint(entryPoint), mType(type) {}
+    struct Dependency {
+        string Path;
+        std::filesystem::file_time_type Time;
+    };
+
+    Shader(const string &source, const string &entryPoint, const ShaderType type);
 
 public:
     Shader() = default;
-    virtual ~Shader() = default;
+    virtual ~Shader();
 
     static Scope<Shader> Create(const string &source, const ShaderType type = ShaderType::Linked);
     static Scope<Shader> Create(const string &source, const string &entryPoint, const ShaderType type = ShaderType::Linked);
@@ -205,45 +230,80 @@ public:
     virtual void Bind() const = 0;
     virtual void Unbind() const = 0;
 
+    ///
+    /// @brief Checks the sources of all shaders for changes (throttled, so it can be called every frame from the main thread).
+    ///
+    static void ReloadChanged();
+
     // Accessors
     virtual int32_t FindUniformLocation(const string &name) const = 0;
+    UniformHandle GetUniform(const string &name) const;
+    const ShaderReflection &GetReflection() const { return mReflection; }
 
     // Mutators
-    virtual void UpdateUniformBuffer(const string &name, const void *data, size_t size) = 0;
-    virtual void UpdateUniform(const string &name, const Bool &data) = 0;
-    virtual void UpdateUniform(const string &name, const Bool2 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Bool3 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Bool4 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Double &data) = 0;
-    virtual void UpdateUniform(const string &name, const Double2 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Double3 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Double4 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Float &data) = 0;
-    virtual void UpdateUniform(const string &name, const Float2 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Float3 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Float4 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Int &data) = 0;
-    virtual void UpdateUniform(const string &name, const Int2 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Int3 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Int4 &data) = 0;
-    virtual void UpdateUniform(const string &name, const UInt &data) = 0;
-    virtual void UpdateUniform(const string &name, const UInt2 &data) = 0;
-    virtual void UpdateUniform(const string &name, const UInt3 &data) = 0;
-    virtual void UpdateUniform(const string &name, const UInt4 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Matrix2 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Matrix3 &data) = 0;
-    virtual void UpdateUniform(const string &name, const Matrix4 &data) = 0;
+    template<typename T>
+    void UpdateUniform(const string &name, const T &data) {
+        UpdateUniform(GetUniform(name), data);
+    }
+    void UpdateUniformBuffer(const string &name, const void *data, size_t size) {
+        UpdateUniformBuffer(GetUniform(name), data, size);
+    }
+    virtual void UpdateUniformBuffer(UniformHandle uniform, const void *data, size_t size) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Bool &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Bool2 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Bool3 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Bool4 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Double &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Double2 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Double3 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Double4 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Float &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Float2 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Float3 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Float4 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Int &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Int2 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Int3 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Int4 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const UInt &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const UInt2 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const UInt3 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const UInt4 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Matrix2 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Matrix3 &data) = 0;
+    virtual void UpdateUniform(UniformHandle uniform, const Matrix4 &data) = 0;
 
 protected:
-    void Preprocess(string &source, const string &directory);
+    struct PreprocessState;
+
+    ///
+    /// @brief Splits the stages and expands the includes in a single pass, the included files are cached until they are modified.
+    /// Files with '#pragma once' or an include guard are only included once per stage, '#line' directives map the errors to the right file.
+    ///
+    static ShaderList Parse(const string &source, const string &path, ShaderType type, vector<string> &includes);
+    static void Preprocess(const string &source, const string &name, const string &directory, PreprocessState &state, uint32_t depth);
     ShaderList Convert(string &source);
+    void Reflect(const unordered_map<size_t, vector<uint32_t>> &binaries);
 
+private:
+    bool HasChanged() const;
+    void Reload();
+    void Watch(const string &path, const vector<string> &includes);
+
+protected:
     ShaderList mShaders;
-    RendererID mShaderID;
+    RendererID mShaderID {};
     string mShaderName;
     string mEntryPoint;
     string mSource;
     ShaderType mType;
+
+private:
+    vector<Dependency> mDependencies;
+    bool mReloading = false;
+
+    ShaderReflection mReflection;
+    mutable unordered_map<string, int32_t> mUniformCache;
 };
 
 }
@@ -3,9 +3,53 @@
 import <shaderc/shaderc.hpp>;
 
 import Ultra.Logger;
+import Ultra.Core.JobSystem;
+import Ultra.System.FileSystem;
 
 namespace Ultra::ShaderCompiler {
 
+// Helpers
+namespace {
+
+// Has to be increased, when the compiler options change, so that stale binaries aren't reused
+constexpr auto CacheVersion = "Ultra.SPIRV.1|ENGINE=Ultra";
+constexpr uint32_t SpirvMagic = 0x07230203;
+
+// Shaders are reloaded on workers, so the statistics are guarded
+CacheStatistics sCacheStatistics;
+mutex sCacheMutex;
+
+///
+/// @brief Every thread keeps its own compiler, so that the parallel compilation doesn't share state and the setup isn't repeated.
+///
+shaderc::Compiler &GetCompiler() {
+    static thread_local shaderc::Compiler compiler;
+    return compiler;
+}
+
+uint64_t HashCombine(uint64_t hash, string_view data) {
+    // FNV-1a, unlike std::hash the result is stable across builds, which is required for the file names
+    for (auto character : data) {
+        hash ^= static_cast<uint8_t>(character);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+string GetCacheKey(ShaderType type, const string &source, bool optimize) {
+    auto hash = HashCombine(0xCBF29CE484222325ull, CacheVersion);
+    hash = HashCombine(hash, ShaderTypeToString(type));
+    hash = HashCombine(hash, optimize ? "optimize" : "debug");
+    hash = HashCombine(hash, source);
+    return std::format("{:016x}", hash);
+}
+
+double GetMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
 shaderc_shader_kind GetNativeShaderKind(ShaderType type) {
     switch (type) {
         case ShaderType::Fragment: { return shaderc_fragment_shader; }
@@ -24,7 +68,7 @@ vector<uint32_t> Compile(const string &name, ShaderType type, const string &sour
     options.AddMacroDefinition("ENGINE", "Ultra");
     if (optimize) options.SetOptimizationLevel(shaderc_optimization_level_size);
 
-    shaderc::Compiler compiler;
+    auto &compiler = GetCompiler();
     auto result = compiler.CompileGlslToSpv(source, GetNativeShaderKind(type), name.c_str(), options);
 
     if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
@@ -35,12 +79,68 @@ vector<uint32_t> Compile(const string &name, ShaderType type, const string &sour
 
 }
 
+unordered_map<size_t, vector<uint32_t>> CompileStages(const string &name, const unordered_map<size_t, string> &stages, bool optimize) {
+    struct Stage {
+        size_t Type;
+        const string *Source;
+        string Cache;
+        vector<uint32_t> Binary;
+    };
+    unordered_map<size_t, vector<uint32_t>> result;
+    vector<Stage> misses;
+
+    // Load the cached binaries, a damaged file counts as miss
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &[type, source] : stages) {
+        auto cache = ShaderCacheDirectory + GetCacheKey((ShaderType)type, source, optimize) + ".spirv";
+        if (File::Exists(cache)) {
+            auto binary = File::LoadAsBinary(cache);
+            if (!binary.empty() && binary.front() == SpirvMagic) {
+                result[type] = std::move(binary);
+                continue;
+            }
+        }
+        misses.push_back({ type, &source, std::move(cache), {} });
+    }
+    {
+        std::lock_guard<mutex> lock(sCacheMutex);
+        sCacheStatistics.Hits += static_cast<uint32_t>(result.size());
+        sCacheStatistics.LoadTime += GetMilliseconds(start);
+    }
+    if (misses.empty()) return result;
+
+    // Compile the remaining stages on the workers
+    start = std::chrono::steady_clock::now();
+    JobSystem::Instance().ParallelFor(misses.size(), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            misses[i].Binary = Compile(name, (ShaderType)misses[i].Type, *misses[i].Source, optimize);
+        }
+    });
+    {
+        std::lock_guard<mutex> lock(sCacheMutex);
+        sCacheStatistics.Misses += static_cast<uint32_t>(misses.size());
+        sCacheStatistics.CompileTime += GetMilliseconds(start);
+    }
+
+    for (auto &stage : misses) {
+        if (!stage.Binary.empty()) File::Write(stage.Cache, stage.Binary);
+        result[stage.Type] = std::move(stage.Binary);
+    }
+    LogDebug("[ShaderCompiler] '{}': {} of {} stages loaded from cache", name, stages.size() - misses.size(), stages.size());
+    return result;
+}
+
+CacheStatistics GetCacheStatistics() {
+    std::lock_guard<mutex> lock(sCacheMutex);
+    return sCacheStatistics;
+}
+
 string CompileToAssembly(const string &name, ShaderType type, const string &source, bool optimize) {
     shaderc::CompileOptions options;
     options.AddMacroDefinition("ENGINE", "Ultra");
     if (optimize) options.SetOptimizationLevel(shaderc_optimization_level_size);
 
-    shaderc::Compiler compiler;
+    auto &compiler = GetCompiler();
     auto result = compiler.CompileGlslToSpvAssembly(source, GetNativeShaderKind(type), name.c_str(), options);
 
     if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
@@ -54,7 +154,7 @@ string PreprocessShader(const string &name, ShaderType type, const string &sourc
     shaderc::CompileOptions options;
     options.AddMacroDefinition("ENGINE", "Ultra");
 
-    shaderc::Compiler compiler;
+    auto &compiler = GetCompiler();
     auto result = compiler.PreprocessGlsl(source, GetNativeShaderKind(type), name.c_str(), options);
 
     if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
@@ -56,8 +56,33 @@ struct OutputOptions {
     //unsigned metalPlatform;
 };
 
+///
+/// @brief Hit rate and time spent of the SPIR-V cache since the start (the times are in milliseconds).
+///
+struct CacheStatistics {
+    uint32_t Hits = 0;
+    uint32_t Misses = 0;
+    double CompileTime = 0.0;
+    double LoadTime = 0.0;
+
+    float GetHitRate() const { return Hits + Misses ? static_cast<float>(Hits) / static_cast<float>(Hits + Misses) : 0.0f; }
+};
+
+constexpr auto ShaderCacheDirectory = "./Data/Cache/Shaders/";
+
 vector<uint32_t> Compile(const string &name, ShaderType type, const string &source, bool optimize = false);
 
+///
+/// @brief Compiles all stages, the binaries are cached by content and the misses are compiled in parallel.
+/// The key covers the stage, the compiler options and the preprocessed source, so the include closure and the stage defines are part of it.
+///
+/// @example: How-To
+/// auto binaries = ShaderCompiler::CompileStages(mShaderName, shaders);
+/// auto &spirv = binaries[(size_t)ShaderType::Vertex];
+///
+unordered_map<size_t, vector<uint32_t>> CompileStages(const string &name, const unordered_map<size_t, string> &stages, bool optimize = false);
+CacheStatistics GetCacheStatistics();
+
 string CompileToAssembly(const string &name, ShaderType type, const string &source, bool optimize = false);
 
 string PreprocessShader(const string &name, ShaderType type, const string &source);
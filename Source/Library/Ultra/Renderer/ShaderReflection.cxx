@@ -0,0 +1,303 @@
+﻿module Ultra.Renderer.ShaderReflection;
+
+import Ultra.Logger;
+
+namespace Ultra {
+
+// Helpers
+namespace {
+
+// SPIR-V opcodes, decorations and storage classes, which are relevant for the reflection
+enum SpirvOp: uint32_t {
+    OpName              = 5,
+    OpMemberName        = 6,
+    OpTypeBool          = 20,
+    OpTypeInt           = 21,
+    OpTypeFloat         = 22,
+    OpTypeVector        = 23,
+    OpTypeMatrix        = 24,
+    OpTypeImage         = 25,
+    OpTypeSampler       = 26,
+    OpTypeSampledImage  = 27,
+    OpTypeArray         = 28,
+    OpTypeRuntimeArray  = 29,
+    OpTypeStruct        = 30,
+    OpTypePointer       = 32,
+    OpConstant          = 43,
+    OpVariable          = 59,
+    OpDecorate          = 71,
+    OpMemberDecorate    = 72,
+};
+
+enum SpirvDecoration: uint32_t {
+    DecorationBlock         = 2,
+    DecorationBufferBlock   = 3,
+    DecorationArrayStride   = 6,
+    DecorationMatrixStride  = 7,
+    DecorationLocation      = 30,
+    DecorationBinding       = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset        = 35,
+};
+
+enum SpirvStorageClass: uint32_t {
+    StorageUniformConstant  = 0,
+    StorageUniform          = 2,
+    StoragePushConstant     = 9,
+    StorageStorageBuffer    = 12,
+};
+
+constexpr uint32_t SpirvMagic = 0x07230203;
+constexpr size_t SpirvHeaderSize = 5;
+
+struct SpirvMember {
+    string Name;
+    uint32_t Offset = 0;
+    uint32_t MatrixStride = 0;
+};
+
+struct SpirvId {
+    uint32_t Op = 0;
+    vector<uint32_t> Operands;      // Operands of the defining instruction without the result id
+    string Name;
+    vector<SpirvMember> Members;
+    int32_t Binding = -1;
+    int32_t Location = -1;
+    uint32_t Set = 0;
+    uint32_t ArrayStride = 0;
+    bool Block = false;
+    bool BufferBlock = false;
+};
+
+string ReadString(const uint32_t *words, size_t count) {
+    // Literal strings are nul-terminated and packed in little-endian order into the words
+    string result;
+    for (size_t i = 0; i < count; i++) {
+        for (uint32_t shift = 0; shift < 32; shift += 8) {
+            auto character = static_cast<char>((words[i] >> shift) & 0xFF);
+            if (!character) return result;
+            result.push_back(character);
+        }
+    }
+    return result;
+}
+
+class SpirvModule {
+public:
+    SpirvModule(const vector<uint32_t> &spirv): mIds(spirv[3]) {}
+
+    SpirvId &operator[](uint32_t id) { return mIds[id]; }
+
+    uint32_t GetSize(uint32_t type, uint32_t matrixStride = 0) {
+        if (type >= mIds.size()) return 0;
+        const auto &id = mIds[type];
+        switch (id.Op) {
+            case OpTypeBool:    { return 4; }
+            case OpTypeInt:
+            case OpTypeFloat:   { return id.Operands[0] / 8; }
+            case OpTypeVector:  { return GetSize(id.Operands[0]) * id.Operands[1]; }
+            case OpTypeMatrix:  { return (matrixStride ? matrixStride : GetSize(id.Operands[0])) * id.Operands[1]; }
+            case OpTypeArray:   { return (id.ArrayStride ? id.ArrayStride : GetSize(id.Operands[0], matrixStride)) * GetLength(type); }
+            case OpTypeStruct: {
+                uint32_t size = 0;
+                for (size_t i = 0; i < id.Operands.size() && i < id.Members.size(); i++) {
+                    size = std::max(size, id.Members[i].Offset + GetSize(id.Operands[i], id.Members[i].MatrixStride));
+                }
+                return size;
+            }
+            default:            { return 0; }
+        }
+    }
+
+    uint32_t GetLength(uint32_t type) {
+        const auto &id = mIds[type];
+        if (id.Op == OpTypeRuntimeArray) return 0;
+        if (id.Op != OpTypeArray) return 1;
+        auto length = id.Operands[1];
+        return length < mIds.size() && mIds[length].Op == OpConstant ? mIds[length].Operands[1] : 1;
+    }
+
+    uint32_t GetElementType(uint32_t type) {
+        while (type < mIds.size() && (mIds[type].Op == OpTypeArray || mIds[type].Op == OpTypeRuntimeArray)) type = mIds[type].Operands[0];
+        return type;
+    }
+
+    size_t GetBound() const { return mIds.size(); }
+
+private:
+    vector<SpirvId> mIds;
+};
+
+}
+
+
+void ShaderReflection::Clear() {
+    mResources.clear();
+    mLookup.clear();
+}
+
+bool ShaderReflection::Reflect(const vector<uint32_t> &spirv, size_t stage) {
+    if (spirv.size() < SpirvHeaderSize || spirv[0] != SpirvMagic) {
+        LogError("[ShaderReflection] The binary isn't valid SPIR-V!");
+        return false;
+    }
+    SpirvModule ids(spirv);
+    vector<uint32_t> variables;
+
+    // Gather the names, decorations, types and variables in one pass
+    for (size_t position = SpirvHeaderSize; position < spirv.size();) {
+        auto op = spirv[position] & 0xFFFF;
+        auto count = spirv[position] >> 16;
+        if (!count || position + count > spirv.size()) {
+            LogError("[ShaderReflection] The SPIR-V binary is truncated!");
+            return false;
+        }
+        const auto *operands = &spirv[position + 1];
+        auto valid = [&](uint32_t id) { return id < ids.GetBound(); };
+        position += count;
+        count -= 1;
+
+        switch (op) {
+            case OpName: {
+                if (count >= 2 && valid(operands[0])) ids[operands[0]].Name = ReadString(operands + 1, count - 1);
+                break;
+            }
+            case OpMemberName: {
+                if (count < 3 || !valid(operands[0])) break;
+                auto &members = ids[operands[0]].Members;
+                if (members.size() <= operands[1]) members.resize(operands[1] + 1);
+                members[operands[1]].Name = ReadString(operands + 2, count - 2);
+                break;
+            }
+            case OpDecorate: {
+                if (count < 2 || !valid(operands[0])) break;
+                auto &id = ids[operands[0]];
+                auto literal = count > 2 ? operands[2] : 0;
+                switch (operands[1]) {
+                    case DecorationBlock:           { id.Block = true; break; }
+                    case DecorationBufferBlock:     { id.BufferBlock = true; break; }
+                    case DecorationArrayStride:     { id.ArrayStride = literal; break; }
+                    case DecorationLocation:        { id.Location = static_cast<int32_t>(literal); break; }
+                    case DecorationBinding:         { id.Binding = static_cast<int32_t>(literal); break; }
+                    case DecorationDescriptorSet:   { id.Set = literal; break; }
+                    default:                        { break; }
+                }
+                break;
+            }
+            case OpMemberDecorate: {
+                if (!valid(operands[0]) || count < 4) break;
+                auto &members = ids[operands[0]].Members;
+                if (members.size() <= operands[1]) members.resize(operands[1] + 1);
+                if (operands[2] == DecorationOffset) members[operands[1]].Offset = operands[3];
+                if (operands[2] == DecorationMatrixStride) members[operands[1]].MatrixStride = operands[3];
+                break;
+            }
+            case OpTypeBool:
+            case OpTypeInt:
+            case OpTypeFloat:
+            case OpTypeVector:
+            case OpTypeMatrix:
+            case OpTypeImage:
+            case OpTypeSampler:
+            case OpTypeSampledImage:
+            case OpTypeArray:
+            case OpTypeRuntimeArray:
+            case OpTypeStruct:
+            case OpTypePointer: {
+                if (count < 1 || !valid(operands[0])) break;
+                auto &id = ids[operands[0]];
+                id.Op = op;
+                id.Operands.assign(operands + 1, operands + count);
+                break;
+            }
+            case OpConstant:
+            case OpVariable: {
+                // The result id follows the result type
+                if (count < 2 || !valid(operands[1])) break;
+                auto &id = ids[operands[1]];
+                id.Op = op;
+                id.Operands.assign(operands, operands + count);
+                id.Operands.erase(id.Operands.begin() + 1);
+                if (op == OpVariable) variables.push_back(operands[1]);
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+
+    // Resolve the variables, which are visible to the application
+    for (auto variable : variables) {
+        auto &id = ids[variable];
+        auto storage = id.Operands[1];
+        if (storage != StorageUniformConstant && storage != StorageUniform && storage != StoragePushConstant && storage != StorageStorageBuffer) continue;
+
+        auto pointer = id.Operands[0];
+        if (!(pointer < ids.GetBound()) || ids[pointer].Op != OpTypePointer) continue;
+        auto type = ids[pointer].Operands[1];
+        auto element = ids.GetElementType(type);
+        if (!(element < ids.GetBound())) continue;
+        auto &base = ids[element];
+
+        ShaderResource resource;
+        resource.Name = id.Name;
+        resource.Set = id.Set;
+        resource.Binding = id.Binding;
+        resource.Location = id.Location;
+        resource.Count = ids.GetLength(type);
+        resource.Stages = 1u << stage;
+
+        string alias;
+        if (base.Op == OpTypeStruct) {
+            switch (storage) {
+                case StoragePushConstant:   { resource.Type = ShaderResourceType::PushConstant; break; }
+                case StorageStorageBuffer:  { resource.Type = ShaderResourceType::StorageBuffer; break; }
+                default:                    { resource.Type = base.BufferBlock ? ShaderResourceType::StorageBuffer : ShaderResourceType::UniformBuffer; break; }
+            }
+            // Blocks without instance name are known by their type name
+            alias = base.Name;
+            if (resource.Name.empty()) resource.Name = base.Name;
+            resource.Size = ids.GetSize(element);
+            for (size_t i = 0; i < base.Members.size() && i < base.Operands.size(); i++) {
+                const auto &member = base.Members[i];
+                resource.Members.push_back({ member.Name, member.Offset, ids.GetSize(base.Operands[i], member.MatrixStride) });
+            }
+        } else if (base.Op == OpTypeSampledImage || base.Op == OpTypeSampler) {
+            resource.Type = ShaderResourceType::Sampler;
+        } else if (base.Op == OpTypeImage) {
+            // The 'Sampled' operand is 2 for storage images
+            resource.Type = base.Operands.size() > 5 && base.Operands[5] == 2 ? ShaderResourceType::Image : ShaderResourceType::Sampler;
+        } else {
+            resource.Type = ShaderResourceType::Uniform;
+            resource.Size = ids.GetSize(type);
+        }
+        Add(std::move(resource), alias);
+    }
+    return true;
+}
+
+
+const ShaderResource *ShaderReflection::Find(string_view name) const {
+    auto result = mLookup.find(string(name));
+    return result != mLookup.end() ? &mResources[result->second] : nullptr;
+}
+
+
+void ShaderReflection::Add(ShaderResource &&resource, const string &alias) {
+    // Stages share their resources, so only the stage mask of a known resource is extended
+    auto known = std::ranges::find_if(mResources, [&](const ShaderResource &current) {
+        return current.Name == resource.Name && current.Type == resource.Type && current.Binding == resource.Binding && current.Location == resource.Location;
+    });
+    if (known != mResources.end()) {
+        known->Stages |= resource.Stages;
+        return;
+    }
+
+    auto index = mResources.size();
+    if (!resource.Name.empty()) mLookup.emplace(resource.Name, index);
+    if (!alias.empty()) mLookup.emplace(alias, index);
+    mResources.push_back(std::move(resource));
+}
+
+}
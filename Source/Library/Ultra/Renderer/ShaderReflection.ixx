@@ -0,0 +1,76 @@
+﻿export module Ultra.Renderer.ShaderReflection;
+
+import Ultra.Core;
+
+export namespace Ultra {
+
+///
+/// @brief Shader Resource Types
+///
+enum class ShaderResourceType {
+    Uniform,        // Loose uniform with an explicit location (OpenGL only)
+    UniformBuffer,  // Uniform block
+    StorageBuffer,  // Shader storage block
+    PushConstant,   // Push constant block (Vulkan only)
+    Sampler,        // Sampled image or separate sampler
+    Image,          // Storage image
+};
+
+struct ShaderBlockMember {
+    string Name;
+    uint32_t Offset = 0;
+    uint32_t Size = 0;
+};
+
+struct ShaderResource {
+    string Name;
+    ShaderResourceType Type = ShaderResourceType::Uniform;
+    uint32_t Set = 0;
+    int32_t Binding = -1;
+    int32_t Location = -1;
+    uint32_t Count = 1;     // Elements of an array (e.g. sampler2D uTextures[32]), zero for runtime arrays
+    uint32_t Size = 0;      // Bytes of a block or a loose uniform
+    uint32_t Stages = 0;    // Bit mask of the shader types, which use the resource
+    vector<ShaderBlockMember> Members;
+
+    // Accessors
+    const ShaderBlockMember *FindMember(string_view name) const {
+        auto member = std::ranges::find(Members, name, &ShaderBlockMember::Name);
+        return member != Members.end() ? &*member : nullptr;
+    }
+};
+
+///
+/// @brief Resources of compiled shader stages, read directly from the SPIR-V binaries (names, bindings, locations and block layouts).
+///
+/// @example: How-To
+/// ShaderReflection reflection;
+/// reflection.Reflect(vertexBinary, (size_t)ShaderType::Vertex);
+/// reflection.Reflect(fragmentBinary, (size_t)ShaderType::Fragment);
+/// if (auto *camera = reflection.Find("Camera")) AppAssert(camera->Size == sizeof(CameraData), "Layout mismatch!");
+///
+/// @note Blocks are found by their type name and by their instance name, if they have one.
+///
+class ShaderReflection {
+public:
+    ShaderReflection() = default;
+    ~ShaderReflection() = default;
+
+    // Methods
+    void Clear();
+    bool Reflect(const vector<uint32_t> &spirv, size_t stage);
+
+    // Accessors
+    const ShaderResource *Find(string_view name) const;
+    const vector<ShaderResource> &GetResources() const { return mResources; }
+
+private:
+    void Add(ShaderResource &&resource, const string &alias);
+
+private:
+    // Properties
+    vector<ShaderResource> mResources;
+    unordered_map<string, size_t> mLookup;
+};
+
+}
@@ -0,0 +1,86 @@
+﻿module Ultra.Renderer.StreamBuffer;
+
+namespace Ultra {
+
+StreamBuffer::StreamBuffer(BufferType type, size_t size): mBuffer(Buffer::Create(type, nullptr, size, BufferUsage::Stream)), mSize(size) {
+    mData = static_cast<byte *>(mBuffer->Map(0, size));
+    if (!mData) {
+        LogWarning("[StreamBuffer] The buffer can't be mapped, the allocations are written into host memory!");
+        mFallback.resize(size);
+        mData = mFallback.data();
+    }
+}
+
+
+StreamAllocation StreamBuffer::Allocate(size_t size, size_t alignment) {
+    if (!size) return {};
+    if (size > mSize) {
+        LogError("[StreamBuffer] The allocation of {} bytes exceeds the capacity of {} bytes!", size, mSize);
+        return {};
+    }
+
+    alignment = std::max(alignment, size_t(1));
+    size_t offset {};
+    size_t required {};
+    auto place = [&]() {
+        offset = (mHead + alignment - 1) / alignment * alignment;
+        required = offset + size - mHead;
+        if (offset + size > mSize) {
+            // The end of the ring is skipped, so that the allocation stays contiguous
+            offset = 0;
+            required = mSize - mHead + size;
+        }
+    };
+    place();
+
+    // The oldest frames are released first, if the current frame alone fills the ring, it has to wait for itself
+    for (uint32_t i = 1; mUsed + required > mSize && i <= Buffer::FramesInFlight; i++) {
+        auto frame = (mFrame + i) % Buffer::FramesInFlight;
+        if (frame == mFrame && mFrameUsage[frame]) mBuffer->Fence(frame);
+        Release(frame);
+        if (!mUsed) mHead = 0;
+        place();
+    }
+
+    mHead = offset + size;
+    mUsed += required;
+    mFrameUsage[mFrame] += required;
+    return { mData + offset, offset, size };
+}
+
+StreamAllocation StreamBuffer::Write(const void *data, size_t size, size_t alignment) {
+    auto allocation = Allocate(size, alignment);
+    if (allocation) std::memcpy(allocation.Data, data, size);
+    return allocation;
+}
+
+void StreamBuffer::Bind() const {
+    mBuffer->Bind();
+}
+
+void StreamBuffer::Bind(uint32_t binding, const StreamAllocation &allocation) const {
+    mBuffer->BindRange(binding, allocation.Offset, allocation.Size);
+}
+
+void StreamBuffer::NextFrame() {
+    if (!mFrameUsage[mFrame]) return;
+    mBuffer->Fence(mFrame);
+
+    // The frame, which used the next slot before, has to be finished before its fence is reused, but this never blocks
+    auto next = (mFrame + 1) % Buffer::FramesInFlight;
+    if (mFrameUsage[next]) {
+        if (!mBuffer->IsFinished(next)) return;
+        Release(next);
+    }
+    mFrame = next;
+}
+
+
+void StreamBuffer::Release(uint32_t frame) {
+    if (!mFrameUsage[frame]) return;
+    mBuffer->Wait(frame);
+    mUsed -= mFrameUsage[frame];
+    mFrameUsage[frame] = 0;
+}
+
+}
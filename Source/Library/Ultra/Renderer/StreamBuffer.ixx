@@ -0,0 +1,76 @@
+﻿export module Ultra.Renderer.StreamBuffer;
+
+export import Ultra.Renderer.Buffer;
+
+export namespace Ultra {
+
+///
+/// @brief Range of a stream buffer, which can be written until the frame ends.
+///
+struct StreamAllocation {
+    void *Data = nullptr;
+    size_t Offset = 0;
+    size_t Size = 0;
+
+    explicit operator bool() const { return Data; }
+};
+
+///
+/// @brief Ring allocator for transient vertex, index and uniform data on top of a persistently mapped buffer.
+/// The allocations of every frame are guarded by a fence, only an allocation waits and only if it would overwrite a frame, which is still in flight.
+///
+/// @example: How-To
+/// StreamBuffer stream(BufferType::Vertex, 8 * 1024 * 1024);
+///
+/// auto allocation = stream.Allocate(sizeof_vector(vertices), sizeof(Vertex));
+/// std::memcpy(allocation.Data, vertices.data(), allocation.Size);
+/// stream.Bind();
+/// commandBuffer->DrawIndexed(count, PrimitiveType::Triangle, true, static_cast<int32_t>(allocation.Offset / sizeof(Vertex)));
+/// ...
+/// stream.NextFrame();
+///
+/// @note Backends without mapping support write into host memory, which is never read, so nothing is drawn from it.
+///
+class StreamBuffer {
+public:
+    StreamBuffer(BufferType type, size_t size);
+    ~StreamBuffer() = default;
+
+    // Methods
+    ///
+    /// @brief Reserves a range, the offset is a multiple of the alignment (doesn't need to be a power of two, so the vertex stride works as well).
+    ///
+    StreamAllocation Allocate(size_t size, size_t alignment = 16);
+    StreamAllocation Write(const void *data, size_t size, size_t alignment = 16);
+    void Bind() const;
+    void Bind(uint32_t binding, const StreamAllocation &allocation) const;
+
+    ///
+    /// @brief Fences the allocations of the current frame, after the commands which read them were submitted (once per frame).
+    /// If the GPU still reads the frame, which used the next slot, the current slot is continued, its renewed fence covers both frames.
+    ///
+    void NextFrame();
+
+    // Accessors
+    Buffer *GetBuffer() const { return mBuffer.get(); }
+    size_t GetCapacity() const { return mSize; }
+    size_t GetUsage() const { return mUsed; }
+
+private:
+    void Release(uint32_t frame);
+
+private:
+    // Properties
+    Scope<Buffer> mBuffer;
+    byte *mData = nullptr;
+    vector<byte> mFallback;
+    size_t mSize;
+
+    // States
+    size_t mHead = 0;
+    size_t mUsed = 0;   // Bytes of all frames in flight, including the padding and the skipped end of the ring
+    uint32_t mFrame = 0;
+    array<size_t, Buffer::FramesInFlight> mFrameUsage {};
+};
+
+}
@@ -3,6 +3,7 @@
 import Ultra.Graphics.Context;
 import Ultra.Platform.Renderer.DXSwapchain;
 import Ultra.Platform.Renderer.GLSwapchain;
+import Ultra.Platform.Renderer.SWSwapchain;
 import Ultra.Platform.Renderer.VKSwapchain;
 
 namespace Ultra {
@@ -11,6 +12,7 @@ Scope<Swapchain> Swapchain::Create(void *windowHandle, uint32_t width, uint32_t
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateScope<DXSwapchain>(windowHandle, width, height); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLSwapchain>(windowHandle, width, height); }
+        case GraphicsAPI::Software: { return CreateScope<SWSwapchain>(windowHandle, width, height); }
         case GraphicsAPI::Vulkan:   { return CreateScope<VKSwapchain>(windowHandle, width, height); }
 
         default: {
@@ -3,6 +3,7 @@
 import Ultra.Graphics.Context;
 import Ultra.Platform.Renderer.DXTexture;
 import Ultra.Platform.Renderer.GLTexture;
+import Ultra.Platform.Renderer.SWTexture;
 import Ultra.Platform.Renderer.VKTexture;
 
 namespace Ultra {
@@ -11,6 +12,7 @@ Scope<Texture> Texture::Create(const TextureProperties &properties, const void *
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateScope<DXTexture>(properties, data, size); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLTexture>(properties, data, size); }
+        case GraphicsAPI::Software: { return CreateScope<SWTexture>(properties, data, size); }
         case GraphicsAPI::Vulkan:   { return CreateScope<VKTexture>(properties, data, size); }
 
         default: {
@@ -28,6 +30,7 @@ Reference<Texture> Texture::Create(const TextureProperties &properties, const st
     switch (Context::API) {
         case GraphicsAPI::DirectX:  { return CreateReference<DXTexture>(properties, path); }
         case GraphicsAPI::OpenGL:   { return CreateReference<GLTexture>(properties, path); }
+        case GraphicsAPI::Software: { return CreateReference<SWTexture>(properties, path); }
         case GraphicsAPI::Vulkan:   { return CreateReference<VKTexture>(properties, path); }
 
         default: {
@@ -0,0 +1,139 @@
+﻿module Ultra.Renderer.TextureAtlas;
+
+#pragma warning(push, 0)
+// The implementation is compiled with the OpenGL texture
+#define STB_IMAGE_STATIC
+import <stb/stb_image.h>;
+#pragma warning(pop)
+
+import Ultra.System.FileSystem;
+
+namespace Ultra {
+
+TextureAtlas::TextureAtlas(uint32_t pageSize, uint32_t padding): mPageSize(pageSize), mPadding(padding) {}
+
+
+bool TextureAtlas::Add(const string &path) {
+    if (!File::Exists(path)) {
+        LogError("The specified directory/file '{}' doesn't exist!", path);
+        return false;
+    }
+
+    int width {};
+    int height {};
+    int channels {};
+    auto *data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (!data) {
+        LogError("An error occurred while loading image '{}'!", path);
+        return false;
+    }
+
+    auto result = Add(path, static_cast<uint32_t>(width), static_cast<uint32_t>(height), data);
+    stbi_image_free(data);
+    return result;
+}
+
+bool TextureAtlas::Add(const string &name, uint32_t width, uint32_t height, const void *pixels) {
+    if (!width || !height || !pixels) return false;
+    if (width + mPadding * 2 > mPageSize || height + mPadding * 2 > mPageSize) {
+        LogError("The sprite '{}' ({}x{}) doesn't fit into an atlas page of {}x{}!", name, width, height, mPageSize, mPageSize);
+        return false;
+    }
+
+    Sprite sprite { name, width, height };
+    sprite.Pixels.resize(static_cast<size_t>(width) * height);
+    std::memcpy(sprite.Pixels.data(), pixels, sprite.Pixels.size() * sizeof(uint32_t));
+    mSprites.push_back(std::move(sprite));
+    return true;
+}
+
+void TextureAtlas::Build() {
+    struct Placement {
+        const Sprite *Source;
+        uint32_t X;
+        uint32_t Y;
+        uint32_t Page;
+    };
+
+    // Shelf packing works best with sprites sorted by height, the order is stable, so the result is reproducible
+    vector<Placement> placements;
+    placements.reserve(mSprites.size());
+    for (const auto &sprite : mSprites) placements.push_back({ &sprite });
+    std::stable_sort(placements.begin(), placements.end(), [](const Placement &a, const Placement &b) {
+        return a.Source->Height != b.Source->Height ? a.Source->Height > b.Source->Height : a.Source->Width > b.Source->Width;
+    });
+
+    uint32_t cursorX {};
+    uint32_t cursorY {};
+    uint32_t shelfHeight {};
+    uint32_t pageCount = placements.empty() ? 0 : 1;
+    for (auto &placement : placements) {
+        auto width = placement.Source->Width + mPadding * 2;
+        auto height = placement.Source->Height + mPadding * 2;
+        if (cursorX + width > mPageSize) {
+            cursorX = 0;
+            cursorY += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (cursorY + height > mPageSize) {
+            cursorX = 0;
+            cursorY = 0;
+            shelfHeight = 0;
+            pageCount++;
+        }
+        placement.X = cursorX;
+        placement.Y = cursorY;
+        placement.Page = pageCount - 1;
+        cursorX += width;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+
+    mPages.clear();
+    mRegions.clear();
+    TextureProperties properties;
+    properties.Width = mPageSize;
+    properties.Height = mPageSize;
+    properties.Format = TextureFormat::RGBA8;
+    properties.SamplerWrap = TextureWrap::MirrorClamp;
+
+    vector<uint32_t> page(static_cast<size_t>(mPageSize) * mPageSize);
+    auto size = static_cast<float>(mPageSize);
+    auto padding = static_cast<int64_t>(mPadding);
+    auto current = placements.begin();
+    for (uint32_t index = 0; index < pageCount; index++) {
+        // Copy the sprites, the padding repeats the border texels, so filtering doesn't bleed into the neighbours
+        std::fill(page.begin(), page.end(), 0u);
+        auto first = current;
+        for (; current != placements.end() && current->Page == index; current++) {
+            const auto &sprite = *current->Source;
+            auto width = static_cast<int64_t>(sprite.Width);
+            auto height = static_cast<int64_t>(sprite.Height);
+            for (int64_t y = -padding; y < height + padding; y++) {
+                auto sourceY = std::clamp<int64_t>(y, 0, height - 1);
+                auto *target = page.data() + (current->Y + padding + y) * mPageSize + current->X + padding;
+                for (int64_t x = -padding; x < width + padding; x++) {
+                    target[x] = sprite.Pixels[sourceY * width + std::clamp<int64_t>(x, 0, width - 1)];
+                }
+            }
+        }
+
+        auto &texture = mPages.emplace_back(Texture::Create(properties, page.data(), page.size() * sizeof(uint32_t)));
+        for (auto it = first; it != current; it++) {
+            auto left = static_cast<float>(it->X + mPadding);
+            auto top = static_cast<float>(it->Y + mPadding);
+            mRegions[it->Source->Name] = { texture, { left / size, top / size, (left + it->Source->Width) / size, (top + it->Source->Height) / size } };
+        }
+    }
+
+    LogTrace("[TextureAtlas] Packed {} sprites into {} pages of {}x{}.", mSprites.size(), mPages.size(), mPageSize, mPageSize);
+}
+
+
+const TextureRegion &TextureAtlas::GetRegion(const string &name) const {
+    static const TextureRegion empty {};
+    if (auto it = mRegions.find(name); it != mRegions.end()) return it->second;
+    LogWarning("[TextureAtlas] The sprite '{}' isn't part of the atlas!", name);
+    return empty;
+}
+
+}
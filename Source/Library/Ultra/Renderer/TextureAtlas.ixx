@@ -0,0 +1,63 @@
+﻿export module Ultra.Renderer.TextureAtlas;
+
+export import Ultra.Core;
+export import Ultra.Logger;
+import Ultra.Math;
+export import Ultra.Renderer.Texture;
+
+export namespace Ultra {
+
+///
+/// @brief Part of a texture, the rectangle holds the normalized coordinates (u0, v0, u1, v1).
+///
+struct TextureRegion {
+    Reference<Texture> Texture;
+    glm::vec4 Rect { 0.0f, 0.0f, 1.0f, 1.0f };
+};
+
+///
+/// @brief Runtime atlas, which packs RGBA8 sprites into as few pages (textures) as possible.
+/// Sprites on the same page share a texture slot in the renderer, so they don't break batches.
+///
+/// @example: How-To
+/// TextureAtlas atlas;
+/// atlas.Add("Assets/Textures/Player.png");
+/// atlas.Add("Assets/Textures/Enemy.png");
+/// atlas.Build();
+/// Renderer2D::DrawQuad(position, size, atlas.GetRegion("Assets/Textures/Player.png"));
+///
+/// @note Regions don't repeat, so a tiling factor above one samples the neighbours.
+///
+class TextureAtlas {
+public:
+    TextureAtlas(uint32_t pageSize = 2048, uint32_t padding = 1);
+    ~TextureAtlas() = default;
+
+    // Methods
+    bool Add(const string &path);
+    bool Add(const string &name, uint32_t width, uint32_t height, const void *pixels);
+    void Build();
+
+    // Accessors
+    const TextureRegion &GetRegion(const string &name) const;
+    size_t GetPageCount() const { return mPages.size(); }
+    const Reference<Texture> &GetPage(size_t index) const { return mPages[index]; }
+    bool Contains(const string &name) const { return mRegions.contains(name); }
+
+private:
+    struct Sprite {
+        string Name;
+        uint32_t Width {};
+        uint32_t Height {};
+        vector<uint32_t> Pixels;
+    };
+
+    // Properties
+    uint32_t mPageSize;
+    uint32_t mPadding;
+    vector<Sprite> mSprites;
+    vector<Reference<Texture>> mPages;
+    unordered_map<string, TextureRegion> mRegions;
+};
+
+}
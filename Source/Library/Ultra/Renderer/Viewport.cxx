@@ -9,6 +9,7 @@ Scope<Viewport> Viewport::Create(const ViewportProperties &properties) {
     switch (Context::API) {
         //case GraphicsAPI::DirectX:  { return CreateScope<DXViewport>(properties); }
         case GraphicsAPI::OpenGL:   { return CreateScope<GLViewport>(properties); }
+        case GraphicsAPI::Software: { return CreateScope<Viewport>(properties); }
         //case GraphicsAPI::Vulkan:   { return CreateScope<VKViewport>(properties); }
 
         default: {
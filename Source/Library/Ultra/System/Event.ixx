@@ -1,6 +1,7 @@
 ﻿export module Ultra.System.Event;
 
 import Ultra.Core;
+import Ultra.Core.Allocator;
 import Ultra.Core.Emitter;
 
 export import Ultra.Core.Event.Data;
@@ -17,6 +18,10 @@ public:
     // Methods
     virtual bool Callback(void *event) = 0;
     virtual void Update() = 0;
+    // Blocks until the platform delivers new events and dispatches them, so that a paused application doesn't spin.
+    virtual void Wait() = 0;
+    // Releases a pending wait from any thread.
+    virtual void Wake() = 0;
 
     // Event Emitter
     struct EventEmitter: public Emitter<EventEmitter> {} Emitter;
@@ -30,6 +35,12 @@ struct Event {
     Event(std::shared_ptr<EventData> &&data): Data(std::move(data)) {};
     virtual ~Event() = default;
 
+    // Creates the event with its data from a pool, so that frequent events don't touch the general heap
+    template<typename T, typename ...Args>
+    static Event Create(Args &&...args) {
+        return Event(std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(&GetPool()), std::forward<Args>(args)...));
+    }
+
     // Conversions
     template<typename T>
     T *As() {
@@ -39,6 +50,13 @@ struct Event {
     // Properties
     std::shared_ptr<EventData> Data = nullptr;
     bool Handled = false;
+
+private:
+    // The pool is never destroyed, so that events which are kept beyond the static destruction don't point into freed memory
+    static PoolResource &GetPool() {
+        static auto *pool = new PoolResource(256);
+        return *pool;
+    }
 };
 
 }
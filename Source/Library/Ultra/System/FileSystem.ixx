@@ -1,6 +1,7 @@
 ﻿export module Ultra.System.FileSystem;
 
 import Ultra.Core;
+import Ultra.Core.Allocator;
 import Ultra.Core.String;
 import Ultra.Logger;
 
@@ -23,7 +24,8 @@ public:
         if (!Exists(directory.string())) { LogError("The specified directory '{}' doesn't exist!", root.data()); return {}; };
 
         vector<string> result {};
-        auto tokens = String::Split(token.data(), '|');
+        ScratchScope scratch;
+        auto tokens = String::Split(token, '|', scratch.GetResource());
 
         for (auto &current : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
             if (current.is_regular_file()) {
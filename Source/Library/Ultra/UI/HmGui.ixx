@@ -3,6 +3,7 @@
 export import Ultra.Renderer.Font;
 
 import Ultra.Core;
+import Ultra.Core.Allocator;
 import Ultra.Core.Timer;
 import Ultra.Core.String;
 import Ultra.Renderer.Texture;
@@ -222,6 +223,14 @@ public:
     }
     virtual ~Component() = default;
 
+    // Allocation: All components come from one pool, the destructor is virtual, so the size is always the one of the derived class
+    static void *operator new(size_t size) {
+        return GetPool().allocate(size, alignof(std::max_align_t));
+    }
+    static void operator delete(void *memory, size_t size) {
+        GetPool().deallocate(memory, size, alignof(std::max_align_t));
+    }
+
     // Comparison
     bool operator==(const Component &other) const {
         return Hash == other.Hash;
@@ -289,6 +298,13 @@ public:
     Padding Padding {};
     Ultra::Size OriginalSize {};
 
+private:
+    // The pool is created with the root container, so it outlives all components
+    static PoolResource &GetPool() {
+        static PoolResource pool(512);
+        return pool;
+    }
+
 private:
     std::hash<std::string> mHasher;
 };
@@ -1459,7 +1475,8 @@ public:
                 editors->Stretch = { 1.0f, 1.0f };
                 for (auto i = 0; i < 2; i++) {
                     auto scrollView = editors->CreateScrollView(200);
-                    auto lines = String::Split(gCodeExample, '\n');
+                    ScratchScope scratch;
+                    auto lines = String::Split(gCodeExample, '\n', scratch.GetResource());
                     for (auto &line : lines) {
                         auto text = scrollView->CreateLabel(line, Instance().mFontFiraMono.get());
                         text->Color = { 0.1f, 0.5f, 1.0f, 1.0f };
@@ -8,6 +8,7 @@
 module Ultra.UI.GUILayer;
 
 import Ultra.Core.Application;
+import Ultra.Debug.Profiler;
 import Ultra.Logger;
 import Ultra.UI.GUIBuilder;
 
@@ -20,6 +21,7 @@ namespace Ultra {
 
 const float FontSize = 16.0f;
 static bool ShowDemoWindow = false;
+static bool ShowProfiler = false;
 
 static int ImGui_ImplWin32_CreateVkSurface(ImGuiViewport *viewport, ImU64 instance, const void *allocator, ImU64 *surface) {
     auto context = Application::GetContext().As<VKContext>();
@@ -141,6 +143,10 @@ void GuiLayer::Detach() {
 
 void GuiLayer::GuiUpdate() {
 	if (ShowDemoWindow) ImGui::ShowDemoWindow(&ShowDemoWindow);
+    if (ShowProfiler) {
+        UI::ProfilerTimeline(&ShowProfiler);
+        if (!ShowProfiler) Debug::DisableProfilerHistory();
+    }
 }
 
 void GuiLayer::Update(Timestamp deltaTime) {
@@ -240,6 +246,10 @@ void GuiLayer::OnKeyboardEvent(KeyboardEventData &data, const EventListener::Eve
 				case KeyState::Press: {
                     logger << data.Key << '\n';
                     if (data.Key == KeyCode::F1) ShowDemoWindow = !ShowDemoWindow;
+                    if (data.Key == KeyCode::F2) {
+                        ShowProfiler = !ShowProfiler;
+                        ShowProfiler ? Debug::EnableProfilerHistory() : Debug::DisableProfilerHistory();
+                    }
                     if (data.Key == KeyCode::Shift) {
                         io.AddKeyEvent(ImGuiKey_LeftShift, true);
                     }
@@ -316,6 +326,104 @@ void GuiLayer::OnTouchEvent(TouchEventData &data, const EventListener::EventEmit
 
 void GuiLayer::OnWindowEvent(WindowEventData &data, const EventListener::EventEmitter &emitter) {}
 
+
+namespace UI {
+
+void ProfilerTimeline(bool *open) {
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+    const auto &history = Debug::GetProfilerHistory();
+    if (history.empty()) {
+        ImGui::Text(Debug::IsProfilerHistoryEnabled() ? "Waiting for frames ..." : "Profiler history is disabled.");
+        ImGui::End();
+        return;
+    }
+
+    // Frame Times: a click on a bar pauses the timeline on that frame
+    static bool follow = true;
+    static uint64_t selection {};
+    vector<float> durations;
+    durations.reserve(history.size());
+    float maximum {};
+    for (const auto &frame : history) {
+        durations.push_back(static_cast<float>(frame.Duration));
+        maximum = std::max(maximum, durations.back());
+    }
+    ImGui::Checkbox("Follow", &follow);
+    ImGui::SameLine();
+    ImGui::Text("Frames: %zu | Max: %.3f ms", history.size(), maximum);
+    ImGui::PlotHistogram("##Frames", durations.data(), static_cast<int>(durations.size()), 0, nullptr, 0.0f, maximum * 1.1f, ImVec2(-1.0f, 64.0f));
+    if (ImGui::IsItemClicked()) {
+        auto position = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+        auto index = std::clamp(static_cast<size_t>(position * history.size()), size_t {}, history.size() - 1);
+        selection = history[index].Index;
+        follow = false;
+    }
+    const auto *frame = &history.back();
+    if (!follow) {
+        for (const auto &candidate : history) if (candidate.Index == selection) frame = &candidate;
+    }
+
+    // Timeline: one row per thread and nesting level
+    const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    map<uint32_t, uint32_t> depths;
+    for (const auto &event : frame->Events) depths[event.Thread] = std::max(depths[event.Thread], event.Depth + 1);
+    map<uint32_t, float> rows;
+    float height {};
+    for (const auto &[thread, depth] : depths) {
+        rows[thread] = height;
+        height += depth * rowHeight + 4.0f;
+    }
+
+    ImGui::Text("Frame %llu: %.3f ms", static_cast<unsigned long long>(frame->Index), frame->Duration);
+    auto origin = ImGui::GetCursorScreenPos();
+    auto width = ImGui::GetContentRegionAvail().x;
+    auto scale = frame->Duration > 0.0 ? width / static_cast<float>(frame->Duration) : 0.0f;
+    auto *drawList = ImGui::GetWindowDrawList();
+    for (const auto &event : frame->Events) {
+        ImVec2 min { origin.x + static_cast<float>(event.Start) * scale, origin.y + rows[event.Thread] + event.Depth * rowHeight };
+        ImVec2 max { std::max(min.x + 1.0f, min.x + static_cast<float>(event.Duration) * scale), min.y + rowHeight - 1.0f };
+        auto hash = static_cast<uint32_t>(std::hash<string_view>{}(event.Name));
+        auto color = IM_COL32(64 + (hash & 0x7f), 64 + ((hash >> 8) & 0x7f), 64 + ((hash >> 16) & 0x7f), 255);
+        drawList->AddRectFilled(min, max, color);
+        if (max.x - min.x > 32.0f) {
+            drawList->PushClipRect(min, max, true);
+            drawList->AddText({ min.x + 2.0f, min.y + 2.0f }, IM_COL32_WHITE, event.Name);
+            drawList->PopClipRect();
+        }
+        if (ImGui::IsMouseHoveringRect(min, max)) {
+            ImGui::SetTooltip("%s\nThread: %u\nStart: %.3f ms\nDuration: %.3f ms", event.Name, event.Thread, event.Start, event.Duration);
+        }
+    }
+    ImGui::Dummy({ width, std::max(height, rowHeight) });
+
+    // Statistics
+    if (ImGui::BeginTable("Scopes", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Min [ms]");
+        ImGui::TableSetupColumn("Avg [ms]");
+        ImGui::TableSetupColumn("Max [ms]");
+        ImGui::TableSetupColumn("P99 [ms]");
+        ImGui::TableHeadersRow();
+        for (const auto &scope : Debug::GetProfilerStatistics()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(scope.Name.data(), scope.Name.data() + scope.Name.size());
+            ImGui::TableNextColumn(); ImGui::Text("%zu", scope.Calls);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", scope.Min);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", scope.Average);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", scope.Max);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", scope.P99);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+
+}
+
 }
 
 #pragma warning(pop)
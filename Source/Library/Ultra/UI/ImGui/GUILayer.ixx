@@ -53,6 +53,14 @@ auto LabelX(const string &format, const Args &...arguments) {
 }
 
 
+/**
+* @brief Profiler
+*/
+
+/// Frame times, timeline of the selected frame and per-scope statistics from the profiler history
+void ProfilerTimeline(bool *open = nullptr);
+
+
 /**
 * @brief Properties
 */
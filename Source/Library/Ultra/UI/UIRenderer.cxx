@@ -3,6 +3,9 @@
 import <glad/gl.h>;
 
 import Ultra.Math;
+import Ultra.Graphics.Context;
+import Ultra.Platform.Renderer.GLState;
+import Ultra.Platform.Renderer.SWRasterizer;
 
 namespace Ultra {
 
@@ -19,10 +22,19 @@ void ClipRect::Activate() {
         auto height = current.Size.Height;
         TransformRectangle(x, y, width, height);
 
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(static_cast<GLint>(x), static_cast<GLint>(properties.Height - (y + height)), static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+        if (Context::API == GraphicsAPI::Software) {
+            auto clamp = [](float value) { return static_cast<uint32_t>(std::max(value, 0.0f)); };
+            SWRasterizer::Instance().SetScissor(true, clamp(x), clamp(properties.Height - (y + height)), clamp(width), clamp(height));
+            return;
+        }
+        GLState::Instance().SetCapability(GL_SCISSOR_TEST, true);
+        GLState::Instance().SetScissor(static_cast<GLint>(x), static_cast<GLint>(properties.Height - (y + height)), static_cast<GLsizei>(width), static_cast<GLsizei>(height));
     } else {
-        glDisable(GL_SCISSOR_TEST);
+        if (Context::API == GraphicsAPI::Software) {
+            SWRasterizer::Instance().SetScissor(false);
+            return;
+        }
+        GLState::Instance().SetCapability(GL_SCISSOR_TEST, false);
     }
 }
 
@@ -11,6 +11,7 @@ export import Ultra.Core;
 // Prime Extensions
 export import Ultra.Config;
 export import Ultra.Logger;
+export import Ultra.Logger.Binary;
 
 // Core Extensions
 #ifdef LIB_EXTENSION_CORE
@@ -18,13 +19,16 @@ export import Ultra.Logger;
     export import Ultra.Core.Layer;
 
     // Utilities
+    export import Ultra.Core.Allocator;
     export import Ultra.Core.DateTime;
     export import Ultra.Core.Delegate;
     export import Ultra.Core.Dispatcher;
     export import Ultra.Core.Emitter;
     export import Ultra.Core.Future;
+    export import Ultra.Core.JobSystem;
     export import Ultra.Core.Random;
     export import Ultra.Core.Signal;
+    export import Ultra.Core.TaskGraph;
     //export import Ultra.Core.String;
     export import Ultra.Core.ThreadPool;
     export import Ultra.Core.Timer;
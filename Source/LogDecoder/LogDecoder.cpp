@@ -0,0 +1,46 @@
+﻿import Ultra.Core;
+import Ultra.Logger.Binary;
+import Ultra.Debug.Profiler;
+
+///
+/// @brief Expands binary logs, written by the BinaryLogger, into text.
+/// Profiler captures are converted into the chrome tracing format.
+/// Usage: LogDecoder <input.ulog> [output.log]
+///        LogDecoder <input.uprf> <output.json>
+///
+int main(int argc, char **argv) {
+    using namespace Ultra;
+
+    if (argc < 2) {
+        std::println("Usage: LogDecoder <input.ulog|input.uprf> [output]");
+        return 1;
+    }
+
+    std::filesystem::path input = argv[1];
+    if (input.extension() == ".uprf") {
+        if (argc < 3) {
+            std::println("Usage: LogDecoder <input.uprf> <output.json>");
+            return 1;
+        }
+        return Debug::ConvertProfile(input, argv[2]) ? 0 : 1;
+    }
+
+    int64_t messages {};
+    if (argc > 2) {
+        ofstream output(argv[2]);
+        if (!output.is_open()) {
+            std::println("LogDecoder: Couldn't open output file '{}'!", argv[2]);
+            return 1;
+        }
+        messages = BinaryLogReader::Decode(input, output);
+    } else {
+        messages = BinaryLogReader::Decode(input, std::cout);
+    }
+
+    if (messages < 0) {
+        std::println(std::cerr, "LogDecoder: Failed to decode '{}'!", input.string());
+        return 1;
+    }
+    if (argc > 2) std::println("LogDecoder: Decoded {} messages from '{}'.", messages, input.string());
+    return 0;
+}
@@ -0,0 +1,51 @@
+﻿project "LogDecoder"
+    defines { "PROJECT_NAME=LogDecoder" }
+    kind "ConsoleApp"
+    language "C++"
+    characterset "Unicode"
+    conformancemode "true"
+    cdialect "C17"
+    cppdialect "C++latest"
+    cppmodules "true"
+    buildstlmodules "true"
+    externalanglebrackets "on"
+    externalwarnings "Off"
+    nativewchar "on"
+    scanformoduledependencies "on"
+    staticruntime "on"
+    toolset "msc"
+    warnings "Extra"
+    
+    debugdir "%{wks.location}/Build/%{cfg.buildcfg}"
+    dependson { "Ultra" }
+    entrypoint "mainCRTStartup"
+    files { "**.h", "**.cpp", "**.cppm", "**.cxx", "**.inl", "**.ixx", "**.lua" }
+    
+    externalincludedirs {
+	    "%{Headers.ThirdParty}"
+    }
+    includedirs {
+        "%{Headers.Library}"
+    }
+    links {
+        "Ultra"
+    }
+
+    filter { "configurations:Debug" }
+        defines { "_DEBUG" }
+        runtime "Debug"
+        symbols "on"
+    
+    filter { "configurations:Distribution" }
+        defines { "NDEBUG" }
+        optimize "on"
+        runtime "Release"
+        symbols "on"
+
+    filter { "configurations:Release" }
+        defines { "NDEBUG" }
+        optimize "on"
+        runtime "Release"
+        symbols "off"
+    
+    filter { }
@@ -159,8 +159,10 @@ filter { "configurations:Distribution" }
 filter {}
 
 include "App/App.lua"
+include "Benchmark/Benchmark.lua"
 include "Game/Game.lua"
 include "Library/Library.lua"
+include "LogDecoder/LogDecoder.lua"
 include "Modules/Modules.lua"
 include "Spectra/Spectra.lua"
 include "Test/Test.lua"
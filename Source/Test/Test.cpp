@@ -54,7 +54,13 @@ private:
 
 // Application Entry-Point
 Application *CreateApplication() {
-    return new Test::App({ "Test", "1280x1024" });
+    ApplicationProperties properties { "Test", "1280x1024" };
+
+    // '--benchmark=<frames>' runs the engine tests headless on the software renderer and writes the results into 'Benchmark.json'
+    if (auto frames = Application::GetArguments().GetValue("--benchmark"); !frames.empty()) {
+        std::from_chars(frames.data(), frames.data() + frames.size(), properties.Benchmark.Frames);
+    }
+    return new Test::App(properties);
 }
 
 }
@@ -1,7 +1,12 @@
 ﻿export module Ultra.Test.Core;
 
 import Ultra;
+import Ultra.Core.JobSystem;
 import Ultra.Core.ThreadPool;
+import Ultra.Debug.Benchmark;
+import Ultra.Debug.Memory;
+import Ultra.Debug.Profiler;
+import Ultra.Platform.Renderer.SWRasterizer;
 
 export namespace Ultra::Test {
 
@@ -154,6 +159,31 @@ public:
         logger << LogLevel::Trace << "Hello World! 🦄" << "\n";
         LogTrace("{}: {} {:.2}", "Hello", "World! 🦄", 1.234567f);
         Logger::Test();
+        {
+            // Asynchronous backend: the producers only copy their arguments into the ring
+            constexpr size_t messages = 100'000;
+            auto timer = Timer();
+            for (size_t i = 0; i < messages; i++) logger(LoggerType::Memory, "Message {} of {}\n", i, "Synchronous");
+            auto synchronous = timer.GetDeltaTime();
+
+            logger.EnableAsync(8192, LogOverflowPolicy::Block);
+            timer.GetDeltaTime();
+            for (size_t i = 0; i < messages; i++) logger(LoggerType::Memory, "Message {} of {}\n", i, "Asynchronous");
+            auto asynchronous = timer.GetDeltaTime();
+            logger.DisableAsync();
+            Log("Logger [{} messages]: synchronous {:.3f} ms, asynchronous {:.3f} ms (producer side)", messages, synchronous, asynchronous);
+
+            // Binary channel: only the call site and the raw arguments are written, the text is created offline
+            blog.Open("Test.ulog");
+            timer.GetDeltaTime();
+            for (size_t i = 0; i < messages; i++) blog(LogLevel::Info, "Message {} of {} took {:.3f} ms\n", i, "Binary", 0.125f);
+            blog.Close();
+            auto binary = timer.GetDeltaTime();
+
+            ostringstream text;
+            auto decoded = BinaryLogReader::Decode("Test.ulog", text);
+            Log("BinaryLogger [{} messages]: {:.3f} ms, {} bytes binary vs. {} bytes text", decoded, binary, std::filesystem::file_size("Test.ulog"), text.view().size());
+        }
         LogDelimiter("");
 
         ///
@@ -312,6 +342,149 @@ public:
             });
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(32));
+        LogDelimiter("");
+        // JobSystem
+        Log("JobSystem");
+        LogDelimiter("");
+        {
+            // Throughput: the same amount of tiny tasks through the ThreadPool and the JobSystem
+            constexpr size_t tasks = 100'000;
+            atomic<size_t> counter {};
+            auto timer = Timer();
+
+            {
+                ThreadPool threadPool;
+                vector<future<void>> results;
+                results.reserve(tasks);
+                timer.GetDeltaTime();
+                for (size_t i = 0; i < tasks; i++) {
+                    results.emplace_back(threadPool.Enqueue([&counter] { counter.fetch_add(1, std::memory_order_relaxed); }));
+                }
+                for (auto &result : results) result.wait();
+                auto duration = timer.GetDeltaTime();
+                Log("ThreadPool: {} tasks in {:.3f} ms [{:.0f} tasks/ms]", counter.load(), duration, tasks / duration);
+            }
+
+            counter = 0;
+            {
+                JobSystem jobSystem;
+                timer.GetDeltaTime();
+                auto *root = jobSystem.CreateJob([] {});
+                for (size_t i = 0; i < tasks; i++) {
+                    jobSystem.Run(jobSystem.CreateChildJob(root, [&counter] { counter.fetch_add(1, std::memory_order_relaxed); }));
+                    // Keep the job ring from wrapping around
+                    if (i % (JobSystem::MaxJobCount / 2) == 0) {
+                        jobSystem.Run(root);
+                        jobSystem.Wait(root);
+                        root = jobSystem.CreateJob([] {});
+                    }
+                }
+                jobSystem.Run(root);
+                jobSystem.Wait(root);
+                auto duration = timer.GetDeltaTime();
+                Log("JobSystem:  {} tasks in {:.3f} ms [{:.0f} tasks/ms]", counter.load(), duration, tasks / duration);
+
+                counter = 0;
+                timer.GetDeltaTime();
+                jobSystem.ParallelFor(tasks, [&counter](size_t begin, size_t end) { counter.fetch_add(end - begin, std::memory_order_relaxed); });
+                duration = timer.GetDeltaTime();
+                Log("ParallelFor: {} elements in {:.3f} ms", counter.load(), duration);
+            }
+        }
+        LogDelimiter("");
+        // Future
+        Log("Future");
+        LogDelimiter("");
+        {
+            // Continuations chain without blocking, only the final 'Get' waits
+            auto chain = Async([] { return 20; })
+                .Then([](int value) { return value + 1; })
+                .Then([](int value) { return Async([value] { return value * 2; }); });
+            Log("Future: Async -> Then -> Then = {}", chain.Get());
+
+            vector<Future<int>> loads;
+            for (int i = 0; i < 8; i++) loads.push_back(Async([i] { return i; }));
+            auto all = WhenAll(loads).Get();
+            Log("Future: WhenAll = {} values, WhenAny = {}", all.size(), WhenAny(loads).Get());
+
+            auto cancelled = Async([](const CancellationToken &token) {
+                while (!token.IsCancelled()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+            cancelled.Cancel();
+            try {
+                cancelled.Get();
+            } catch (const FutureCancelled &error) {
+                Log("Future: {}", error.what());
+            }
+        }
+        LogDelimiter("");
+        // Memory
+        Log("Memory");
+        LogDelimiter("");
+        {
+            // Allocations inside the scope are accounted to the tag, no matter which thread frees them
+            Debug::EnableAllocationSites();
+            Debug::NextMemoryFrame();
+            {
+                Debug::MemoryTagScope tag(Debug::MemoryTag::Renderer);
+                vector<Scope<array<float, 16>>> matrices;
+                for (size_t i = 0; i < 1'000; i++) matrices.push_back(CreateScope<array<float, 16>>());
+            }
+            Debug::NextMemoryFrame();
+            auto report = Debug::GetMemoryStatistics();
+            const auto &renderer = report[Debug::MemoryTag::Renderer];
+            Log("Renderer: {} allocations in the last frame, live: {} bytes, peak: {} bytes", renderer.FrameAllocations, renderer.Live, renderer.Peak);
+            for (const auto &site : Debug::GetAllocationSites(3)) {
+                Log("Allocation Site [{}]: {} allocations, {} bytes", site.Address, site.Allocations, site.Bytes);
+            }
+            Debug::EnableAllocationSites(false);
+        }
+        LogDelimiter("");
+        // Allocator
+        Log("Allocator");
+        LogDelimiter("");
+        {
+            // Synthetic steady-state frames: per-frame data lives in the frame arena, temporary data on the scratch stack
+            auto frame = [] {
+                FrameAllocator::Instance().NextFrame();
+                FrameVector<float> vertices(FrameResource());
+                for (size_t i = 0; i < 10'000; i++) vertices.push_back(static_cast<float>(i));
+
+                ScratchScope scratch;
+                std::pmr::string text("Temporary text, which is too long for the small string optimization.", scratch.GetResource());
+                pmr::Dispatcher dispatcher { std::pmr::polymorphic_allocator<>(FrameResource()) };
+                dispatcher.enqueue<int>(static_cast<int>(vertices.size() + text.size()));
+                dispatcher.update();
+            };
+            frame();
+            frame();
+            Debug::NextMemoryFrame();
+            for (size_t i = 0; i < 60; i++) frame();
+            Debug::NextMemoryFrame();
+            Log("Allocator: {} heap allocations in 60 synthetic steady-state frames", Debug::GetMemoryStatistics().Total.FrameAllocations);
+        }
+        LogDelimiter("");
+        // Profiler
+        Log("Profiler");
+        LogDelimiter("");
+        {
+            // Overhead per scope, the events are only copied into the per-thread buffer
+            // The scopes are recorded into the running application session, starting another one would end it
+            constexpr size_t scopes = 100'000;
+            auto ownSession = !Debug::IsProfiling();
+            if (ownSession) Debug::StartProfiling("Test", "Test.json");
+            auto timer = Timer();
+            for (size_t i = 0; i < scopes; i++) {
+                auto scope = Debug::ProfileScope("Scope");
+            }
+            auto duration = timer.GetDeltaTimeAs(TimerUnit::Nanoseconds);
+            if (ownSession) {
+                Debug::StopProfiling();
+                Log("Profiler [{} scopes]: {:.1f} ns/scope, {} bytes capture vs. {} bytes json", scopes, duration / scopes, std::filesystem::file_size("Test.uprf"), std::filesystem::file_size("Test.json"));
+            } else {
+                Log("Profiler [{} scopes]: {:.1f} ns/scope", scopes, duration / scopes);
+            }
+        }
         LogDelimiter("");
          // Timer
         {
@@ -326,6 +499,74 @@ public:
             Log("Duration(s):  {}", timer.GetDeltaTimeAs(TimerUnit::Seconds));
             LogDelimiter("");
         }
+        // Benchmark
+        {
+            Log("Benchmark");
+            LogDelimiter("");
+            Debug::FrameBenchmark benchmark("Test", 100, 10);
+            while (!benchmark.IsFinished()) {
+                benchmark.BeginFrame();
+                ScratchScope scratch;
+                auto values = String::Split("a,b,c,d", ',', scratch.GetResource());
+                benchmark.EndFrame();
+            }
+            auto statistics = benchmark.GetStatistics();
+            Log("Benchmark [{} frames]: p50 {:.4f}ms | p99 {:.4f}ms | mad {:.4f}ms", statistics.Samples, statistics.Median, statistics.P99, statistics.MAD);
+            benchmark.Save("Benchmark.json");
+            LogDelimiter("");
+        }
+        // FrameLimiter
+        {
+            Log("FrameLimiter");
+            LogDelimiter("");
+            FrameLimiter limiter(120);
+            Timer timer {};
+            float waited {};
+            for (size_t i = 0; i < 60; i++) waited += limiter.Wait();
+            Log("60 frames at 120 fps: {:.3f}ms (slept {:.3f}ms)", timer.GetDeltaTime(), waited);
+            LogDelimiter("");
+        }
+        // Software Rasterizer
+        {
+            Log("Software Rasterizer");
+            LogDelimiter("");
+            struct Vertex { glm::vec3 Position; glm::vec4 Color; };
+            array<Vertex, 4> vertices {{
+                { { -1.0f,  1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+                { {  1.0f,  1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+                { {  1.0f, -1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+                { { -1.0f, -1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+            }};
+            array<uint32_t, 6> indices { 0, 1, 2, 2, 3, 0 };
+            PipelineProperties properties {};
+            properties.Layout = {
+                { ShaderDataType::Float3, "aPosition" },
+                { ShaderDataType::Float4, "aColor" },
+            };
+            auto format = SWVertexFormat::Create(properties.Layout);
+
+            // Shared edges must neither leave gaps nor cover a pixel twice
+            SWTarget target {};
+            target.Resize(256, 256);
+            auto &rasterizer = SWRasterizer::Instance();
+            rasterizer.BindTarget(&target);
+            rasterizer.BindPipeline(&properties, &format);
+            rasterizer.BindProgram({});
+            rasterizer.BindVertexBuffer(reinterpret_cast<const byte *>(vertices.data()), sizeof(vertices));
+            rasterizer.BindIndexBuffer(indices.data(), sizeof(indices));
+            rasterizer.Clear({ 0.0f, 0.0f, 0.0f, 1.0f });
+            auto timer = Timer();
+            rasterizer.DrawIndexed(PrimitiveType::Triangle, indices.size());
+            rasterizer.Flush();
+            auto duration = timer.GetDeltaTimeAs(TimerUnit::Milliseconds);
+            auto covered = std::ranges::count(target.Color->Texels, 0xff0000ffu);
+            Log("Software Rasterizer: {} of {} pixels covered in {:.3f}ms", covered, target.Color->Texels.size(), duration);
+            rasterizer.BindPipeline(nullptr, nullptr);
+            rasterizer.BindTarget(nullptr);
+            rasterizer.ReleaseBindings(vertices.data());
+            rasterizer.ReleaseBindings(indices.data());
+            LogDelimiter("");
+        }
     }
 
     //virtual void OnKeyboardEvent(KeyboardEventData &data, const EventListener::EventEmitter &emitter) override {
@@ -19,6 +19,7 @@ export module Ultra.Test.Engine;
 import Ultra;
 import Ultra.Asset;
 import Ultra.Asset.Model;
+import Ultra.Debug.Memory;
 import Ultra.Math;
 import Ultra.Renderer.Buffer;
 import Ultra.Renderer.DesignerCamera;
@@ -271,6 +272,7 @@ public:
     ~Engine() = default;
 
     void Test(Timestamp deltaTime) {
+        LogFrameStatistics();
         mRenderer->RenderFrame();
 
         // Update Camera
@@ -297,6 +299,7 @@ public:
         // Sprite Renderer (2D)
         #if TEST_SPRITE_RENDERER == 1
             TestSpriteRenderer(deltaTime);
+            TestSpriteBatching();
         #endif
     
         // UI Renderer (2D)
@@ -322,6 +325,24 @@ public:
         ImGui::End();
     }
 
+    // The application counts the heap allocations between two steps, so this reports the whole last frame (after the warmup)
+    void LogFrameStatistics() {
+        static constexpr size_t WarmupFrames = 300;
+        static constexpr size_t ReportInterval = 600;
+        if (++mFrameCounter < WarmupFrames || (mFrameCounter - WarmupFrames) % ReportInterval) return;
+
+        auto memory = Debug::GetMemoryStatistics();
+        Log("Frame [{}]: {} heap allocations, live: {} bytes, peak: {} bytes", mFrameCounter - 1, memory.Total.FrameAllocations, memory.Total.Live, memory.Total.Peak);
+
+        // The pipeline cache counts since the start, shared pipelines show up as hits
+        auto pipelines = PipelineState::GetCacheStatistics();
+        Log("Frame [{}]: {} pipelines, cache hits: {}, misses: {} ({:.1f}%)", mFrameCounter - 1, pipelines.Pipelines, pipelines.Hits, pipelines.Misses, pipelines.GetHitRate() * 100.0f);
+
+        // The renderer resets the device counters in 'RenderFrame', so they still hold the last frame here
+        const auto &renderer = RenderDevice::GetStatistics();
+        Log("Frame [{}]: {} state calls issued, {} redundant calls skipped", mFrameCounter - 1, renderer.IssuedStateCalls, renderer.SkippedStateCalls);
+    }
+
     #pragma region Mesh Renderer
 
     void TestMeshRenderer(Timestamp deltaTime) {
@@ -550,7 +571,7 @@ public:
         mEntityUniformBuffer->UpdateData(&entityData, sizeof(Components::EntityData));
         mEntityUniformBuffer->Bind((size_t)UniformPosition::EntityData);
 
-        model.Draw(mCommandBuffer);
+        model.Draw(mCommandBuffer, mCamera.ViewProjection, entityData.Transform);
 
         // Visualize Normals
         //mNormalsShader->Bind();
@@ -612,6 +633,34 @@ public:
         Renderer2D::FinishScene();
     }
 
+    // Interleaved opaque quads and lines are grouped by state, the translucent circles follow back-to-front, so three batches are expected
+    void TestSpriteBatching() {
+        static constexpr size_t Count = 1000;
+        static constexpr uint32_t ExpectedDrawCalls = 3;
+
+        auto before = Renderer2D::GetStatistics();
+        Renderer2D::StartScene(mDesignerCamera);
+        for (size_t i = 0; i < Count; i++) {
+            auto x = -0.9f + 1.8f * static_cast<float>(i % 40) / 40.0f;
+            auto y = -0.9f + 1.8f * static_cast<float>(i / 40) / 25.0f;
+            auto z = -0.01f * static_cast<float>(i % 7);
+            Renderer2D::DrawQuad({ x, y, z }, { 0.03f, 0.03f }, { 0.2f, 0.6f, 0.2f, 1.0f });
+            Renderer2D::DrawCircle({ x, y, z }, { 0.02f, 0.02f }, { 1.0f, 1.0f, 1.0f, 0.5f });
+            Renderer2D::DrawLine({ x, y, z }, { x + 0.03f, y, z }, { 0.9f, 0.9f, 0.9f, 1.0f });
+        }
+        Renderer2D::FinishScene();
+        auto after = Renderer2D::GetStatistics();
+
+        auto drawCalls = after.DrawCalls - before.DrawCalls;
+        auto stateChanges = after.StateChanges - before.StateChanges;
+        auto batchBreaks = after.BatchBreaks - before.BatchBreaks;
+        if (drawCalls != ExpectedDrawCalls) {
+            LogWarning("Sprite Batching: {} interleaved draws needed {} draw calls instead of {} ({} state changes, {} batch breaks)!", Count * 3, drawCalls, ExpectedDrawCalls, stateChanges, batchBreaks);
+            return;
+        }
+        Log("Sprite Batching: {} interleaved draws in {} draw calls ({} state changes, {} batch breaks)", Count * 3, drawCalls, stateChanges, batchBreaks);
+    }
+
     #pragma endregion
 
     #pragma region UI Renderer
@@ -649,6 +698,7 @@ public:
 private:
     // Properties
     bool mUIActive = false;
+    size_t mFrameCounter {};
 
     // Objects
     Scope<Renderer> mRenderer;